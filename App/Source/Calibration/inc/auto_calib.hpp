@@ -47,8 +47,8 @@ static viewStates view_state = fisheye_view;
 
 static int tmpl_width;
 static int tmpl_height;
-static int contours_buf;
-static int grid_buf;
+static int contours_buf = -1;
+static int grid_buf = -1;
 
 
 static XMLParameters param;			// Cameras parameters
@@ -56,7 +56,15 @@ static MyDisplay* disp;				// Display
 static View* view;						// View object
 static vector<camera_view> cam_views;	// View indexes
 static vector<Camera*> cameras;		// Cameras
-static vector<CurvilinearGrid*> grids;	// Grids
+static CalibPipeline* pipeline = NULL;	// Grids, masks and output files
+
+// Calibration artefacts. Every artefact is rebuilt only if its key has been changed.
+static vector<artefact> luts;			// Defisheye LUTs
+static vector<artefact> extrinsics;		// Contours and intrinsic/extrinsic camera parameters
+static vector<artefact> mesh_uploads;	// Defisheye meshes uploaded to GPU
+static artefact contours_upload;		// Contours buffer uploaded to GPU
+static artefact grid_upload;			// Grids buffer uploaded to GPU
+static artefact result_upload;			// Split grids uploaded to GPU
 gst_data gst_shared;					//GStreamer
 
 /*******************************************************************************************
@@ -69,6 +77,8 @@ static void updateState(viewStates new_state);
 static int searchContours(uint index);
 static int getContours(float** gl_lines);
 static int getGrids(float** gl_grid);
-static void saveGrids(void);
+static void updateLUTs(void);
+static void updateExtrinsics(bool force);
+static void uploadArtefacts(viewStates state);
 
 #endif /* AUTO_CALIB_HPP_ */
@@ -0,0 +1,97 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef BATCH_CALIB_HPP_
+#define BATCH_CALIB_HPP_
+
+/*******************************************************************************************
+ * Includes
+ *******************************************************************************************/
+#include <fstream>
+#include <iomanip>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/resource.h>
+
+// String
+#include <string>
+
+//OpenCV
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgcodecs/legacy/constants_c.h>
+
+//XML settings
+#include "settings.hpp"
+
+//Camera
+#include "camera.hpp"
+
+//Grid
+#include "grid.hpp"
+
+//Masks
+#include "masks.hpp"
+
+//Exposure correction
+#include "exposure_compensator.hpp"
+
+//Grids, masks and output files
+#include "calib_pipeline.hpp"
+
+//Macros
+#include "macros.hpp"
+
+/**********************************************************************************************************************
+ * Types
+ **********************************************************************************************************************/
+struct stage_report			/* Report of one calibration stage */
+{
+	string name;			/* Stage name */
+	int camera;				/* Camera index or -1 if the stage is common for all cameras */
+	double time;			/* Stage time in ms */
+	long rss;				/* Resident memory after the stage in kB */
+	long rss_diff;			/* Resident memory change in kB */
+	int status;				/* Stage return value (0 - success, -1 - error) */
+};
+
+/*******************************************************************************************
+ * Global variables
+ *******************************************************************************************/
+static XMLParameters param;				// Cameras parameters
+static vector<Camera*> cameras;			// Cameras
+static vector<Mat> frames;				// Calibration frames
+static vector<stage_report> report;		// Time and memory report
+
+/*******************************************************************************************
+ * Global functions
+ *******************************************************************************************/
+static long getMemory(void);
+static int runStage(string name, int camera, function<int(void)> stage);
+static void printReport(void);
+static void objectsFree(void);
+
+#endif /* BATCH_CALIB_HPP_ */
@@ -0,0 +1,193 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SRC_CALIB_PIPELINE_HPP_
+#define SRC_CALIB_PIPELINE_HPP_
+
+/*******************************************************************************************
+ * Includes
+ *******************************************************************************************/
+#include <functional>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "settings.hpp"
+#include "camera.hpp"
+#include "grid.hpp"
+#include "masks.hpp"
+#include "exposure_compensator.hpp"
+
+using namespace cv;
+using namespace std;
+
+/*******************************************************************************************
+ * Types
+ *******************************************************************************************/
+struct artefact				/* Calibration artefact */
+{
+	vector<double> key;		/* Parameters and versions of input artefacts which the artefact has been built from */
+	uint version;			/* The version is incremented every time when the artefact is rebuilt */
+	bool valid;				/* The last build was successful */
+};
+
+/* Calibration stage runner: it runs the stage and returns its status (0 - success, -1 - error) */
+typedef function<int(string name, int camera, function<int(void)> stage)> StageRunner;
+
+/*******************************************************************************************
+ * Functions
+ *******************************************************************************************/
+/**************************************************************************************************************
+ *
+ * @brief  			Check if the artefact must be rebuilt
+ *
+ * @param  in 		const artefact &a - artefact
+ * 		   in		const vector<double> &key - current parameters and versions of the artefact inputs
+ *
+ * @return 			The function returns true if the last build has failed or the key has been changed.
+ *
+ **************************************************************************************************************/
+extern bool isOutdated(const artefact &a, const vector<double> &key);
+
+/**************************************************************************************************************
+ *
+ * @brief  			Store the result of the artefact build
+ *
+ * @param  out 		artefact &a - artefact
+ * 		   in		const vector<double> &key - parameters and versions of the artefact inputs
+ * 		   in		bool valid - the build has been successful
+ *
+ * @return 			-
+ *
+ * @remarks 		The function increments the artefact version.
+ *
+ **************************************************************************************************************/
+extern void setArtefact(artefact &a, const vector<double> &key, bool valid);
+
+/*******************************************************************************************
+ * Classes
+ *******************************************************************************************/
+/* CalibPipeline class - grids, masks and output files which are calculated from the camera poses. It is shared by
+ * the interactive (auto_calib) and the headless (batch_calib) calibration. */
+class CalibPipeline {
+	public:
+		/**************************************************************************************************************
+		 *
+		 * @brief  			CalibPipeline class constructor.
+		 *
+		 * @param  in 		uint camera_num - number of cameras
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		All artefacts are outdated, so the first calls of updateGrids and saveGrids build everything.
+		 *
+		 **************************************************************************************************************/
+		CalibPipeline(uint camera_num);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Set calibration stage runner
+		 *
+		 * @param  in 		StageRunner stage_runner - function which runs every stage which is rebuilt
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		The runner can measure stages time and memory. By default stages are called directly.
+		 *
+		 **************************************************************************************************************/
+		void setRunner(StageRunner stage_runner) { runner = stage_runner; }
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Calculate bowl heights and grids
+		 *
+		 * @param  in 		XMLParameters &param - settings
+		 * 		   in		vector<Camera*> &cameras - cameras with intrinsic and extrinsic parameters
+		 * 		   in		const vector<artefact> &extrinsics - artefacts of camera poses (one per camera)
+		 *
+		 * @return 			The function returns 0 if all rebuilt stages have been successful. Otherwise -1 is returned.
+		 *
+		 * @remarks 		Only the grids which keys have been changed are recalculated. A grid is valid if the camera
+		 * 					pose is valid and the grid has all seam points.
+		 *
+		 **************************************************************************************************************/
+		int updateGrids(XMLParameters &param, vector<Camera*> &cameras, const vector<artefact> &extrinsics);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Calculate meshes, masks, split grids and save output files
+		 *
+		 * @param  in 		XMLParameters &param - settings
+		 * 		   in		vector<Camera*> &cameras - cameras with intrinsic and extrinsic parameters
+		 *
+		 * @return 			The function returns 0 if all rebuilt stages have been successful. Otherwise -1 is returned.
+		 *
+		 * @remarks 		The function must be called after updateGrids. Only the artefacts which keys have been
+		 * 					changed are recalculated: grid meshes, blending masks, split grids, exposure correction
+		 * 					grids (./compensator), bird's-eye grid (./top_grid), grid files (./arrayX, ./arrayX1,
+		 * 					./arrayX2, ./arrayX3) and levels of detail (./lodN). Files of disabled options are removed,
+		 * 					so the renderer does not pick up outdated data.
+		 *
+		 **************************************************************************************************************/
+		int saveGrids(XMLParameters &param, vector<Camera*> &cameras);
+
+		CurvilinearGrid* getGrid(uint index) { return (&grids[index]); }				/* Get grid of the camera */
+		Masks& getMasks(void) { return (masks); }										/* Get blending masks and split grids */
+		uint getGridVersion(uint index) { return (grid_states[index].version); }		/* Get version of the camera grid */
+		uint getSplitVersion(void) { return (split_state.version); }					/* Get version of split grids */
+
+	private:
+		StageRunner runner;					/* Stage runner (stages are called directly if it is not set) */
+		vector<CurvilinearGrid> grids;		/* Grids */
+		vector< vector<float> > meshes;		/* Grid triangles of each camera (vx vy vz tx ty) */
+		Masks masks;						/* Blending masks */
+		vector<int> bowl_heights;			/* Maximum number of grid rows in z axis for each camera */
+
+		// Every artefact is rebuilt only if its key has been changed
+		vector<artefact> heights;			/* Bowl heights */
+		vector<artefact> grid_states;		/* Grids and seam points */
+		vector<artefact> grid_meshes;		/* Grid triangles */
+		vector<artefact> grid_files;		/* Saved grids (./arrayX, ./arrayX1, ./arrayX2, ./arrayX3) */
+		artefact masks_state;				/* Blending masks */
+		artefact split_state;				/* Split grids */
+		artefact compensator_state;			/* Exposure correction grids (./compensator) */
+		artefact top_state;					/* Bird's-eye grid (./top_grid) */
+		artefact lod_state;					/* Coarser levels of detail of the grids (./lodN/arrayX1, ./lodN/arrayX2, ./lodN/arrayX3) */
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Run calibration stage
+		 *
+		 * @param  in 		string name - stage name
+		 * 		   in		int camera - camera index or -1 if the stage is common for all cameras
+		 * 		   in		function<int(void)> stage - stage
+		 *
+		 * @return 			The function returns the stage status (0 - success, -1 - error).
+		 *
+		 **************************************************************************************************************/
+		int runStage(string name, int camera, function<int(void)> stage);
+};
+
+#endif /* SRC_CALIB_PIPELINE_HPP_ */
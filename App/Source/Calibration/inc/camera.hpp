@@ -39,6 +39,7 @@
 
 #include "defisheye.hpp"
 #include "src_contours.hpp"
+#include "macros.hpp"
 
 using namespace cv;
 using namespace std;
@@ -58,6 +59,9 @@ struct CameraParameters { 		/* Intrinsic and extrinsic camera parameters */
 	Mat distCoeffs; 			/* Distortion coefficients */
 	Mat rvec;					/* Rotation vector */
 	Mat tvec;					/* Translation vector */
+	Matx33d R;					/* Rotation matrix (cached Rodrigues(rvec)) */
+	Matx33d KR;					/* Cached K * R projection matrix */
+	Vec3d Kt;					/* Cached K * tvec projection vector */
 };
 
 /*******************************************************************************************
@@ -68,15 +72,74 @@ class Camera {
 	public:
 		Mat xmap, ymap;			/* X and Y maps for removing fisheye distortion */
     	int index;				/* Camera index */
+    	float yaw;				/* Camera yaw in the cameras ring (degrees) */
+    	int previous;			/* Index of the previous camera in the ring */
+    	int next;				/* Index of the next camera in the ring */
+    	Point2f tile;			/* Top left corner of the camera debug tile (normalized device coordinates) */
+    	float tile_size;		/* Debug tile size (normalized device coordinates) */
     	Defisheye model;		/* Polynomial camera model */
     	float sf;				/* Scale factor */
     	Size poster;			/* The calibrating poster size */
     	CameraTemplate tmp;		/* Template parameters */
 
-    	Mat getK(void) {Mat M; param.K.copyTo(M); return M;} // Get camera matrix
-    	Mat getDistCoeffs(void) {Mat M; param.distCoeffs.copyTo(M); return M;} // Get distortion coefficients
-    	Mat getRvec(void) {Mat M; param.rvec.copyTo(M); return M;} // Get rotation vector
-    	Mat getTvec(void) {Mat M; param.tvec.copyTo(M); return M;} // Get translation vector
+    	const Mat& getK(void) const {return param.K;} // Get camera matrix
+    	const Mat& getDistCoeffs(void) const {return param.distCoeffs;} // Get distortion coefficients
+    	const Mat& getRvec(void) const {return param.rvec;} // Get rotation vector
+    	const Mat& getTvec(void) const {return param.tvec;} // Get translation vector
+    	const Matx33d& getR(void) const {return param.R;} // Get rotation matrix
+
+    	/**********************************************************************************************************
+    	 *
+    	 * @brief  		Project 3D template point into the defisheye image plane.
+    	 *
+    	 * @param  in 	const Point3f &p - 3D point in template coordinates
+    	 *
+    	 * @return 		The function returns 2D image point.
+    	 *
+    	 * @remarks 	The function is a fast equivalent of projectPoints for a single point. It uses the cached
+    	 * 				K * R matrix and K * tvec vector, which are updated by setIntrinsic and setExtrinsic.
+    	 * 				Distortion coefficients are not applied because they are zero after defisheye transformation.
+    	 *
+    	 **********************************************************************************************************/
+    	inline Point2f project(const Point3f &p) const {
+    		const Matx33d &M = param.KR;
+    		double x = M(0, 0) * (double)p.x + M(0, 1) * (double)p.y + M(0, 2) * (double)p.z + param.Kt[0];
+    		double y = M(1, 0) * (double)p.x + M(1, 1) * (double)p.y + M(1, 2) * (double)p.z + param.Kt[1];
+    		double z = M(2, 0) * (double)p.x + M(2, 1) * (double)p.y + M(2, 2) * (double)p.z + param.Kt[2];
+    		z = (z != 0.0) ? 1.0 / z : 1.0;
+    		return(Point2f((float)(x * z), (float)(y * z)));
+    	}
+
+    	/**********************************************************************************************************
+    	 *
+    	 * @brief  		Rotate grid point into the ring coordinates.
+    	 *
+    	 * @param  in 	const Point3f &p - grid point (seam point) in camera template coordinates
+    	 *
+    	 * @return 		The function returns x and y coordinates of the point rotated counterclockwise by camera yaw.
+    	 *
+    	 **********************************************************************************************************/
+    	inline Point2f ringPoint(const Point3f &p) const {
+    		double angle = (double)yaw * CV_PI / 180.0;
+    		double c = cos(angle);
+    		double s = sin(angle);
+    		return(Point2f((float)((double)p.x * c - (double)p.y * s), (float)((double)p.x * s + (double)p.y * c)));
+    	}
+
+    	/**********************************************************************************************************
+    	 *
+    	 * @brief  		Project vector of 3D template points into the defisheye image plane.
+    	 *
+    	 * @param  in 	const vector<Point3f> &p3d - 3D points in template coordinates
+    	 * 		   out	vector<Point2f> &p2d - 2D image points
+    	 *
+    	 * @return 		-
+    	 *
+    	 **********************************************************************************************************/
+    	void project(const vector<Point3f> &p3d, vector<Point2f> &p2d) const {
+    		p2d.resize(p3d.size());
+    		for (size_t i = 0; i < p3d.size(); i++) { p2d[i] = project(p3d[i]); }
+    	}
 
 	/**************************************************************************************************************
 	 *
@@ -90,6 +153,24 @@ class Camera {
 	 *
 	 **************************************************************************************************************/
 	void updateLUT(float scale_factor);	
+
+	/**************************************************************************************************************
+	 *
+	 * @brief  			Set camera placement in the cameras ring.
+	 *
+	 * @param  in 		float yaw_angle - camera yaw (degrees)
+	 * 		   in		int previous_camera - index of the previous camera in the ring
+	 * 		   in		int next_camera - index of the next camera in the ring
+	 * 		   in		int num - number of cameras
+	 *
+	 * @return 			-
+	 *
+	 * @remarks 		The function sets camera yaw which is used to rotate the camera grid, ring neighbors which
+	 * 					share seams with the camera and the debug tile where the camera image is drawn. Tiles are
+	 * 					arranged in ceil(sqrt(num)) columns.
+	 *
+	 **************************************************************************************************************/
+	void setPlacement(float yaw_angle, int previous_camera, int next_camera, int num);
 		
 	/**************************************************************************************************************
 	 *
@@ -244,6 +325,22 @@ class Camera {
 		double radius;			/* Base radius - the distance between template center and farthest point from the center */
 		vector<Point2f> img_p;
     	CameraParameters param;	/* Camera parameters */
+    	ContourBuffers contour_buf;	/* Scratch buffers of the contour search */
+
+    	/**************************************************************************************************************
+    	 *
+    	 * @brief  			Update cached projection parameters.
+    	 *
+    	 * @param  			-
+    	 *
+    	 * @return 			-
+    	 *
+    	 * @remarks			The function recalculates rotation matrix R, K * R and K * tvec from param.K, param.rvec
+    	 * 					and param.tvec. It must be called every time when camera parameters have been changed.
+    	 *
+    	 **************************************************************************************************************/
+    	void updateProjection(void);
+
     	/**************************************************************************************************************
     	 *
     	 * @brief  			Search pattern points in captured image from the camera.
@@ -275,17 +372,22 @@ class Creator {
 	 * @param  in 		char *filename - *.txt file with polynomial camera model from Scaramuzza toolbox for Matlab
 	 * 		   in		float sf - scale factor
 	 * 		   in 	 	int index - camera index
+	 * 		   in		float yaw - camera yaw (degrees)
+	 * 		   in		int previous_camera - index of the previous camera in the ring
+	 * 		   in		int next_camera - index of the next camera in the ring
+	 * 		   in		int num - number of cameras
 	 *
 	 * @return 			Functions returns Camera* object if the camera model has been loaded successfully. A return
 	 * 					value of NULL indicates an error.
-	 * 					The public properties of Camera object are set: sf, index.
+	 * 					The public properties of Camera object are set: sf, index and the placement in the cameras
+	 * 					ring (see setPlacement).
 	 * 					The roi value is set on default value - 50%.
 	 *
 	 * @remarks 		The class creator reads polynomial camera model from filename file. If any problems were
 	 * 					to occur then creator return NULL. Otherwise it returns the pointer to Camera object.
 	 *
 	 **************************************************************************************************************/
-		static Camera* create(const char *filename, float sf, int index); /* Create Camera object */
+		static Camera* create(const char *filename, float sf, int index, float yaw, int previous_camera, int next_camera, int num); /* Create Camera object */
 };
 
 #endif /* SRC_CAMERA_HPP_ */
@@ -70,13 +70,15 @@
 //Exposure correction
 #include "exposure_compensator.hpp"
 
+//Grids, masks and output files
+#include "calib_pipeline.hpp"
+
 //EGL
 #include "display.hpp"
 
 /*******************************************************************************************
  * Macros
  *******************************************************************************************/
-#define CAMERA_NUM  4
 
 /* GL_VIV_direct_texture */
 #ifndef GL_VIV_direct_texture
@@ -35,12 +35,19 @@
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <math.h>
+#include <float.h>
 #include <sys/stat.h>
 #include <opencv2/highgui/highgui.hpp>
 
 using namespace std;
 using namespace cv;
 
+/*******************************************************************************************
+ * Macros
+ *******************************************************************************************/
+#define LENS_BLOCK 256		/* Number of points evaluated together by the bulk lens model functions */
+
 /*******************************************************************************************
  * Types
  *******************************************************************************************/
@@ -67,6 +74,44 @@ public:
 	
 	
 	void cam2world(Point3d* p3d, Point2d p2d);
+
+	/**************************************************************************************************************
+	 *
+	 * @brief  			Back-project fisheye pixels to unit rays (bulk forward model).
+	 *
+	 * @param  in		const Point2f* p2d - fisheye pixels (x - row, y - column as in cam2world)
+	 * 		   out		Point3f* p3d - unit rays in camera coordinates
+	 * 		   in		int num - number of points
+	 *
+	 * @return 			-
+	 *
+	 * @remarks 		The function is a float equivalent of cam2world for a span of points. Points are processed in
+	 * 					blocks of LENS_BLOCK. The polynomial is evaluated in Horner form with the coefficient loop outside
+	 * 					of the point loop, so the point loop has no loop-carried dependency and is vectorized.
+	 *
+	 **************************************************************************************************************/
+	void cam2world(const Point2f* p2d, Point3f* p3d, int num) const;
+	void cam2world(const vector<Point2f> &p2d, vector<Point3f> &p3d) const { p3d.resize(p2d.size());
+																			   cam2world(p2d.data(), p3d.data(), (int)p2d.size()); }
+
+	/**************************************************************************************************************
+	 *
+	 * @brief  			Project camera coordinates to fisheye pixels (bulk inverse model).
+	 *
+	 * @param  in		const Point3f* p3d - points in camera coordinates (z < 0 in front of the camera)
+	 * 		   out		Point2f* p2d - fisheye pixels (x - row, y - column as in cam2world)
+	 * 		   in		int num - number of points
+	 *
+	 * @return 			-
+	 *
+	 * @remarks 		The function evaluates the inverse polynomial r(t), t = atan(z / sqrt(x^2 + y^2)), in Horner form
+	 * 					for blocks of LENS_BLOCK points and applies the affine transformation. Points on the optical axis
+	 * 					are projected to the image center.
+	 *
+	 **************************************************************************************************************/
+	void world2cam(const Point3f* p3d, Point2f* p2d, int num) const;
+	void world2cam(const vector<Point3f> &p3d, vector<Point2f> &p2d) const { p2d.resize(p3d.size());
+																			   world2cam(p3d.data(), p2d.data(), (int)p3d.size()); }
 	
 private:
 
@@ -33,6 +33,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <fstream>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
@@ -60,6 +61,8 @@ struct CameraInfo {
 	int width;
 	int height;
 	int index;
+	Point2f tile;		/* Top left corner of the debug tile */
+	float tile_size;	/* Debug tile size */
 };
 
 /*******************************************************************************************
@@ -67,21 +70,73 @@ struct CameraInfo {
  *******************************************************************************************/
 /**************************************************************************************************************
  *
- * @brief  			Rotate point according to the camera index
+ * @brief  			Rotate point according to the camera yaw
  *
- * @param  in		index - camera index
+ * @param  in		float yaw - camera yaw (degrees)
  * 		   in		Point3f point - grid point
  *
  * @return 			Point3f point - grid point after rotation
  *
- * @remarks 		The function rotate grid point according to the camera index value:
- * 						index = 0 - without rotation;
- * 						index = 1 - 90 degree clockwise rotation;
- * 						index = 2 - 180 degree clockwise rotation;
- * 						index = 3 - 270 degree clockwise rotation;
+ * @remarks 		The function rotate grid point clockwise by yaw degrees around the bowl axis and converts it
+ * 					into the render coordinates (y and z axes are flipped). Yaw 0, 90, 180 and 270 degrees
+ * 					correspond to the cameras of the default 4 cameras ring.
  *
  **************************************************************************************************************/
-extern Point3f rotatePoint(int index, Point3f point);
+extern Point3f rotatePoint(float yaw, Point3f point);
+
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate fisheye texels of 2D grid points
+ *
+ * @param  in		const Mat &xmap - X map of the defisheye transformation (CV_32FC1)
+ * 		   in		const Mat &ymap - Y map of the defisheye transformation (CV_32FC1)
+ * 		   in		const vector<Point2f> &p2d - 2D grid points (defisheye image points)
+ * 		   out		vector<Point2f> &texels - normalized fisheye texels of the grid points
+ *
+ * @return 			-
+ *
+ * @remarks 		The function bilinearly samples xmap and ymap once for every grid point and normalizes the
+ * 					result by the map size. Neighbor indexes are clamped to the map border. Points which lie
+ * 					outside the map get the (-1, -1) texel. Points are processed in parallel.
+ *
+ **************************************************************************************************************/
+extern void getTexels(const Mat &xmap, const Mat &ymap, const vector<Point2f> &p2d, vector<Point2f> &texels);
+
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate fisheye texels of 2D grid points analytically
+ *
+ * @param  in		const Defisheye &model - polynomial camera model
+ * 		   in		float sf - scale factor of the defisheye image
+ * 		   in		const vector<Point2f> &p2d - 2D grid points (defisheye image points)
+ * 		   out		vector<Point2f> &texels - normalized fisheye texels of the grid points
+ *
+ * @return 			-
+ *
+ * @remarks 		Every defisheye image point is lifted to the plane z = -width / sf of the camera frame, as in
+ * 					Defisheye::createLUT, and projected with the inverse polynomial model (Defisheye::world2cam).
+ * 					The result does not depend on xmap/ymap resolution, so texel precision is independent of sf.
+ * 					Points which lie outside the defisheye image get the (-1, -1) texel as in the xmap/ymap version.
+ * 					Points are processed in parallel.
+ *
+ **************************************************************************************************************/
+extern void getTexels(const Defisheye &model, float sf, const vector<Point2f> &p2d, vector<Point2f> &texels);
+
+/**************************************************************************************************************
+ *
+ * @brief  			Save triangles to a file.
+ *
+ * @param  in		const char* file_name - output file name
+ * 		   in		const vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex
+ * 		   in		uint stride - number of floats per vertex. Vertices of weighted overlap grids have the 6th
+ * 		   			float which is the blend weight.
+ *
+ * @return 			Functions returns 0 if the file has been saved. A return value of -1 indicates an error.
+ *
+ * @remarks 		The function writes one vertex per line in the text format of the arrayX files.
+ *
+ **************************************************************************************************************/
+extern int saveMesh(const char* file_name, const vector<float> &mesh, uint stride = 5);
 
 /*******************************************************************************************
  * Classes
@@ -153,27 +208,45 @@ class CurvilinearGrid {
 	
 			/**************************************************************************************************************
 		 *
-		 * @brief  			Generate triangles from a 3D grid and save them to a file.
+		 * @brief  			Generate triangles from a 3D grid.
+		 *
+		 * @param  in		Camera* camera - pointer to the Camera object
+		 * 		   out		vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex, 3 vertices per triangle
+ * 		   in		bool analytic - if true then texels are calculated with the polynomial camera model (see getTexels)
+ * 		   			instead of sampling xmap/ymap
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		Vertices are 3D template points and texels are normalized fisheye coordinates.
+		 * 					The grid has been rotated clockwise by the camera yaw (see rotatePoint).
+		 *
+		 **************************************************************************************************************/
+	void createMesh(Camera* camera, vector<float> &mesh, bool analytic = false);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Generate triangles of a coarser level of detail from a 3D grid.
 		 *
 		 * @param  in		Camera* camera - pointer to the Camera object
+		 * 		   in		uint level - level of detail. Level 0 is the grid of createMesh.
+		 * 		   out		vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex, 3 vertices per triangle
 		 *
 		 * @return 			-
 		 *
-		 * @remarks 		The file with triangles description has been saved to the file arrayX, where X is camera index.
-		 * 					The grid has been rotated according to the camera index value:
-		 * 						index = 0 - without rotation;
-		 * 						index = 1 - 90 degree clockwise rotation;
-		 * 						index = 2 - 180 degree clockwise rotation;
-		 * 						index = 3 - 270 degree clockwise rotation;
+		 * @remarks 		The function must be called after createMesh, which calculates the grid texels.
+		 * 					Every 2^level neighbor sectors are merged into one sector and every 2^level-th grid row
+		 * 					is kept. The last row of the flat bottom and the last row of the bowl side are always kept,
+		 * 					so the bowl keeps its outline. Triangles are written in the sectors order as in createMesh.
 		 *
 		 **************************************************************************************************************/
-	void saveGrid(Camera* camera);
+	void createLodMesh(Camera* camera, uint level, vector<float> &mesh);
 	private:
 		CameraInfo cam_info;
 	
 		int NoP;				// Number of grid points for one grid sector (angle)
 		vector<Point3f> p3d;	// 3D grid points (template points)
 		vector<Point2f> p2d;	// 2D grid points (image points)
+		vector<Point2f> p2t;	// Normalized fisheye texels of the 2D grid points
 		GridParam parameters;	// Parameters of grid
 		vector<Point3f> seam;	// Seam points
 
@@ -220,7 +293,22 @@ class CurvilinearGrid {
 		 **************************************************************************************************************/
 		void findSeam(Camera* camera, vector<Point3f> &seam_points);
 
-
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Generate triangles of a grid quad.
+		 *
+		 * @param  in		Camera* camera - pointer to the Camera object
+		 * 		   in		const int* p - indexes of 4 grid points: end and start sector points of the first row and
+		 * 		   			end and start sector points of the next row
+		 * 		   out		vector<float> &buf - buffer the triangles are appended to (vx vy vz tx ty)
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		The quad is divided into 2 triangles (p0 - p1 - p2) and (p1 - p3 - p2). Triangle is skipped if
+		 * 					one of its points is not defined on the camera frame.
+		 *
+		 **************************************************************************************************************/
+		void addQuad(Camera* camera, const int* p, vector<float> &buf);
 };
 
 /*  RectilinearGrid class - the grid is sparse at the middle of bowl bottom and more denser at the bowl bottom edge.
@@ -293,21 +381,20 @@ class RectilinearGrid {
 	
 			/**************************************************************************************************************
 		 *
-		 * @brief  			Generate triangles from a 3D grid and save them to a file.
+		 * @brief  			Generate triangles from a 3D grid.
 		 *
 		 * @param  in		Camera* camera - pointer to the Camera object
+		 * 		   out		vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex, 3 vertices per triangle
+ * 		   in		bool analytic - if true then texels are calculated with the polynomial camera model (see getTexels)
+ * 		   			instead of sampling xmap/ymap
 		 *
 		 * @return 			-
 		 *
-		 * @remarks 		The file with triangles description has been saved to the file arrayX, where X is camera index.
-		 * 					The grid has been rotated according to the camera index value:
-		 * 						index = 0 - without rotation;
-		 * 						index = 1 - 90 degree clockwise rotation;
-		 * 						index = 2 - 180 degree clockwise rotation;
-		 * 						index = 3 - 270 degree clockwise rotation;
+		 * @remarks 		Vertices are 3D template points and texels are normalized fisheye coordinates.
+		 * 					The grid has been rotated clockwise by the camera yaw (see rotatePoint).
 		 *
 		 **************************************************************************************************************/
-	void saveGrid(Camera* camera);
+	void createMesh(Camera* camera, vector<float> &mesh, bool analytic = false);
 	
 	
 	private:
@@ -316,6 +403,7 @@ class RectilinearGrid {
 		vector<int> NoP;	// Number of points in grid column
 		vector<Point3f> p3d;	// 3D grid points (template points)
 		vector<Point2f> p2d;	// 2D grid points (image points)
+		vector<Point2f> p2t;	// Normalized fisheye texels of the 2D grid points
 		GridParam parameters; // Parameters of grid
 		vector<Point3f> seam; // Seam points
 
@@ -31,12 +31,17 @@
  *******************************************************************************************/
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <tuple>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "camera.hpp"
 #include "lines.hpp"
 #include "macros.hpp"
+#include "mask_file.hpp"
+#include "top_grid.hpp"
 
 using namespace cv;
 using namespace std;
@@ -45,6 +50,18 @@ using namespace std;
  * Macros
  *******************************************************************************************/
 #define SEAM_STEP 0.001
+#define FEATHER_SIGMA 10.0		/* Standard deviation of the mask feathering kernel */
+#define FEATHER_PASSES 3		/* Number of box filter passes approximating the feathering Gaussian */
+#define SPLIT_RADIUS 40			/* Half size of the mask neighborhood checked around every grid texel */
+#define WEIGHT_TOLERANCE 4.0	/* Maximum deviation (in mask levels) of the interpolated blend weight from the mask at an edge midpoint */
+#define WEIGHT_MIN_EDGE 2.0		/* Overlap grid edges shorter than this value (in mask pixels) are not split */
+#define WEIGHT_DEPTH 8			/* Maximum subdivision depth of an overlap grid triangle where its edges can be split */
+#define TOP_FLAT_Z 1e-5f		/* Grid vertices with |vz| below this value lie on the flat bowl bottom */
+
+/*******************************************************************************************
+ * Types
+ *******************************************************************************************/
+typedef map< tuple<float, float, float, float>, bool > EdgeSplits;	/* Split decisions of overlap grid edges (edge ends texels) */
 
 /*******************************************************************************************
  * Classes
@@ -118,24 +135,85 @@ class Masks {
 		 * @brief  			Split vertices/texels grid into grid which will be rendered with blending and grid which will
 		 * 					be rendered without blending for all cameras
 		 *
-		 * @param  			-
+		 * @param  	in		const vector< vector<float> > &meshes - grids of all cameras (5 floats per vertex: vx vy vz tx ty)
+		 * 			in		bool weights - if true then overlap grids with baked blend weights are produced too
+		 *
+		 * @return 			Functions returns 0 if a grid is given for every mask. Otherwise the function returns -1.
+		 *
+		 * @remarks 		The function produces two output grids for every camera: first for overlapping regions and
+		 * 					second for non-overlapping regions (see getSplitGrid).
+		 * 					Camera blending mask is used to split grid into two parts. The mask is eroded and dilated
+		 * 					once with a (2 * SPLIT_RADIUS + 1) square. If all texels of a triangle are white in the eroded
+		 * 					mask then the triangle is written to non-overlap grid. Otherwise, if at least one texel is not
+		 * 					black in the dilated mask then the triangle is written to overlap grid.
+		 * 					If weights is set then the overlap grid is also written with the mask value of every vertex
+		 * 					(see getWeightedGrid), so the renderer can interpolate the blend weight instead of sampling
+		 * 					the mask texture. Triangles are densified along the seam where the linear interpolation
+		 * 					of vertex weights does not follow the mask (see bakeWeights).
+		 *
+		 **************************************************************************************************************/
+		int splitGrids(const vector< vector<float> > &meshes, bool weights = false);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get split grid
+		 *
+		 * @param  	in		uint index - camera index
+		 * 			in		bool overlap - if true then overlap grid is returned. Otherwise non-overlap grid is returned.
+		 *
+		 * @return 			The function returns vector of vertices/texels (5 floats per vertex: vx vy vz tx ty) which has been
+		 * 					produced by the last splitGrids call. Empty vector is returned for invalid index.
+		 *
+		 **************************************************************************************************************/
+		const vector<float>& getSplitGrid(uint index, bool overlap) { static const vector<float> empty;
+																		 if (index >= split_b.size()) { return(empty); }
+																		 return(overlap ? split_b[index] : split_wb[index]);
+																	   }
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get overlap grid with baked blend weights
 		 *
-		 * @return 			Functions returns 0 if all grid files "arrayX" file (X = 1,2,3,4 is camera number) are existed.
-		 * 					If one of the files not found the function returns -1.
+		 * @param  	in		uint index - camera index
 		 *
-		 * @remarks 		The function reads grid of texels/vertices from the "arrayX" file (X = 1,2,3,4 is camera number)
-		 * 					and produces two output grids: first for overlapping regions ("arrayX1") and second for
-		 * 					non-overlapping regions ("arrayX2").
-		 * 					Camera blending mask is used to split grid into two parts. The mask value has been checked
-		 * 					for each texels of a rendered triangle. If at least one of texels is masked with value less than
-		 * 					255 then the triangle is written to overlap grid. Otherwise the triangle is written to non-overlap
-		 * 					grid.
+		 * @return 			The function returns vector of vertices/texels/weights (6 floats per vertex: vx vy vz tx ty w,
+		 * 					w is in [0, 1]) which has been produced by the last splitGrids call with weights set.
+		 * 					Empty vector is returned for invalid index or if weights have not been baked.
 		 *
 		 **************************************************************************************************************/
-		int splitGrids(void);
+		const vector<float>& getWeightedGrid(uint index) { static const vector<float> empty;
+															if (index >= split_bw.size()) { return(empty); }
+															return(split_bw[index]);
+														  }
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Create 2D bird's-eye remap grid
+		 *
+		 * @param  	in		const vector< vector<float> > &meshes - grids of all cameras (5 floats per vertex: vx vy vz tx ty)
+		 * 			in		uint density - number of grid cells along every side of the bowl bottom
+		 * 			out		vector<float> &grid - triangles of the bird's-eye grid (TOP_VERTEX_SIZE floats per vertex:
+		 * 					vx vy tx0 ty0 tx1 ty1 w camera0 camera1)
+		 *
+		 * @return 			Functions returns 0 if the grid has been created. Otherwise the function returns -1.
+		 *
+		 * @remarks 		The flat bottom (vz = 0) of the bowl is covered by a regular density x density grid of squares.
+		 * 					Every grid point is located in the bottom triangles of every camera grid, its fisheye texel is
+		 * 					interpolated from the triangle texels and its blend weight is the mask value at the texel.
+		 * 					Every grid triangle is assigned to two cameras with the biggest sum of vertex weights among
+		 * 					the cameras which see all its vertices (camera1 is equal to camera0 if only one camera is
+		 * 					found). w is the weight of camera0 normalized by the sum of both weights, so the renderer can
+		 * 					draw the whole bottom in one pass without blending and depth test. Triangles which are not
+		 * 					seen by any camera are skipped. Grid points are processed in parallel.
+		 *
+		 **************************************************************************************************************/
+		int createTopGrid(const vector< vector<float> > &meshes, uint density, vector<float> &grid);
 
 	private:		
 		vector<Mat> masks;	// Vector of masks
+		vector< vector<float> > split_b;	// Overlap grids (vx vy vz tx ty)
+		vector< vector<float> > split_wb;	// Non-overlap grids (vx vy vz tx ty)
+		vector< vector<float> > split_bw;	// Overlap grids with blend weights (vx vy vz tx ty w)
 		vector<Seam> seaml;	// Left seam
 		vector<Seam> seamr; // Right seam
 
@@ -148,12 +226,11 @@ class Masks {
 		 * 									For left mask edge the color range will be [0, 255] - from black to white.
 		 * 									And for right mask edge the color range will be [255, 0] - from white to black.
 		 * 			in		Vec2d angles - 	smoothing will be apply in these angles in the left and right direction from mask border.
-		 * 			in		double angle_step - step of color gradient
 		 * 			in		vector<Point3f> edge_points - 	vector of template points. It must include 3 points:
 		 * 													1. The first point of seam (intersection of bottom grid borders, z = 0)
 		 * 													2. The intersection point of seam line and base circle (z = 0)
 		 * 													3. The 3rd point of seam points (with maximum value of z coordinate)
-		 * 			in		Camera* camera  - Camera object
+		 * 			in		const Mat &bowl - bowl points seen by every fisheye pixel (see getBowlMap)
 		 *
 		 * @return 			-
 		 *
@@ -161,9 +238,84 @@ class Masks {
 		 * 					smoothing (2 * SMOTHING_ANGLE) defines the area in which mask edge will be smooth. The original seam divides
 		 * 					the smoothing angle into two angles with equal measures (angle bisector). The angle based smoothing is applied
 		 * 					only for flat base. The seam at the bowl side is smoothed with constant width of smoothing.
+		 * 					The color of every mask pixel is calculated directly from the angle between the seam line and the line
+		 * 					which goes from the first seam point to the bowl point seen by the pixel. Pixels are processed in parallel.
+		 *
+		 **************************************************************************************************************/
+		void smoothMaskEdge(Mat &img, Vec2b colors, Vec2d angles, vector<Point3f> edge_points, const Mat &bowl);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get bowl points seen by fisheye image pixels
+		 *
+		 * @param  	in		Camera* camera - Camera object
+		 * 			in		double radius - radius of flat circle bottom of bowl
+		 * 			out		Mat &bowl - CV_32FC3 matrix of fisheye image size. Every element contains template coordinates of
+		 * 					the bowl point which is seen by the pixel or NaN if the pixel is not mapped to the defisheye image.
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		The function inverts the xmap/ymap transformation with the polynomial camera model, back-projects the
+		 * 					defisheye pixel with camera parameters and intersects the ray with the bowl surface: flat base
+		 * 					(z = 0) inside the base circle and z = -(r - radius)^2 outside of it.
+		 *
+		 **************************************************************************************************************/
+		void getBowlMap(Camera* camera, double radius, Mat &bowl);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Feather mask rows
+		 *
+		 * @param  	in/out	Mat &img - mask (CV_8UC1)
+		 * 			in		double sigma - standard deviation of the feathering Gaussian
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		Every mask row is blurred in horizontal direction with Gaussian kernel which is truncated to
+		 * 					the radius (rows - row) / 2, so the feathering is wider at the top of the fisheye frame.
+		 * 					Rows which radius is bigger than 4 * sigma are filtered with FEATHER_PASSES running sum
+		 * 					box filters of constant cost per pixel. Shorter kernels are convolved directly. Rows are
+		 * 					processed in parallel.
+		 *
+		 **************************************************************************************************************/
+		void featherMask(Mat &img, double sigma);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get mask value at texel
+		 *
+		 * @param  	in		const Mat &mask - mask (CV_8UC1)
+		 * 			in		float tx, float ty - normalized texel coordinates
+		 *
+		 * @return 			The function returns bilinear interpolated mask value in [0, 255]. Texels outside of the mask
+		 * 					get the value of the nearest mask pixel.
+		 *
+		 **************************************************************************************************************/
+		float getWeight(const Mat &mask, float tx, float ty);
+
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Bake blend weights into the overlap grid triangle
+		 *
+		 * @param  	in		const Mat &mask - mask (CV_8UC1)
+		 * 			in		const Vec6f* tri - triangle vertices (vx vy vz tx ty w), w is the mask value in [0, 255]
+		 * 			in		int depth - subdivision depth of the triangle
+		 * 			in/out	EdgeSplits &splits - split decisions of the grid edges which have been already processed
+		 * 			out		vector<float> &out - weighted grid the triangles are appended to (vx vy vz tx ty w, w in [0, 1])
+		 *
+		 * @return 			-
+		 *
+		 * @remarks 		Every triangle edge is split at its midpoint if the mask value at the midpoint differs from the
+		 * 					mean of the edge vertex weights by more than WEIGHT_TOLERANCE, the edge is not shorter than
+		 * 					WEIGHT_MIN_EDGE mask pixels and the triangle is not deeper than WEIGHT_DEPTH. The decision is
+		 * 					made by the first triangle which reaches the edge and it is stored in splits, so the adjacent
+		 * 					triangle splits the shared edge in the same way whatever its depth is, and the densified grid
+		 * 					has no T-junctions. The triangle is divided into 2, 3 or 4 triangles according to the number
+		 * 					of split edges, and they are processed recursively. Triangles inside the smooth part of the
+		 * 					overlap keep the original size.
 		 *
 		 **************************************************************************************************************/
-		void smoothMaskEdge(Mat &img, Vec2b colors, Vec2d angles, double angle_step, vector<Point3f> edge_points, Camera* camera);
+		void bakeWeights(const Mat &mask, const Vec6f* tri, int depth, EdgeSplits &splits, vector<float> &out);
 
 		/**************************************************************************************************************
 		 *
@@ -181,8 +333,9 @@ class Masks {
 		 * 					1st point - left bottom vertex, 4th point - left top vertex, 5th point - right top vertex,
 		 * 					8th point - right bottom point. The polygon must be convex.
 		 * 			out		Seam &seam - polygons intersection (2 points + line that goes through them)
-		 * 			in		int rotation - direction of rotation for the second polygon. If rotation < 0, then the second polygon
-		 * 					is rotated on 90 degrees angle to the left. Otherwise it is rotated on 90 degrees angle to the right.
+		 * 			in		float rotation - yaw difference of the second and the first polygons cameras (degrees). The second
+		 * 					polygon is rotated counterclockwise by this angle. If rotation < 0, then the second polygon is the left
+		 * 					neighbor of the first polygon. Otherwise it is the right neighbor.
 		 *
 		 * @return 			-
 		 *
@@ -192,7 +345,7 @@ class Masks {
 		 * 					according to the rotation value.
 		 *
 		 **************************************************************************************************************/
-		void getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2, Seam &seam, int rotation);
+		void getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2, Seam &seam, float rotation);
 
 };
 
@@ -42,6 +42,7 @@ using namespace std;
  *******************************************************************************************/
 #define MAX_CONTOUR_APPROX  7
 #define CONTOURS_NUM 4
+#define THRESH_PASSES 6 // number of adaptive threshold passes (block size and offset pairs)
 
 #define MIN4(a,b,c,d)  (((a <= b) && (a <= c) && (a <= d)) ? (a) : \
 						(((b <= c) && (b <= d)) ? (b) : \
@@ -54,10 +55,33 @@ using namespace std;
 /*******************************************************************************************
  * Types
  *******************************************************************************************/
-struct CvContourEx
+/* Quadrangle candidates. Each field is a flat array indexed by the quad number. */
+struct ContourQuads
 {
-    CV_CONTOUR_FIELDS()
-    int counter;
+	vector<Point> corners;	/* 4 corners per quad in contour order: corners[4 * i + j] */
+	vector<double> area;	/* Area of the quad */
+	vector<int> source;		/* Index of the source contour in the findContours() output */
+	vector<int> parent;		/* Index of the outer contour for holes, -1 for objects */
+};
+
+/* Scratch buffers of a single threshold pass */
+struct ContourPass
+{
+	Mat threshold;					/* Thresholded image */
+	vector<vector<Point>> contours;	/* Contours found in the thresholded image */
+	vector<Vec4i> hierarchy;		/* Contours hierarchy */
+	vector<Point> approx[2];		/* Polygon approximation buffers */
+	vector<uchar> has_quad;			/* Source contour has produced a quad */
+	vector<uchar> has_child;		/* Hole of the contour has produced a quad */
+	ContourQuads quads;				/* Quads found by the pass */
+};
+
+/* Buffers of the contour search. They are kept between calls to avoid reallocation. */
+struct ContourBuffers
+{
+	Mat padded, sum;		/* Padded input image and its integral image */
+	Mat mean[2];			/* Local mean for 2 block sizes */
+	vector<ContourPass> pass;	/* Buffers of each threshold pass */
 };
 
 /*******************************************************************************************
@@ -68,24 +92,26 @@ struct CvContourEx
  * @brief  			Search contours in input image
  *
  * @param  	in		const Mat &img - input image
- * 			in/out	CvSeq** root - sequence of contours
- * 			in		CvMemStorage *mem_storage - memory storage
+ * 			out		ContourQuads &quads - found quadrangles
+ * 			in/out	ContourBuffers &buf - scratch buffers
  *			in		int min_size - empiric bound for minimal allowed perimeter for contour squares
  *
  * @return 			Functions returns the number of contours which were found.
  *
  * @remarks 		The function applies adaptive threshold on input image and searches contours in image.
- * 					If 4 contours are found then function has been terminated. Otherwise it changes block size
- * 					for adaptive threshold and tries again.
+ * 					THRESH_PASSES thresholds with different block sizes and offsets are checked concurrently,
+ * 					each pass in its own buffers. The result of the first pass (in pass order) which found
+ * 					4 contours is copied to the quads. If no pass found 4 contours then the result of the last
+ * 					pass is returned.
  *
  **************************************************************************************************************/
-extern int GetContours(const Mat &img, CvSeq** root, CvMemStorage *mem_storage, int min_size);
+extern int GetContours(const Mat &img, ContourQuads &quads, ContourBuffers &buf, int min_size);
 
 /**************************************************************************************************************
  *
  * @brief  			Sort contours from left to right
  *
- * @param  	in		CvSeq** root - sequence of contours
+ * @param  	in/out	ContourQuads &quads - quadrangles
  *
  * @return 			-
  *
@@ -93,13 +119,13 @@ extern int GetContours(const Mat &img, CvSeq** root, CvMemStorage *mem_storage,
  * 					according to this value from left to right.
  *
  **************************************************************************************************************/
-extern void SortContours(CvSeq** root);
+extern void SortContours(ContourQuads &quads);
 
 /**************************************************************************************************************
  *
  * @brief  			Generate vector of contour points in proper order.
  *
- * @param  	in		CvSeq** root - sequence of contours
+ * @param  	in		const ContourQuads &quads - quadrangles
  * 			out		vector<Point2f> * feature_points
  * 			in		Point2f shift
  *
@@ -109,37 +135,37 @@ extern void SortContours(CvSeq** root);
  * 					coordinates and push the corners to the feature_points array in proper order.
  *
  **************************************************************************************************************/
-extern void GetFeaturePoints(CvSeq** root, vector<Point2f> &feature_points, Point2f shift);
+extern void GetFeaturePoints(const ContourQuads &quads, vector<Point2f> &feature_points, Point2f shift);
 
 /**************************************************************************************************************
  *
  * @brief  			Filter found contours.
  *
- * @param  	in/out	CvSeq** root - sequence of contours
+ * @param  	in/out	ContourPass &pass - pass buffers with found quadrangles
  *
  * @return 			-
  *
- * @remarks 		The function checks all contours from the input sequence and removes contours
- * 					which are not located inside another sequence contour or which do not contain
- * 					another sequence contour.
+ * @remarks 		The function removes quads which are not paired with another quad: a hole quad is kept
+ * 					if its outer contour has produced a quad and an object quad is kept if one of its holes
+ * 					has produced a quad. The check is a single pass over the quads.
  *
  **************************************************************************************************************/
-extern void FilterContours(CvSeq** root);
+extern void FilterContours(ContourPass &pass);
 
 /**************************************************************************************************************
  *
- * @brief  			Convert contours sequence into the vector of points.
+ * @brief  			Convert contours into the vector of points.
  *
- * @param  	in		CvSeq** root - sequence of contours
+ * @param  	in		const ContourQuads &quads - quadrangles
  * 			out		vector<Point2f> * feature_points
  * 			in		Point2f shift
  *
  * @return 			-
  *
- * @remarks 		The function convert sequence of contours into points array. The shift is applied on corners
+ * @remarks 		The function convert quadrangles into points array. The shift is applied on corners
  * 					coordinates.
  *
  **************************************************************************************************************/
-extern void sec2vector(CvSeq** root, vector<Point2f> &feature_points, Point2f shift);
+extern void sec2vector(const ContourQuads &quads, vector<Point2f> &feature_points, Point2f shift);
 
 #endif /* SRC_CONTOURS_HPP_ */
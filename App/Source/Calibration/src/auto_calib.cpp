@@ -217,21 +217,25 @@ int objectsInit(void)
 	{
 		string calib_res_txt = param.camera_models + "/calib_results_" + to_string(i + 1) + ".txt"; // Camera model
 		Creator creator;
-		Camera* camera = creator.create(calib_res_txt.c_str(), param.cameras[i].sf, i); // Create Camera object
+		Camera* camera = creator.create(calib_res_txt.c_str(), param.cameras[i].sf, i,
+			param.camera_yaw[i], param.previousCamera(i), param.nextCamera(i), param.camera_num); // Create Camera object
 		if (camera == NULL) 
 		{
 			cout << "ERROR: Failed to create camera model" << endl;
 			return (-1);
 		}
 		cameras.push_back(camera);
+
+		artefact lut = {vector<double>(1, (double)param.cameras[i].sf), 1U, true}; // LUT has been calculated by creator
+		luts.push_back(lut);
 	}
+
+	artefact empty = {vector<double>(), 0U, false};
+	extrinsics.assign(cameras.size(), empty);
+	mesh_uploads.assign(cameras.size(), empty);
 	
-	///////////////////// Create grid objects //////////////////
-	for (int i = 0; i < param.camera_num; i++) 
-	{
-		CurvilinearGrid* grid_element = new CurvilinearGrid(param.grid_angles, param.grid_start_angle, param.grid_nop_z, param.grid_step_x);
-		grids.push_back(grid_element);
-	}	
+	///////////////////// Grids, masks and output files //////////////////
+	pipeline = new CalibPipeline((uint)cameras.size());
 	return 0;
 }
 
@@ -244,121 +248,183 @@ void objectsFree(void)
 	for (int i = (int)cameras.size() - 1; i > 0; i--) {
 		delete cameras[i];
 	}
-	for (int i = (int)grids.size() - 1; i > 0; i--) {
-		delete grids[i];		
-	}	
+	delete pipeline;
 }
 
 /***************************************************************************************
 ***************************************************************************************/
 void switchState(viewStates new_state)
 {
-	float* data;
-	int data_num;
-
 	printState(new_state);
 
-	switch (new_state)
-	{				
-	case fisheye_view:
+	if (new_state == fisheye_view)
+	{
 		// Fisheye
 		for (uint i = 0U; i < cameras.size(); i++)
 		{
 			string filename = "../Content/meshes/original/mesh" + to_string(i + 1U);
 			view->reloadMesh(cam_views[i].mesh_index[0U], filename);
-		}	
-		break;
-				
-	case defisheye_view:
-		// Defisheye
-		for (uint i = 0U; i < cameras.size(); i++) {
-			view->changeMesh(cameras[i]->xmap, cameras[i]->ymap, 10, Point2f((static_cast<float>(i & 1U) - 1.0f), static_cast<float>((~i >> 1U) & 1U)), cam_views[i].mesh_index[0U]);
+			mesh_uploads[i].key.clear(); // Defisheye mesh must be uploaded again
 		}
-		break;
-		
-	case contours_view:
-		// Contours searching
-		data_num = getContours(&data);
-		contours_buf = view->addBuffer(&data[0], data_num / 3);
-		view->setBufferAsAttr(contours_buf, 1, (const char*)"vPosition");
-		if (data != NULL) { free(data); }
-		break;
+	}
+	if (new_state >= defisheye_view) { updateLUTs(); }
+	if (new_state >= contours_view) { updateExtrinsics(new_state == contours_view); } // Capture new frames for contours view
+	if (new_state >= grids_view) { pipeline->updateGrids(param, cameras, extrinsics); }
+	if (new_state == result_view) { pipeline->saveGrids(param, cameras); }
 
-	case grids_view:
-		// Mesh generation
-		data_num = getGrids(&data);
-		grid_buf = view->addBuffer(&data[0], data_num / 3);
-		view->setBufferAsAttr(grid_buf, 1, (const char*)"vPosition");
-		if (data != NULL) { free(data); }
-		break;
-		
-	default: // result_view
-		// Result view
-		saveGrids();
-		for (uint i = 0U; i < cam_views.size(); i++)
+	uploadArtefacts(new_state);
+	cout << "\tDone" << endl;
+}
+
+
+/***************************************************************************************
+***************************************************************************************/
+void updateState(viewStates new_state)
+{
+	printState(new_state);
+
+	if (param.camera_num != (int)cameras.size())
+	{
+		cout << "The number of cameras can be changed only by restart" << endl;
+		return;
+	}
+
+	// Camera yaws and ring neighbors can be changed in settings too
+	for (uint i = 0U; i < cameras.size(); i++) {
+		cameras[i]->setPlacement(param.camera_yaw[i], param.previousCamera((int)i), param.nextCamera((int)i), param.camera_num);
+	}
+
+	// Only artefacts which parameters have been changed are recalculated. Contours view captures new frames
+	// and searches contours again, so the target can be moved or the light changed between updates
+	if (new_state >= defisheye_view) { updateLUTs(); }
+	if (new_state >= contours_view) { updateExtrinsics(new_state == contours_view); }
+	if (new_state >= grids_view) { pipeline->updateGrids(param, cameras, extrinsics); }
+	if (new_state == result_view) { pipeline->saveGrids(param, cameras); }
+
+	uploadArtefacts(new_state);
+	cout << "\tDone" << endl;
+}
+
+
+/***************************************************************************************
+***************************************************************************************/
+void updateLUTs(void)
+{
+	for (uint i = 0U; i < cameras.size(); i++)
+	{
+		vector<double> key = {(double)param.cameras[i].sf};
+		if (isOutdated(luts[i], key))
 		{
-			if (cam_views[i].mesh_index.size() == 1)
-			{
-				cam_views[i].mesh_index.push_back(view->addMesh(string("array" + to_string(i + 1U) + "1")));
-				cam_views[i].mesh_index.push_back(view->addMesh(string("array" + to_string(i + 1U) + "2")));
-			}
-			else
-			{
-				view->reloadMesh(cam_views[i].mesh_index[1U], string("array" + to_string(i + 1U) + "1"));
-				view->reloadMesh(cam_views[i].mesh_index[2U], string("array" + to_string(i + 1U) + "2"));			
-			}
+			cameras[i]->updateLUT(param.cameras[i].sf);
+			setArtefact(luts[i], key, true);
 		}
+	}
+}
 
-		break;		
+
+/***************************************************************************************
+***************************************************************************************/
+void updateExtrinsics(bool force)
+{
+	for (uint i = 0U; i < cameras.size(); i++)
+	{
+		vector<double> key = {(double)luts[i].version, (double)param.cameras[i].roi, (double)param.cameras[i].cntr_min_size, (double)param.cameras[i].chessboard_num};
+		if (force || isOutdated(extrinsics[i], key)) {
+			setArtefact(extrinsics[i], key, (searchContours(i) == 0));
+		}
 	}
-	cout << "\tDone" << endl;
 }
 
 
 /***************************************************************************************
 ***************************************************************************************/
-void updateState(viewStates new_state)
+void uploadArtefacts(viewStates state)
 {
-	float* data;
+	float* data = NULL;
 	int data_num;
 
-	printState(new_state);
-
-	switch (new_state)
-	{		
-		
-	case defisheye_view:
-		// Defisheye
-		for (uint i = 0U; i < cameras.size(); i++) 
+	// Defisheye meshes
+	if (state != fisheye_view)
+	{
+		for (uint i = 0U; i < cameras.size(); i++)
 		{
-			cameras[i]->updateLUT(param.cameras[i].sf);	
-			view->changeMesh(cameras[i]->xmap, cameras[i]->ymap, 10, Point2f((static_cast<float>(i & 1U) - 1.0f), static_cast<float>((~i >> 1U) & 1U)), cam_views[i].mesh_index[0U]);
+			vector<double> key = {(double)luts[i].version};
+			if (isOutdated(mesh_uploads[i], key))
+			{
+				view->changeMesh(cameras[i]->xmap, cameras[i]->ymap, 10, cameras[i]->tile, cam_views[i].mesh_index[0U], cameras[i]->tile_size);
+				setArtefact(mesh_uploads[i], key, true);
+			}
 		}
-		break;
-				
+	}
+
+	vector<double> key;
+	switch (state)
+	{
 	case contours_view:
-		// Contours searching
-		data_num = getContours(&data);
-		view->updateBuffer(contours_buf, &data[0], data_num / 3);
-		if (data != NULL) { free(data); }
+		// Contours
+		for (uint i = 0U; i < extrinsics.size(); i++) { key.push_back((double)extrinsics[i].version); }
+		if (isOutdated(contours_upload, key))
+		{
+			data_num = getContours(&data);
+			if (contours_buf == -1)
+			{
+				contours_buf = view->addBuffer(&data[0], data_num / 3);
+				view->setBufferAsAttr(contours_buf, 1, (const char*)"vPosition");
+			}
+			else {
+				view->updateBuffer(contours_buf, &data[0], data_num / 3);
+			}
+			delete[] data;
+			setArtefact(contours_upload, key, true);
+		}
 		break;
-	
+
 	case grids_view:
-		// Mesh generation
-		data_num = getGrids(&data);
-		view->updateBuffer(grid_buf, &data[0], data_num / 3);
-		if (data != NULL) { free(data); }
+		// Grids
+		for (uint i = 0U; i < cameras.size(); i++) { key.push_back((double)pipeline->getGridVersion(i)); }
+		if (isOutdated(grid_upload, key))
+		{
+			data_num = getGrids(&data);
+			if (grid_buf == -1)
+			{
+				grid_buf = view->addBuffer(&data[0], data_num / 3);
+				view->setBufferAsAttr(grid_buf, 1, (const char*)"vPosition");
+			}
+			else {
+				view->updateBuffer(grid_buf, &data[0], data_num / 3);
+			}
+			delete[] data;
+			setArtefact(grid_upload, key, true);
+		}
 		break;
-		
-	default: //result_view
-		for (uint i = 0U; i < cam_views.size(); i++)
+
+	case result_view:
+		// Split grids are uploaded from memory
+		key.push_back((double)pipeline->getSplitVersion());
+		if (isOutdated(result_upload, key))
 		{
-			view->reloadMesh(cam_views[i].mesh_index[1U], string("array" + to_string(i + 1U) + "1"));
-			view->reloadMesh(cam_views[i].mesh_index[2U], string("array" + to_string(i + 1U) + "2"));
+			for (uint i = 0U; i < cam_views.size(); i++)
+			{
+				const vector<float> &mesh_b = pipeline->getMasks().getSplitGrid(i, true);
+				const vector<float> &mesh_wb = pipeline->getMasks().getSplitGrid(i, false);
+				if (cam_views[i].mesh_index.size() == 1)
+				{
+					cam_views[i].mesh_index.push_back(view->addMesh(mesh_b.data(), (int)mesh_b.size() / 5));
+					cam_views[i].mesh_index.push_back(view->addMesh(mesh_wb.data(), (int)mesh_wb.size() / 5));
+				}
+				else
+				{
+					view->reloadMesh(cam_views[i].mesh_index[1U], mesh_b.data(), (int)mesh_b.size() / 5);
+					view->reloadMesh(cam_views[i].mesh_index[2U], mesh_wb.data(), (int)mesh_wb.size() / 5);
+				}
+			}
+			setArtefact(result_upload, key, true);
 		}
 		break;
+
+	default:
+		break;
 	}
-	cout << "\tDone" << endl;
 }
 
 
@@ -406,7 +472,7 @@ int getContours(float** gl_lines)
 	
 		for (uint i = 0U; i < cameras.size(); i++)
 		{
-			if(searchContours(i) == 0)
+			if(extrinsics[i].valid)
 			{
 				array_num[i] = cameras[i]->getContours(&contours[i]);
 				sum_num += array_num[i];
@@ -453,18 +519,8 @@ int getGrids(float** gl_grid)
 		}
 		int index = 0;
 
-		int nopz = param.grid_nop_z;
-		for (uint i = 0U; i < cameras.size(); i++) { 	// Get number of points in z axis
-			int tmp = cameras[i]->getBowlHeight(param.bowl_radius * cameras[i]->getBaseRadius(), param.grid_step_x);
-			nopz = MIN(nopz, tmp);
-		}
-
-		vector< vector<Point3f> > seam;
-		for (uint i = 0U; i < grids.size(); i++) {
-			*grids[i] = CurvilinearGrid(param.grid_angles, param.grid_start_angle, nopz, param.grid_step_x);
-			if(grids[i] == NULL) { continue; }	
-			grids[i]->createGrid(cameras[i], param.bowl_radius * cameras[i]->getBaseRadius()); // Calculate grid points and save grid to the file
-			array_num[i] = grids[i]->getGrid(&grids_data[i]);
+		for (uint i = 0U; i < cameras.size(); i++) {
+			array_num[i] = pipeline->getGrid(i)->getGrid(&grids_data[i]);
 			sum_num += array_num[i];
 		}
 
@@ -487,31 +543,3 @@ int getGrids(float** gl_grid)
 
 	return sum_num;
 }
-
-
-
-/***************************************************************************************
-***************************************************************************************/	
-void saveGrids(void)
-{
-	vector< vector<Point3f> > seams;
-	vector<Point3f> seam_points;		
-	for (uint i = 0U; i < grids.size(); i++) 
-	{
-		grids[i]->saveGrid(cameras[i]);
-		grids[i]->getSeamPoints(seam_points);	// Get grid seams
-		seams.push_back(seam_points);
-	}
-
-	Masks masks;
-	masks.createMasks(cameras, seams, param.smooth_angle); // Calculate masks for blending       
-	if(masks.splitGrids() == -1) {
-		cout << "ERROR: Texels/vertices grids have not been split" << endl;
-	}
-
-	Compensator compensator(Size(param.disp_width, param.disp_height)); // Exposure correction  
-	compensator.feed(cameras, seams);
-	if(compensator.save((const char*)"./compensator") == -1) {
-		cout << "ERROR: Compensator grids have not been saved" << endl;
-	}
-}
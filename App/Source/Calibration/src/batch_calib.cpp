@@ -0,0 +1,190 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "batch_calib.hpp"
+
+using namespace std;
+using namespace cv;
+
+/***************************************************************************************
+***************************************************************************************/
+// Program entry.
+// Usage: batch_calib [settings.xml] [frames folder]
+// The frames folder must contain calibration frames frame1.jpg ... frameN.jpg captured from
+// cameras 1 ... N. If the folder is not set, the camera_inputs path from settings is used.
+int main(int argc, char** argv)
+{
+	string settings = (argc > 1) ? string(argv[1]) : string("../Content/settings.xml");
+
+	//////////////////// Read XML parameters /////////////////////
+	if (param.readXML(settings.c_str()) == -1) { return (-1); }
+	string frames_path = (argc > 2) ? string(argv[2]) : param.camera_inputs;
+
+	int tmpl_width, tmpl_height;
+	if (param.getTmpMaxVal("template_1.txt", &tmpl_width) == -1) { return (-1); }
+	if (param.getTmpMaxVal("template_2.txt", &tmpl_height) == -1) { return (-1); }
+
+	int status = 0;
+
+	//////////////////// Load frames and create cameras //////////////////
+	for (int i = 0; i < param.camera_num; i++)
+	{
+		Mat frame;
+		status |= runStage("Load frame", i, [&]() {
+			string frame_name = frames_path + "/frame" + to_string(i + 1) + ".jpg";
+			frame = imread(frame_name, CV_LOAD_IMAGE_COLOR);
+			if (frame.empty())
+			{
+				cout << "ERROR: The " << frame_name << " image not found" << endl;
+				return (-1);
+			}
+			return (0);
+		});
+		frames.push_back(frame);
+
+		Camera* camera = NULL;
+		status |= runStage("Camera model and LUT", i, [&]() {
+			string calib_res_txt = param.camera_models + "/calib_results_" + to_string(i + 1) + ".txt"; // Camera model
+			camera = Creator::create(calib_res_txt.c_str(), param.cameras[i].sf, i,
+				param.camera_yaw[i], param.previousCamera(i), param.nextCamera(i), param.camera_num); // Create Camera object
+			if (camera == NULL) 
+			{
+				cout << "ERROR: Failed to create camera model" << endl;
+				return (-1);
+			}
+			return (0);
+		});
+		if (camera == NULL) { break; }
+		cameras.push_back(camera);
+	}
+
+	if (status != 0)
+	{
+		printReport();
+		objectsFree();
+		return (-1);
+	}
+
+	//////////////////// Intrinsic and extrinsic parameters //////////////////
+	vector<artefact> extrinsics(cameras.size(), artefact{vector<double>(), 0U, false});
+	for (uint i = 0U; i < cameras.size(); i++)
+	{
+		int res = runStage("Contours and pose", (int)i, [&]() {
+			string ref_points_txt = param.tmplt + "/template_" + to_string(i + 1U) + ".txt"; // Template points
+			string chessboard = param.camera_models + "/chessboard_" + to_string(i + 1U) + "/"; // Chessboard image
+			string chessboard_name = string("frame" + to_string(i + 1U) + "_");
+
+			cameras[i]->setRoi(param.cameras[i].roi);
+			cameras[i]->setContourMinSize(param.cameras[i].cntr_min_size);
+			if (cameras[i]->setTemplate(ref_points_txt.c_str(), Size2d(tmpl_width, tmpl_height)) != 0) { return (-1); }
+			if (cameras[i]->setIntrinsic(chessboard.c_str(), chessboard_name.c_str(), param.cameras[i].chessboard_num, Size(7, 7)) != 0) { return (-1); }
+			return (cameras[i]->setExtrinsic(frames[i]));
+		});
+		status |= res;
+		setArtefact(extrinsics[i], vector<double>(), (res == 0));
+	}
+
+	if (status != 0)
+	{
+		printReport();
+		objectsFree();
+		return (-1);
+	}
+
+	//////////////////// Grids, masks and output files //////////////////
+	CalibPipeline pipeline((uint)cameras.size());
+	pipeline.setRunner(runStage);
+	status |= pipeline.updateGrids(param, cameras, extrinsics);
+	status |= pipeline.saveGrids(param, cameras);
+
+	printReport();
+	objectsFree();
+
+	return ((status == 0) ? 0 : -1);
+}
+
+/***************************************************************************************
+***************************************************************************************/
+long getMemory(void)
+{
+	long pages = 0, resident = 0;
+	ifstream statm("/proc/self/statm");
+	if (!(statm >> pages >> resident)) { return (0); }
+	return (resident * (sysconf(_SC_PAGESIZE) / 1024L));
+}
+
+/***************************************************************************************
+***************************************************************************************/
+int runStage(string name, int camera, function<int(void)> stage)
+{
+	struct timespec t1 = {0, 0}, t2 = {0, 0};
+	long rss = getMemory();
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	int status = stage();
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+
+	stage_report r;
+	r.name = name;
+	r.camera = camera;
+	r.time = timespec2doublems(timespec_sub(t2, t1));
+	r.rss = getMemory();
+	r.rss_diff = r.rss - rss;
+	r.status = (status == 0) ? 0 : -1;
+	report.push_back(r);
+
+	return (r.status);
+}
+
+/***************************************************************************************
+***************************************************************************************/
+void printReport(void)
+{
+	double total = 0.0;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	cout << endl << left << setw(24) << "Stage" << setw(8) << "Camera" << right << setw(12) << "Time, ms"
+		 << setw(12) << "RSS, MB" << setw(12) << "dRSS, MB" << setw(8) << "Status" << endl;
+	for (uint i = 0U; i < report.size(); i++)
+	{
+		cout << left << setw(24) << report[i].name << setw(8) << ((report[i].camera < 0) ? string("all") : to_string(report[i].camera + 1))
+			 << right << fixed << setprecision(2) << setw(12) << report[i].time
+			 << setw(12) << (double)report[i].rss / 1024.0 << setw(12) << (double)report[i].rss_diff / 1024.0
+			 << setw(8) << ((report[i].status == 0) ? "OK" : "FAIL") << endl;
+		total += report[i].time;
+	}
+	cout << left << setw(32) << "Total" << right << setw(12) << total << setw(12) << (double)usage.ru_maxrss / 1024.0 << " (peak)" << endl;
+}
+
+/***************************************************************************************
+***************************************************************************************/
+void objectsFree(void)
+{
+	for (uint i = 0U; i < cameras.size(); i++) {
+		delete cameras[i];
+	}
+	cameras.clear();
+}
@@ -0,0 +1,354 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include "calib_pipeline.hpp"
+
+/**************************************************************************************************************
+ *
+ * @brief  			Check if the artefact must be rebuilt
+ *
+ * @param  in 		const artefact &a - artefact
+ * 		   in		const vector<double> &key - current parameters and versions of the artefact inputs
+ *
+ * @return 			The function returns true if the last build has failed or the key has been changed.
+ *
+ **************************************************************************************************************/
+bool isOutdated(const artefact &a, const vector<double> &key)
+{
+	return ((!a.valid) || (a.key != key));
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Store the result of the artefact build
+ *
+ * @param  out 		artefact &a - artefact
+ * 		   in		const vector<double> &key - parameters and versions of the artefact inputs
+ * 		   in		bool valid - the build has been successful
+ *
+ * @return 			-
+ *
+ * @remarks 		The function increments the artefact version.
+ *
+ **************************************************************************************************************/
+void setArtefact(artefact &a, const vector<double> &key, bool valid)
+{
+	a.key = key;
+	a.version++;
+	a.valid = valid;
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			CalibPipeline class constructor.
+ *
+ * @param  in 		uint camera_num - number of cameras
+ *
+ * @return 			-
+ *
+ * @remarks 		All artefacts are outdated, so the first calls of updateGrids and saveGrids build everything.
+ *
+ **************************************************************************************************************/
+CalibPipeline::CalibPipeline(uint camera_num)
+{
+	artefact empty = {vector<double>(), 0U, false};
+	heights.assign(camera_num, empty);
+	grid_states.assign(camera_num, empty);
+	grid_meshes.assign(camera_num, empty);
+	grid_files.assign(camera_num, empty);
+	masks_state = empty;
+	split_state = empty;
+	compensator_state = empty;
+	top_state = empty;
+	lod_state = empty;
+
+	grids.assign(camera_num, CurvilinearGrid(0U, 0U, 0U, 0.0)); // Grids parameters are set by updateGrids
+	meshes.assign(camera_num, vector<float>());
+	bowl_heights.assign(camera_num, 0);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Run calibration stage
+ *
+ * @param  in 		string name - stage name
+ * 		   in		int camera - camera index or -1 if the stage is common for all cameras
+ * 		   in		function<int(void)> stage - stage
+ *
+ * @return 			The function returns the stage status (0 - success, -1 - error).
+ *
+ **************************************************************************************************************/
+int CalibPipeline::runStage(string name, int camera, function<int(void)> stage)
+{
+	int status = runner ? runner(name, camera, stage) : stage();
+	return ((status == 0) ? 0 : -1);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate bowl heights and grids
+ *
+ * @param  in 		XMLParameters &param - settings
+ * 		   in		vector<Camera*> &cameras - cameras with intrinsic and extrinsic parameters
+ * 		   in		const vector<artefact> &extrinsics - artefacts of camera poses (one per camera)
+ *
+ * @return 			The function returns 0 if all rebuilt stages have been successful. Otherwise -1 is returned.
+ *
+ * @remarks 		Only the grids which keys have been changed are recalculated. A grid is valid if the camera
+ * 					pose is valid and the grid has all seam points.
+ *
+ **************************************************************************************************************/
+int CalibPipeline::updateGrids(XMLParameters &param, vector<Camera*> &cameras, const vector<artefact> &extrinsics)
+{
+	int status = 0;
+	int nopz = param.grid_nop_z;
+	for (uint i = 0U; i < grids.size(); i++) 	// Get number of points in z axis
+	{
+		vector<double> key = {(double)extrinsics[i].version, (double)param.bowl_radius, (double)param.grid_step_x};
+		if (isOutdated(heights[i], key))
+		{
+			status |= runStage("Bowl height", (int)i, [&]() {
+				bowl_heights[i] = cameras[i]->getBowlHeight(param.bowl_radius * cameras[i]->getBaseRadius(), param.grid_step_x);
+				return (0);
+			});
+			setArtefact(heights[i], key, true);
+		}
+		nopz = MIN(nopz, bowl_heights[i]);
+	}
+
+	for (uint i = 0U; i < grids.size(); i++)
+	{
+		vector<double> key = {(double)extrinsics[i].version, (double)param.grid_angles, (double)param.grid_start_angle, (double)nopz, (double)param.grid_step_x, (double)param.bowl_radius};
+		if (isOutdated(grid_states[i], key))
+		{
+			int res = runStage("Grid", (int)i, [&]() {
+				grids[i] = CurvilinearGrid(param.grid_angles, param.grid_start_angle, nopz, param.grid_step_x);
+				grids[i].createGrid(cameras[i], param.bowl_radius * cameras[i]->getBaseRadius()); // Calculate grid points
+				vector<Point3f> seam_points;
+				grids[i].getSeamPoints(seam_points);
+				return ((seam_points.size() == 8U) ? 0 : -1);
+			});
+			status |= res;
+			setArtefact(grid_states[i], key, extrinsics[i].valid && (res == 0));
+		}
+	}
+	return ((status == 0) ? 0 : -1);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate meshes, masks, split grids and save output files
+ *
+ * @param  in 		XMLParameters &param - settings
+ * 		   in		vector<Camera*> &cameras - cameras with intrinsic and extrinsic parameters
+ *
+ * @return 			The function returns 0 if all rebuilt stages have been successful. Otherwise -1 is returned.
+ *
+ * @remarks 		The function must be called after updateGrids. Only the artefacts which keys have been
+ * 					changed are recalculated: grid meshes, blending masks, split grids, exposure correction
+ * 					grids (./compensator), bird's-eye grid (./top_grid), grid files (./arrayX, ./arrayX1,
+ * 					./arrayX2, ./arrayX3) and levels of detail (./lodN). Files of disabled options and levels
+ * 					above lod_levels are removed, so the renderer does not pick up outdated data.
+ *
+ **************************************************************************************************************/
+int CalibPipeline::saveGrids(XMLParameters &param, vector<Camera*> &cameras)
+{
+	int status = 0;
+	vector<double> grids_key;
+	vector<double> meshes_key;
+	vector<double> yaws_key;	// Yaws define grids rotation and the cameras ring
+	vector< vector<Point3f> > seams;
+	vector<Point3f> seam_points;
+	for (uint i = 0U; i < grids.size(); i++)
+	{
+		vector<double> key = {(double)grid_states[i].version, (double)param.analytic_texels, (double)cameras[i]->yaw};
+		if (isOutdated(grid_meshes[i], key))
+		{
+			status |= runStage("Mesh", (int)i, [&]() {
+				grids[i].createMesh(cameras[i], meshes[i], param.analytic_texels);
+				return (0);
+			});
+			setArtefact(grid_meshes[i], key, true);
+		}
+		grids[i].getSeamPoints(seam_points);	// Get grid seams
+		seams.push_back(seam_points);
+		grids_key.push_back((double)grid_states[i].version);
+		meshes_key.push_back((double)grid_meshes[i].version);
+		yaws_key.push_back((double)cameras[i]->yaw);
+	}
+
+	vector<double> key = grids_key;
+	key.insert(key.end(), yaws_key.begin(), yaws_key.end());
+	key.push_back((double)param.smooth_angle);
+	if (isOutdated(masks_state, key))
+	{
+		status |= runStage("Masks", -1, [&]() {
+			masks.createMasks(cameras, seams, param.smooth_angle); // Calculate masks for blending
+			return (0);
+		});
+		setArtefact(masks_state, key, true);
+	}
+
+	key = meshes_key;
+	key.push_back((double)masks_state.version);
+	key.push_back((double)param.blend_weights);
+	if (isOutdated(split_state, key))
+	{
+		int res = runStage("Split grids", -1, [&]() {
+			return (masks.splitGrids(meshes, param.blend_weights));
+		});
+		if (res != 0) {
+			cout << "ERROR: Texels/vertices grids have not been split" << endl;
+		}
+		status |= res;
+		setArtefact(split_state, key, (res == 0));
+	}
+
+	key = meshes_key;
+	key.insert(key.end(), yaws_key.begin(), yaws_key.end());
+	key.push_back((double)param.disp_width);
+	key.push_back((double)param.disp_height);
+	if (isOutdated(compensator_state, key))
+	{
+		int res = runStage("Compensator", -1, [&]() {
+			Compensator compensator(Size(param.disp_width, param.disp_height)); // Exposure correction
+			compensator.feed(cameras, seams);
+			return (compensator.save((const char*)"./compensator", meshes));
+		});
+		if (res != 0) {
+			cout << "ERROR: Compensator grids have not been saved" << endl;
+		}
+		status |= res;
+		setArtefact(compensator_state, key, (res == 0));
+	}
+
+	key = meshes_key;
+	key.push_back((double)masks_state.version);
+	key.push_back((double)param.top_density);
+	if (isOutdated(top_state, key))
+	{
+		int res = 0;
+		if (param.top_density > 0)
+		{
+			res = runStage("Bird's-eye grid", -1, [&]() {
+				vector<float> top_grid;
+				if (masks.createTopGrid(meshes, (uint)param.top_density, top_grid) != 0) { return (-1); }
+				return (saveMesh("./top_grid", top_grid, TOP_VERTEX_SIZE));
+			});
+		}
+		else { remove("./top_grid"); } // Renderer must not pick up outdated grid
+		if (res != 0) {
+			cout << "ERROR: Bird's-eye grid has not been saved" << endl;
+		}
+		status |= res;
+		setArtefact(top_state, key, (res == 0));
+	}
+
+	// Write grids of every camera in one pass
+	for (uint i = 0U; i < grids.size(); i++)
+	{
+		key = {(double)grid_meshes[i].version, (double)split_state.version};
+		if (isOutdated(grid_files[i], key))
+		{
+			int res = runStage("Save grids", (int)i, [&]() {
+				char file_name[50];
+				int ret = 0;
+				sprintf(file_name, "./array%d", i + 1U);
+				ret |= saveMesh(file_name, meshes[i]);
+				sprintf(file_name, "./array%d1", i + 1U);
+				ret |= saveMesh(file_name, masks.getSplitGrid(i, true));
+				sprintf(file_name, "./array%d2", i + 1U);
+				ret |= saveMesh(file_name, masks.getSplitGrid(i, false));
+				sprintf(file_name, "./array%d3", i + 1U);
+				if (param.blend_weights) { ret |= saveMesh(file_name, masks.getWeightedGrid(i), 6U); }
+				else { remove(file_name); } // Renderer must not pick up outdated weights
+				return (ret);
+			});
+			status |= res;
+			setArtefact(grid_files[i], key, (res == 0));
+		}
+	}
+
+	// Coarser levels of detail are split with a copy of the masks, so split grids of the full level are kept
+	key = meshes_key;
+	key.push_back((double)masks_state.version);
+	key.push_back((double)param.blend_weights);
+	key.push_back((double)param.lod_levels);
+	if (isOutdated(lod_state, key))
+	{
+		int res = runStage("Levels of detail", -1, [&]() {
+			Masks lod_masks = masks;
+			int ret = 0;
+			for (uint level = 1U; (level <= (uint)param.lod_levels) && (ret == 0); level++)
+			{
+				char path[20];
+				sprintf(path, "./lod%d", level);
+				struct stat st;
+				if ((stat(path, &st) != 0) && (mkdir(path, 0700) != 0)) // Create 'path' path if doesn't exist
+				{
+					cout << "mkdir: cannot create directory " << path << endl;
+					return (-1);
+				}
+
+				vector< vector<float> > lod_meshes(grids.size());
+				for (uint i = 0U; i < grids.size(); i++) { grids[i].createLodMesh(cameras[i], level, lod_meshes[i]); }
+				ret |= lod_masks.splitGrids(lod_meshes, param.blend_weights);
+				for (uint i = 0U; (i < grids.size()) && (ret == 0); i++)
+				{
+					char file_name[50];
+					sprintf(file_name, "%s/array%d1", path, i + 1U);
+					ret |= saveMesh(file_name, lod_masks.getSplitGrid(i, true));
+					sprintf(file_name, "%s/array%d2", path, i + 1U);
+					ret |= saveMesh(file_name, lod_masks.getSplitGrid(i, false));
+					sprintf(file_name, "%s/array%d3", path, i + 1U);
+					if (param.blend_weights) { ret |= saveMesh(file_name, lod_masks.getWeightedGrid(i), 6U); }
+					else { remove(file_name); } // Renderer must not pick up outdated weights
+				}
+			}
+
+			// Renderer must not pick up outdated levels
+			for (uint level = (uint)param.lod_levels + 1U; level <= LOD_MAX; level++)
+			{
+				char file_name[50];
+				for (uint i = 0U; i < CAMERA_MAX; i++)
+				{
+					for (uint j = 1U; j <= 3U; j++)
+					{
+						sprintf(file_name, "./lod%d/array%d%d", level, i + 1U, j);
+						remove(file_name);
+					}
+				}
+				sprintf(file_name, "./lod%d", level);
+				rmdir(file_name);
+			}
+			return (ret);
+		});
+		if (res != 0) {
+			cout << "ERROR: Levels of detail have not been saved" << endl;
+		}
+		status |= res;
+		setArtefact(lod_state, key, (res == 0));
+	}
+	return ((status == 0) ? 0 : -1);
+}
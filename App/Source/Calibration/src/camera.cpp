@@ -34,17 +34,22 @@
  * @param  in 		char *filename - *.txt file with polynomial camera model from Scaramuzza toolbox for Matlab
  * 		   in		float sf - scale factor
  * 		   in 	 	int index - camera index
+ * 		   in		float yaw - camera yaw (degrees)
+ * 		   in		int previous_camera - index of the previous camera in the ring
+ * 		   in		int next_camera - index of the next camera in the ring
+ * 		   in		int num - number of cameras
  *
  * @return 			Functions returns Camera* object if the camera model has been loaded successfully. A return
  * 					value of NULL indicates an error.
- * 					The public properties of Camera object are set: sf, index.
+ * 					The public properties of Camera object are set: sf, index and the placement in the cameras
+ * 					ring (see setPlacement).
  * 					The roi value is set on default value - 50%.
  *
  * @remarks 		The class creator reads polynomial camera model from filename file. If any problems were
  * 					to occur then creator return NULL. Otherwise it returns the pointer to Camera object.
  *
  **************************************************************************************************************/
-Camera* Creator::create(const char *filename, float sf, int index)
+Camera* Creator::create(const char *filename, float sf, int index, float yaw, int previous_camera, int next_camera, int num)
 {
 	Camera* mp = new Camera;
 	if((mp->model).loadModel(filename) == -1) { // Read polynomial camera model from filename file
@@ -53,6 +58,7 @@ Camera* Creator::create(const char *filename, float sf, int index)
 	}
 	mp->sf = sf;
 	mp->index = index;
+	mp->setPlacement(yaw, previous_camera, next_camera, num);
 	mp->setRoi(50); // Default value is 50%
 	
 	(mp->model).createLUT(mp->xmap, mp->ymap, sf); // create LUT table
@@ -60,6 +66,34 @@ Camera* Creator::create(const char *filename, float sf, int index)
 	return(mp);
 }
 
+/**************************************************************************************************************
+ *
+ * @brief  			Set camera placement in the cameras ring.
+ *
+ * @param  in 		float yaw_angle - camera yaw (degrees)
+ * 		   in		int previous_camera - index of the previous camera in the ring
+ * 		   in		int next_camera - index of the next camera in the ring
+ * 		   in		int num - number of cameras
+ *
+ * @return 			-
+ *
+ * @remarks 		The function sets camera yaw which is used to rotate the camera grid, ring neighbors which
+ * 					share seams with the camera and the debug tile where the camera image is drawn. Tiles are
+ * 					arranged in ceil(sqrt(num)) columns.
+ *
+ **************************************************************************************************************/
+void Camera::setPlacement(float yaw_angle, int previous_camera, int next_camera, int num)
+{
+	int cols = 1;
+	while (cols * cols < num) { cols++; }
+
+	yaw = yaw_angle;
+	previous = previous_camera;
+	next = next_camera;
+	tile_size = 2.0f / (float)cols;
+	tile = Point2f(-1.0f + (float)(index % cols) * tile_size, 1.0f - (float)(index / cols) * tile_size);
+}
+
 /**************************************************************************************************************
  *
  * @brief  			Update LUTs for removing defisheye distortion.
@@ -196,6 +230,7 @@ int Camera::setIntrinsic(const char *filepath, const char *filename, int img_num
 	{
 		param.K = initCameraMatrix2D(object_points, image_points, Size(1920, 1280), 0.0);
 		param.distCoeffs = Mat(4, 1, CV_32F, Scalar(0));
+		updateProjection();
 		cout << "K: \n" << param.K << endl;
 	}
 	else
@@ -270,6 +305,7 @@ int Camera::setExtrinsic(const Mat &img)
 	if(!solvePnP(matObjPoints, matImgPoints, param.K, param.distCoeffs, param.rvec, param.tvec)) {
 		return(-1);
 	}
+	updateProjection();
 
 
 #if 0
@@ -325,16 +361,12 @@ int Camera::getBowlHeight(double radius, double step_x)
 	// Get 3D points projection into 2D image for bowl side with x = 0 (z = (y - radius)^2)
 	while((next_point) && (num < 100))
 	{
-		vector<Point3f> p3d;
-		vector<Point2f> p2d;
-
 		double new_point = (double)num * step_x;
-		p3d.push_back(Point3f(0, - radius - new_point, - new_point * new_point)); // Get num point for 3D template
-		projectPoints(p3d, param.rvec, param.tvec, param.K, param.distCoeffs, p2d); // Project the point into 2D image
+		Point2f p2d = project(Point3f(0, - radius - new_point, - new_point * new_point)); // Project num point of 3D template into 2D image
 
-		if((p2d[0].y >= 0.0) && (p2d[0].y < (float)transform_mask.rows) && (p2d[0].x >= 0.0) && (p2d[0].x < (float)transform_mask.cols))
+		if((p2d.y >= 0.0) && (p2d.y < (float)transform_mask.rows) && (p2d.x >= 0.0) && (p2d.x < (float)transform_mask.cols))
 		{
-			if((transform_mask.data != NULL) && (transform_mask.at<uchar>((int)round(p2d[0].y), (int)round(p2d[0].x)) != 255U))
+			if((transform_mask.data != NULL) && (transform_mask.at<uchar>((int)round(p2d.y), (int)round(p2d.x)) != 255U))
 			{
 				next_point = false;
 			}
@@ -345,6 +377,43 @@ int Camera::getBowlHeight(double radius, double step_x)
 	return(MAX(0, (num - 2)));
 }
 
+/**************************************************************************************************************
+ *
+ * @brief  			Update cached projection parameters.
+ *
+ * @param  			-
+ *
+ * @return 			-
+ *
+ * @remarks			The function recalculates rotation matrix R, K * R and K * tvec from param.K, param.rvec
+ * 					and param.tvec. It must be called every time when camera parameters have been changed.
+ *
+ **************************************************************************************************************/
+void Camera::updateProjection(void)
+{
+	if (param.K.empty()) {
+		return;
+	}
+
+	Matx33d K = (Matx33d)param.K;
+
+	if (param.rvec.empty() || param.tvec.empty()) {
+		param.R = Matx33d::eye();
+		param.KR = K;
+		param.Kt = Vec3d(0.0, 0.0, 0.0);
+		return;
+	}
+
+	Mat R;
+	Rodrigues(param.rvec, R);
+	param.R = (Matx33d)R;
+
+	Vec3d t = (Vec3d)param.tvec.reshape(1, 3);
+
+	param.KR = K * param.R;
+	param.Kt = K * t;
+}
+
 /**************************************************************************************************************
  *
  * @brief  			Search pattern points in captured image from the camera.
@@ -371,15 +440,12 @@ int Camera::getImagePoints(Mat &undist_img, uint num, vector<Point2f> &img_point
 	Mat temp;
 	undist_img_gray(Rect(0, static_cast<int>((float)undist_img_gray.rows * (1.0f - roi)) - 10, undist_img_gray.cols, static_cast<int>((float)undist_img_gray.rows * roi))).copyTo(temp); // Get roi
 
-	Ptr<CvMemStorage> mem_storage;
-	mem_storage = cvCreateMemStorage(0);
-	CvSeq * root = cvCreateSeq( 0, sizeof(CvSeq), sizeof(CvSeq*), mem_storage );
-
-	int contours_num =  GetContours(temp, &root, mem_storage, cntr_min_size); // Get contours
+	ContourQuads quads;
+	int contours_num =  GetContours(temp, quads, contour_buf, cntr_min_size); // Get contours
 
 	// If number of contours not equal to CONTOURS_NUM, then complete the calibration process
 	if(contours_num < CONTOURS_NUM) {
-		sec2vector(&root, img_points, Point2f(0.0f, ((float)undist_img.rows * (1.0f - roi)) - 10.0f));
+		sec2vector(quads, img_points, Point2f(0.0f, ((float)undist_img.rows * (1.0f - roi)) - 10.0f));
 		if(contours_num == 0) {
 			cout << "Camera " << index << ". No contours were found. Change the calibration image" << endl;
 			return(-1);
@@ -389,17 +455,17 @@ int Camera::getImagePoints(Mat &undist_img, uint num, vector<Point2f> &img_point
 	}
 	else {
 		if(contours_num > CONTOURS_NUM) {
-		sec2vector(&root, img_points, Point2f(0.0f, ((float)undist_img.rows * (1.0f - roi)) - 10.0f));
+		sec2vector(quads, img_points, Point2f(0.0f, ((float)undist_img.rows * (1.0f - roi)) - 10.0f));
 			cout << "Camera " << index << ". The number of contours is bigger than 4. Change the calibration image" << endl;
 			return(-1);
 		}
 	}
 	/**************************************** 2. Contour sorting  ********************************************/
-	SortContours(&root); // Sort contours from left to right
+	SortContours(quads); // Sort contours from left to right
 
 	/************************************** 3. Get contours points *******************************************/
 	Point2f shift = Point2f(0.0f, ((float)undist_img.rows * (1.0f - roi)) - 10.0f);
-	GetFeaturePoints(&root, img_points, shift); // Sort contour points clockwise (start from the top left point)
+	GetFeaturePoints(quads, img_points, shift); // Sort contour points clockwise (start from the top left point)
 
 	for(int i = 0; i < (int)img_points.size() - 1; i++) {
 		line(undist_img, img_points[i], img_points[i+1], cvScalar(255.0, 0.0, 0.0), 1, CV_AA, 0); // Draw contours
@@ -429,10 +495,10 @@ int Camera::getImagePoints(Mat &undist_img, uint num, vector<Point2f> &img_point
  **************************************************************************************************************/	
 int Camera::getContours(float** lines)
 {
-	Point2f top = Point2f((static_cast<float>(index & 1U) - 1.0f), static_cast<float>((~index >> 1U) & 1U));
+	Point2f top = tile;
 		
-	float x_norm = 1.0f / (float)xmap.cols;
-	float y_norm = 1.0f / (float)xmap.rows;
+	float x_norm = tile_size / (float)xmap.cols;
+	float y_norm = tile_size / (float)xmap.rows;
 		
 	(*lines) = (float*)malloc(3 * 2 * img_p.size() * sizeof(float));
 	if ((*lines) == NULL) {
@@ -88,66 +88,180 @@ int Defisheye::loadModel(string filename)
 
 void Defisheye::createLUT(Mat &mapx, Mat &mapy, float sf)
 {
-	Point3d p3D; // X, Y, Z
-
 	mapx.create(model.img_size.height, model.img_size.width, CV_32FC1);
 	mapy.create(model.img_size.height, model.img_size.width, CV_32FC1);
 	
 	float xc_norm = (float)model.img_size.width / 2.0f;
 	float yc_norm = (float)model.img_size.height / 2.0f;
-	p3D.z = (double)(-model.img_size.width) / sf;  // Z
-    
-	for (int col = 0; col < model.img_size.width; col++) {
-		for (int row = 0; row < model.img_size.height; row++)
-		{   
-			p3D.x = (double)row - (double)yc_norm; // X
-			p3D.y = (double)col - (double)xc_norm; // Y
-			
-			// norm = sqrt(X^2 + Y^2)
-			double norm = sqrt(p3D.x * p3D.x + p3D.y * p3D.y);
-			if (norm == 0.0)
+	double z = (double)(-model.img_size.width) / sf;  // Z
+
+	// The LUT defines grids, masks and exposure correction of every camera, so it is built with the double model.
+	// Rows are independent and are processed in parallel.
+	parallel_for_(Range(0, model.img_size.height), [&](const Range &range)
+	{
+		for (int row = range.start; row < range.end; row++)
+		{
+			float* mx = mapx.ptr<float>(row);
+			float* my = mapy.ptr<float>(row);
+			for (int col = 0; col < model.img_size.width; col++)
 			{
-				mapx.at<float>(row, col) = (float) model.center.y;
-				mapy.at<float>(row, col) = (float) model.center.x;	
-				continue;
-			}
-						
-			// t = atan(Z/sqrt(X^2 + Y^2)) 
-			double t = atan(p3D.z / norm);
-			
-			// r = a0 + a1 * t + a2 * t^2 + a3 * t^3 + ...
-			double t_pow = t;
-			double r = model.invpol[0];
-			
-			for (uint i = 1; i < model.invpol.size(); i++)
-			{				
-				r += t_pow * model.invpol[i];
-				t_pow *= t;
+				double x = (double)row - (double)yc_norm; // X
+				double y = (double)col - (double)xc_norm; // Y
+
+				// norm = sqrt(X^2 + Y^2)
+				double norm = sqrt(x * x + y * y);
+				if (norm == 0.0)
+				{
+					mx[col] = (float)model.center.y;
+					my[col] = (float)model.center.x;
+					continue;
+				}
+
+				// t = atan(Z/sqrt(X^2 + Y^2))
+				double t = atan(z / norm);
+
+				// r = a0 + a1 * t + a2 * t^2 + a3 * t^3 + ...
+				double t_pow = t;
+				double r = model.invpol[0];
+				for (uint i = 1; i < model.invpol.size(); i++)
+				{
+					r += t_pow * model.invpol[i];
+					t_pow *= t;
+				}
+
+				/* | u | = r * | X | / sqrt(X^2 + Y^2);
+				   | v |       | Y |                     */
+				double u = r * x / norm;
+				double v = r * y / norm;
+
+				/* | x | = | sx  shy | * | u | + | xc |
+				   | y |   | shx  1  |   | v |   | yc |     */
+				my[col] = (float)((model.affine(0, 0) * u + model.affine(0, 1) * v + model.center.x));
+				mx[col] = (float)((model.affine(1, 0) * u + model.affine(1, 1) * v + model.center.y));
 			}
-			
-			/* | u | = r * | X | / sqrt(X^2 + Y^2);
-			   | v |       | Y |                     */
-			double u = r * p3D.x / norm;
-			double v = r * p3D.y / norm;
-			
-			/* | x | = | sx  shy | * | u | + | xc |
-			   | y |   | shx  1  |   | v |   | yc |     */
-			mapy.at<float>(row, col) = (float)((model.affine(0, 0) * u + model.affine(0, 1) * v + model.center.x));
-			mapx.at<float>(row, col) = (float)((model.affine(1, 0) * u + model.affine(1, 1) * v + model.center.y));
 		}
-	}
+	});
 }
 
 
+/**************************************************************************************************************
+ *
+ * @brief  			Back-project fisheye pixels to unit rays (bulk forward model).
+ *
+ * @param  in		const Point2f* p2d - fisheye pixels (x - row, y - column as in cam2world)
+ * 		   out		Point3f* p3d - unit rays in camera coordinates
+ * 		   in		int num - number of points
+ *
+ * @return 			-
+ *
+ * @remarks 		The function is a float equivalent of cam2world for a span of points. Points are processed in
+ * 					blocks of LENS_BLOCK. The polynomial is evaluated in Horner form with the coefficient loop outside
+ * 					of the point loop, so the point loop has no loop-carried dependency and is vectorized.
+ *
+ **************************************************************************************************************/
+void Defisheye::cam2world(const Point2f* p2d, Point3f* p3d, int num) const
+{
+	if (model.pol.empty()) { return; }
 
+	float invdet = (float)(1.0 / (model.affine(0, 0) - model.affine(0, 1) * model.affine(1, 0)));
+	float c = (float)model.affine(0, 0), d = (float)model.affine(0, 1), e = (float)model.affine(1, 0);
+	float xc = (float)model.center.x, yc = (float)model.center.y;
+	vector<float> pol(model.pol.begin(), model.pol.end());
+	int deg = (int)pol.size() - 1;
 
+	float xp[LENS_BLOCK], yp[LENS_BLOCK], r[LENS_BLOCK], zp[LENS_BLOCK];
+	for (int start = 0; start < num; start += LENS_BLOCK)
+	{
+		int n = MIN(LENS_BLOCK, num - start);
+		const Point2f* in = p2d + start;
+		Point3f* out = p3d + start;
+
+		for (int i = 0; i < n; i++)
+		{
+			float dx = in[i].x - xc;
+			float dy = in[i].y - yc;
+			xp[i] = invdet * (dx - d * dy);
+			yp[i] = invdet * (-e * dx + c * dy);
+			r[i] = sqrtf(xp[i] * xp[i] + yp[i] * yp[i]);
+			zp[i] = pol[deg];
+		}
+
+		// zp = a0 + r * (a1 + r * (a2 + ...))
+		for (int k = deg - 1; k >= 0; k--)
+		{
+			float a = pol[k];
+			for (int i = 0; i < n; i++) {
+				zp[i] = zp[i] * r[i] + a;
+			}
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			float invnorm = 1.0f / sqrtf(xp[i] * xp[i] + yp[i] * yp[i] + zp[i] * zp[i]);
+			out[i] = Point3f(xp[i] * invnorm, yp[i] * invnorm, zp[i] * invnorm);
+		}
+	}
+}
 
 
+/**************************************************************************************************************
+ *
+ * @brief  			Project camera coordinates to fisheye pixels (bulk inverse model).
+ *
+ * @param  in		const Point3f* p3d - points in camera coordinates (z < 0 in front of the camera)
+ * 		   out		Point2f* p2d - fisheye pixels (x - row, y - column as in cam2world)
+ * 		   in		int num - number of points
+ *
+ * @return 			-
+ *
+ * @remarks 		The function evaluates the inverse polynomial r(t), t = atan(z / sqrt(x^2 + y^2)), in Horner form
+ * 					for blocks of LENS_BLOCK points and applies the affine transformation. Points on the optical axis
+ * 					are projected to the image center.
+ *
+ **************************************************************************************************************/
+void Defisheye::world2cam(const Point3f* p3d, Point2f* p2d, int num) const
+{
+	if (model.invpol.empty()) { return; }
 
+	float c = (float)model.affine(0, 0), d = (float)model.affine(0, 1), e = (float)model.affine(1, 0);
+	float xc = (float)model.center.x, yc = (float)model.center.y;
+	vector<float> invpol(model.invpol.begin(), model.invpol.end());
+	int deg = (int)invpol.size() - 1;
 
+	float t[LENS_BLOCK], r[LENS_BLOCK], norm[LENS_BLOCK];
+	for (int start = 0; start < num; start += LENS_BLOCK)
+	{
+		int n = MIN(LENS_BLOCK, num - start);
+		const Point3f* in = p3d + start;
+		Point2f* out = p2d + start;
 
+		for (int i = 0; i < n; i++)
+		{
+			norm[i] = sqrtf(in[i].x * in[i].x + in[i].y * in[i].y);
+			t[i] = atanf(in[i].z / MAX(norm[i], FLT_MIN));
+			r[i] = invpol[deg];
+		}
 
+		// r = a0 + t * (a1 + t * (a2 + ...))
+		for (int k = deg - 1; k >= 0; k--)
+		{
+			float a = invpol[k];
+			for (int i = 0; i < n; i++) {
+				r[i] = r[i] * t[i] + a;
+			}
+		}
 
+		/* | x | = | sx  shy | * | u | + | xc |,  | u | = r * | X | / sqrt(X^2 + Y^2)
+		   | y |   | shx  1  |   | v |   | yc |   | v |       | Y |                     */
+		for (int i = 0; i < n; i++)
+		{
+			float k = (norm[i] > 0.0f) ? r[i] / norm[i] : 0.0f;
+			float u = k * in[i].x;
+			float v = k * in[i].y;
+			out[i] = Point2f(c * u + d * v + xc, e * u + v + yc);
+		}
+	}
+}
 
 
 void Defisheye::cam2world(Point3d* p3d, Point2d p2d)
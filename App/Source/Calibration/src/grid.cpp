@@ -24,21 +24,140 @@
 
 #include "grid.hpp"
 
-float lerp(float v0, float v1, float t)
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate fisheye texels of 2D grid points
+ *
+ * @param  in		const Mat &xmap - X map of the defisheye transformation (CV_32FC1)
+ * 		   in		const Mat &ymap - Y map of the defisheye transformation (CV_32FC1)
+ * 		   in		const vector<Point2f> &p2d - 2D grid points (defisheye image points)
+ * 		   out		vector<Point2f> &texels - normalized fisheye texels of the grid points
+ *
+ * @return 			-
+ *
+ * @remarks 		The function bilinearly samples xmap and ymap once for every grid point and normalizes the
+ * 					result by the map size. Neighbor indexes are clamped to the map border. Points which lie
+ * 					outside the map get the (-1, -1) texel. Points are processed in parallel.
+ *
+ **************************************************************************************************************/
+void getTexels(const Mat &xmap, const Mat &ymap, const vector<Point2f> &p2d, vector<Point2f> &texels)
 {
-	return (1.0f - t) * v0 + t * v1;
+	float height = (float)xmap.rows;
+	float width = (float)xmap.cols;
+	texels.resize(p2d.size());
+
+	parallel_for_(Range(0, (int)p2d.size()), [&](const Range &range) {
+		for (int i = range.start; i < range.end; i++)
+		{
+			Point2f p = p2d[i];
+			if ((round(p.x) >= width) || (round(p.y) >= height) || !(p.x >= 0.0f) || !(p.y >= 0.0f)) {
+				texels[i] = Point2f(-1.0f, -1.0f);
+				continue;
+			}
+
+			int x0 = (int)p.x;
+			int y0 = (int)p.y;
+			int x1 = MIN(x0 + 1, xmap.cols - 1);
+			int y1 = MIN(y0 + 1, xmap.rows - 1);
+			float tx = p.x - (float)x0;
+			float ty = p.y - (float)y0;
+
+			const float* mx0 = xmap.ptr<float>(y0);
+			const float* mx1 = xmap.ptr<float>(y1);
+			const float* my0 = ymap.ptr<float>(y0);
+			const float* my1 = ymap.ptr<float>(y1);
+
+			float u0 = mx0[x0] + (mx0[x1] - mx0[x0]) * tx;
+			float u1 = mx1[x0] + (mx1[x1] - mx1[x0]) * tx;
+			float v0 = my0[x0] + (my0[x1] - my0[x0]) * tx;
+			float v1 = my1[x0] + (my1[x1] - my1[x0]) * tx;
+
+			texels[i] = Point2f((u0 + (u1 - u0) * ty) / width, (v0 + (v1 - v0) * ty) / height);
+		}
+	});
 }
 
-float getMapAt(Mat map, Point2f coord)
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate fisheye texels of 2D grid points analytically
+ *
+ * @param  in		const Defisheye &model - polynomial camera model
+ * 		   in		float sf - scale factor of the defisheye image
+ * 		   in		const vector<Point2f> &p2d - 2D grid points (defisheye image points)
+ * 		   out		vector<Point2f> &texels - normalized fisheye texels of the grid points
+ *
+ * @return 			-
+ *
+ * @remarks 		Every defisheye image point is lifted to the plane z = -width / sf of the camera frame, as in
+ * 					Defisheye::createLUT, and projected with the inverse polynomial model (Defisheye::world2cam).
+ * 					The result does not depend on xmap/ymap resolution, so texel precision is independent of sf.
+ * 					Points which lie outside the defisheye image get the (-1, -1) texel as in the xmap/ymap version.
+ * 					Points are processed in parallel.
+ *
+ **************************************************************************************************************/
+void getTexels(const Defisheye &model, float sf, const vector<Point2f> &p2d, vector<Point2f> &texels)
+{
+	float height = (float)model.model.img_size.height;
+	float width = (float)model.model.img_size.width;
+	float z = -width / sf;
+	texels.resize(p2d.size());
+
+	parallel_for_(Range(0, (int)p2d.size()), [&](const Range &range) {
+		vector<Point3f> p3d(range.end - range.start);
+		vector<Point2f> fisheye(range.end - range.start);
+		for (int i = range.start; i < range.end; i++) {
+			p3d[i - range.start] = Point3f(p2d[i].y - height / 2.0f, p2d[i].x - width / 2.0f, z); // X - row, Y - column
+		}
+		model.world2cam(p3d.data(), fisheye.data(), (int)p3d.size());
+
+		for (int i = range.start; i < range.end; i++)
+		{
+			Point2f p = p2d[i];
+			if ((round(p.x) >= width) || (round(p.y) >= height) || !(p.x >= 0.0f) || !(p.y >= 0.0f)) {
+				texels[i] = Point2f(-1.0f, -1.0f);
+				continue;
+			}
+			const Point2f &q = fisheye[i - range.start]; // x - row, y - column
+			texels[i] = Point2f(q.y / width, q.x / height);
+		}
+	});
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Save triangles to a file.
+ *
+ * @param  in		const char* file_name - output file name
+ * 		   in		const vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex
+ * 		   in		uint stride - number of floats per vertex. Vertices of weighted overlap grids have the 6th
+ * 		   			float which is the blend weight.
+ *
+ * @return 			Functions returns 0 if the file has been saved. A return value of -1 indicates an error.
+ *
+ * @remarks 		The function writes one vertex per line in the text format of the arrayX files.
+ *
+ **************************************************************************************************************/
+int saveMesh(const char* file_name, const vector<float> &mesh, uint stride)
 {
-	Point ind((int)coord.x, (int)coord.y);
-	Point2f t = coord - Point2f(ind.x, ind.y);
+	ofstream outC; // Output file
+	outC.open(file_name, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
+	if (!outC.is_open())
+	{
+		cout << "File " << file_name << " cannot be opened" << endl;
+		return(-1);
+	}
 
-	float v0 = lerp(map.at<float>(ind), map.at<float>(ind + Point(1, 0)), t.x);
-	float v1 = lerp(map.at<float>(ind + Point(0, 1)), map.at<float>(ind + Point(1, 1)), t.x);
-	float v = lerp(v0, v1, t.y);
+	for (size_t i = 0; i + stride <= mesh.size(); i += stride)
+	{
+		outC << mesh[i];
+		for (uint j = 1; j < stride; j++) {
+			outC << " " << mesh[i + j];
+		}
+		outC << "\n";
+	}
 
-	return v;
+	outC.close(); // Close file
+	return(0);
 }
 
 /**************************************************************************************************************
@@ -67,6 +186,7 @@ CurvilinearGrid::CurvilinearGrid(uint angles, uint start_angle, uint nop_z, doub
 	cam_info.height = 0;
 	cam_info.width = 0;
 	cam_info.index = -1;
+	cam_info.tile_size = 1.0f;
 	NoP = 0;
 }
 
@@ -88,6 +208,8 @@ void CurvilinearGrid::createGrid(Camera *camera, double radius)
 	cam_info.height = camera->xmap.rows;
 	cam_info.width = camera->xmap.cols;
 	cam_info.index = camera->index;
+	cam_info.tile = camera->tile;
+	cam_info.tile_size = camera->tile_size;
 		
 	p3d.clear();
 	p2d.clear();
@@ -100,33 +222,45 @@ void CurvilinearGrid::createGrid(Camera *camera, double radius)
 		
 	int pnum = static_cast<int>(radius / parameters.step_x);	// Number of grid rows of flat bowl bottom
 	int startpnum = static_cast<int>((float)camera->tmp.ref_points[0].y / (float)camera->tmp.ref_points[0].x / (float)parameters.step_x / 3.0f);	// The first row of grid
+	startpnum = MIN(startpnum, pnum);
 	NoP = 2 * ((pnum - startpnum) + (int)parameters.nop_z); // Number of grid points for one grid sector (angle)
 
-	for(uint ang = parameters.start_angle + 1U; ang <= (uint)(parameters.angles - parameters.start_angle); ang++)
-	{
-		double angle_start = (double)((double)ang - 1.0) * (M_PI / (double)parameters.angles); // Start angle of the current circular sector
-		double angle_end = (double)ang * (M_PI / (double)parameters.angles); // End angle of the current circular sector
+	int sectors = (int)parameters.angles - 2 * (int)parameters.start_angle; // Number of circular sectors
+	if (sectors <= 0) { return; }
+	p3d.resize((size_t)sectors * (size_t)NoP);
+	p2d.resize(p3d.size());
 
-		// Flat bottom points
-		for(int i = startpnum; i < pnum; i++)
+	// Sectors are independent, so each sector is generated and projected in parallel
+	parallel_for_(Range(0, sectors), [&](const Range &range) {
+		for(int sector = range.start; sector < range.end; sector++)
 		{
-			double hptn = (double)i * parameters.step_x;
-			p3d.push_back(Point3f(hptn * cos(angle_end), - hptn * sin(angle_end), 0.0));
-			p3d.push_back(Point3f(hptn * cos(angle_start), - hptn * sin(angle_start), 0.0));
-		}
+			uint ang = parameters.start_angle + 1U + (uint)sector;
+			double angle_start = (double)((double)ang - 1.0) * (M_PI / (double)parameters.angles); // Start angle of the current circular sector
+			double angle_end = (double)ang * (M_PI / (double)parameters.angles); // End angle of the current circular sector
+			int p = sector * NoP; // First point of the sector
 
-		// Points on bowl side
-		for(uint i = 1; i <= parameters.nop_z; i++)
-		{
-			double hptn = radius + (double)i * parameters.step_x;
-			p3d.push_back(Point3f(hptn * cos(angle_end), - hptn * sin(angle_end), - pow((double)i * parameters.step_x, 2)));
-			p3d.push_back(Point3f(hptn * cos(angle_start), - hptn * sin(angle_start), - pow((double)i * parameters.step_x, 2)));
-		}
-	}
+			// Flat bottom points
+			for(int i = startpnum; i < pnum; i++)
+			{
+				double hptn = (double)i * parameters.step_x;
+				p3d[p++] = Point3f(hptn * cos(angle_end), - hptn * sin(angle_end), 0.0);
+				p3d[p++] = Point3f(hptn * cos(angle_start), - hptn * sin(angle_start), 0.0);
+			}
 
-	
-	// Projects 3D points to an image plane
-	projectPoints(p3d, camera->getRvec(), camera->getTvec(), camera->getK(), camera->getDistCoeffs(), p2d);
+			// Points on bowl side
+			for(uint i = 1; i <= parameters.nop_z; i++)
+			{
+				double hptn = radius + (double)i * parameters.step_x;
+				p3d[p++] = Point3f(hptn * cos(angle_end), - hptn * sin(angle_end), - pow((double)i * parameters.step_x, 2));
+				p3d[p++] = Point3f(hptn * cos(angle_start), - hptn * sin(angle_start), - pow((double)i * parameters.step_x, 2));
+			}
+
+			// Projects 3D points of the sector to an image plane
+			for(p = sector * NoP; p < (sector + 1) * NoP; p++) {
+				p2d[p] = camera->project(p3d[p]);
+			}
+		}
+	});
 
 	// Reorganize grid to clean middle part of view
 	reorgGrid(radius, camera);
@@ -147,10 +281,10 @@ int CurvilinearGrid::getGrid(float** points)
 	
 	if (p2d.size() == 0) { return (0); }
 	
-	Point2f top = Point2f((static_cast<float>(cam_info.index & 1U) - 1.0f), static_cast<float>((~cam_info.index >> 1U) & 1U));
+	Point2f top = cam_info.tile;
 		
-	float x_norm = 1.0f / (float)cam_info.width;
-	float y_norm = 1.0f / (float)cam_info.height;
+	float x_norm = cam_info.tile_size / (float)cam_info.width;
+	float y_norm = cam_info.tile_size / (float)cam_info.height;
 		
 	(*points) = (float*)malloc(6 * p2d.size() * sizeof(float));
 	if ((*points) == NULL) {
@@ -216,8 +350,7 @@ void CurvilinearGrid::reorgGrid(double radius, Camera* camera)
 {
 	double grid_step = radius / 4.0;
 
-	vector<Point3f> point_3d; // 3D coordinates of the closest point for the camera
-	point_3d.push_back(Point3f(0.0, (float)(-grid_step), 0.0)); // Start value
+	Point3f point_3d = Point3f(0.0, (float)(-grid_step), 0.0); // 3D coordinates of the closest point for the camera
 
 	Mat distortion_mask(camera->xmap.rows, camera->xmap.cols, CV_8U, Scalar(255, 255, 255)); // Mask for defisheye image
 	camera->defisheye(distortion_mask, distortion_mask);
@@ -225,38 +358,33 @@ void CurvilinearGrid::reorgGrid(double radius, Camera* camera)
 	// Get closest point for the camera which exists on camera frame
 	for(int i = 0; i < 10; i ++) // 10 iteration is enough
 	{
-		vector<Point2f> point_2d; // 2D coordinates of the closest point for the camera on defisheye image
-		projectPoints(point_3d, camera->getRvec(), camera->getTvec(), camera->getK(), camera->getDistCoeffs(), point_2d);
+		Point2f point_2d = camera->project(point_3d); // 2D coordinates of the closest point for the camera on defisheye image
 		grid_step = grid_step / 2.0; // Increase step
-		if( (point_2d[0].x < (float)distortion_mask.cols) && (point_2d[0].y < (float)distortion_mask.rows) &&
-			(point_2d[0].x >= 0.0) && (point_2d[0].y >= 0.0))
+		if( (point_2d.x < (float)distortion_mask.cols) && (point_2d.y < (float)distortion_mask.rows) &&
+			(point_2d.x >= 0.0) && (point_2d.y >= 0.0))
 		{
-			if(distortion_mask.at<uchar>(point_2d[0]) == 0U) // Check mask value
+			if(distortion_mask.at<uchar>(point_2d) == 0U) // Check mask value
 			{
-				point_3d[0].y -= grid_step; // Go down
+				point_3d.y -= grid_step; // Go down
 			}
 			else
 			{
-				point_3d[0].y += grid_step; // Go up
+				point_3d.y += grid_step; // Go up
 			}
 		}
 		else
 		{
-			point_3d[0].y -= grid_step; // Go down
+			point_3d.y -= grid_step; // Go down
 		}
 	}
 
 	// Recalculate 3D and 2D grid points
 	for(uint i = 0; i < p3d.size(); i ++) // Check all grid points
 	{
-		if(p3d[i].y > point_3d[0].y) // If grid point is lays in masking region
+		if(p3d[i].y > point_3d.y) // If grid point is lays in masking region
 		{
-			vector<Point2f> p2tmp;
-			vector<Point3f> p3tmp;
-			p3d[i].y = point_3d[0].y; // New value of 3D point
-			p3tmp.push_back(p3d[i]);
-			projectPoints(p3tmp, camera->getRvec(), camera->getTvec(), camera->getK(), camera->getDistCoeffs(), p2tmp);
-			p2d[i] = p2tmp[0]; // New value of 2D point
+			p3d[i].y = point_3d.y; // New value of 3D point
+			p2d[i] = camera->project(p3d[i]); // New value of 2D point
 		}
 	}
 }
@@ -453,85 +581,56 @@ void CurvilinearGrid::findSeam(Camera* camera, vector<Point3f> &seam_points)
 
 /**************************************************************************************************************
  *
- * @brief  			Generate triangles from a 3D grid and save them to a file.
+ * @brief  			Generate triangles from a 3D grid.
  *
  * @param  in		Camera* camera - pointer to the Camera object
+ * 		   out		vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex, 3 vertices per triangle
+ * 		   in		bool analytic - if true then texels are calculated with the polynomial camera model (see getTexels)
+ * 		   			instead of sampling xmap/ymap
  *
  * @return 			-
  *
- * @remarks 		The file with triangles description has been saved to the file arrayX, where X is camera index.
- * 					The grid has been rotated according to the camera index value:
- * 						index = 0 - without rotation;
- * 						index = 1 - 90 degree clockwise rotation;
- * 						index = 2 - 180 degree clockwise rotation;
- * 						index = 3 - 270 degree clockwise rotation;
+ * @remarks 		Vertices are 3D template points and texels are normalized fisheye coordinates.
+ * 					The grid has been rotated clockwise by the camera yaw (see rotatePoint).
  *
  **************************************************************************************************************/
-void CurvilinearGrid::saveGrid(Camera* camera)
+void CurvilinearGrid::createMesh(Camera* camera, vector<float> &mesh, bool analytic)
 {
-	float height = (float)camera->xmap.rows;	// 2D grid height (texels)
-	float width = (float)camera->xmap.cols;	// 2D grid width (texels)
-
-	// Generate output array
-	char file_name[50];
-	sprintf(file_name, "./array%d", camera->index + 1);
+	// Recalculate grid points for fisheye image
+	if (analytic) { getTexels(camera->model, camera->sf, p2d, p2t); }
+	else { getTexels(camera->xmap, camera->ymap, p2d, p2t); }
 
-    ofstream outC; // Output file
-    outC.open(file_name, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
+	// Generate triangles of each sector in parallel into its own buffer
+	int sectors = (int)parameters.angles - 2 * (int)parameters.start_angle; // Number of circular sectors
+	vector< vector<float> > sector_buf(MAX(sectors, 0));
 
-    for(uint ang = 0U; ang < parameters.angles - 2U * parameters.start_angle; ang++)
-	{
-		for(int i = 0; i < NoP - 2; i+=2)
+	parallel_for_(Range(0, MAX(sectors, 0)), [&](const Range &range) {
+		for(int ang = range.start; ang < range.end; ang++)
 		{
-			int p = (int)ang * NoP + i;
+			vector<float> &buf = sector_buf[ang]; // Sector buffer
 
-		    /**************************** Get triangles for I quadrant of template **********************************
-		     *   							  p  _  p+2
-		     *   Triangles orientation: 		| /|		1st triangle (p - p+1 - p+2)
-		     *   								|/_|		2nd triangle (p+1 - p+2 - p+3)
-		     *   							 p+1    p+3
-		     *******************************************************************************************************/
-
-			if((round(p2d[p + 1].x) < width) && (round(p2d[p + 1].y) < height) && (p2d[p + 1].x >= 0.0) && (p2d[p + 1].y >= 0.0) &&
-			   (round(p2d[p + 2].x) < width) && (round(p2d[p + 2].y) < height) && (p2d[p + 2].x >= 0.0) && (p2d[p + 2].y >= 0.0))
+			for(int i = 0; i < NoP - 2; i+=2)
 			{
-				// Recalculate point for fisheye image
-				Point2f t2 = Point2f(getMapAt(camera->xmap, p2d[p + 1]) / width, getMapAt(camera->ymap, p2d[p + 1]) / height);
-				Point2f t3 = Point2f(getMapAt(camera->xmap, p2d[p + 2]) / width, getMapAt(camera->ymap, p2d[p + 2]) / height);
+				int p = ang * NoP + i;
+				const int quad[4] = {p, p + 1, p + 2, p + 3};
+				addQuad(camera, quad, buf);
+			}
+		}
+	});
+
+	// Concatenate sectors in order
+	mesh.clear();
+	for(uint ang = 0U; ang < sector_buf.size(); ang++) {
+		mesh.insert(mesh.end(), sector_buf[ang].begin(), sector_buf[ang].end());
+	}
+}
+
 
-				// Rotate grid point according to the template
-				Point3f v2 = rotatePoint(camera->index, p3d[p + 1]);
-				Point3f v3 = rotatePoint(camera->index, p3d[p + 2]);
 
-				// 1st triangle (p - p+1 - p+2)
-				if((round(p2d[p].x) < width) && (round(p2d[p].y) < height) && (p2d[p].x >= 0.0) && (p2d[p].y >= 0.0))
-				{
-					Point3f v1 = rotatePoint(camera->index, p3d[p]);
-					Point2f t1 = Point2f(getMapAt(camera->xmap, p2d[p]) / width, getMapAt(camera->ymap, p2d[p]) / height);
 
-					// Save triangle points to the output file
-					outC << v1.x << " " << v1.y << " " << v1.z << " " << t1.x << " " << t1.y << endl;
-					outC << v2.x << " " << v2.y << " " << v2.z << " " << t2.x << " " << t2.y << endl;
-					outC << v3.x << " " << v3.y << " " << v3.z << " " << t3.x << " " << t3.y << endl;
-				}
 
-				// 2nd triangle (p+1 - p+2 - p+3)
-				if((round(p2d[p + 3].x) < width) && (round(p2d[p + 3].y) < height) && (p2d[p + 3].x >= 0.0) && (p2d[p + 3].y >= 0.0))
-				{
-					Point3f v4 = rotatePoint(camera->index, p3d[p + 3]);
-					Point2f t4 = Point2f(getMapAt(camera->xmap, p2d[p + 3]) / width, getMapAt(camera->ymap, p2d[p + 3]) / height);
 
-					// Save triangle points to the output file
-					outC << v2.x << " " << v2.y << " " << v2.z << " " << t2.x << " " << t2.y << endl;
-					outC << v4.x << " " << v4.y << " " << v4.z << " " << t4.x << " " << t4.y << endl;
-					outC << v3.x << " " << v3.y << " " << v3.z << " " << t3.x << " " << t3.y << endl;
-				}
-			}
-		}
-	}
 
-	outC.close(); // Close file
-}
 
 
 
@@ -548,12 +647,113 @@ void CurvilinearGrid::saveGrid(Camera* camera)
 
 
 
+/**************************************************************************************************************
+ *
+ * @brief  			Generate triangles of a coarser level of detail from a 3D grid.
+ *
+ * @param  in		Camera* camera - pointer to the Camera object
+ * 		   in		uint level - level of detail. Level 0 is the grid of createMesh.
+ * 		   out		vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex, 3 vertices per triangle
+ *
+ * @return 			-
+ *
+ * @remarks 		The function must be called after createMesh, which calculates the grid texels.
+ * 					Every 2^level neighbor sectors are merged into one sector and every 2^level-th grid row
+ * 					is kept. The last row of the flat bottom and the last row of the bowl side are always kept,
+ * 					so the bowl keeps its outline. Triangles are written in the sectors order as in createMesh.
+ *
+ **************************************************************************************************************/
+void CurvilinearGrid::createLodMesh(Camera* camera, uint level, vector<float> &mesh)
+{
+	mesh.clear();
+	int sectors = (int)parameters.angles - 2 * (int)parameters.start_angle; // Number of circular sectors
+	if ((sectors <= 0) || (p2t.size() != p2d.size()) || (p2d.size() != (size_t)sectors * (size_t)NoP)) { return; }
 
+	int step = 1 << level;
+	int rows = NoP / 2;							// Rows of one sector
+	int flat = rows - (int)parameters.nop_z;	// Rows of flat bottom
 
+	vector<int> lod_rows;
+	for(int r = 0; r < rows; r++) {
+		if (((r % step) == 0) || (r == flat - 1) || (r == rows - 1)) { lod_rows.push_back(r); }
+	}
 
+	for(int first = 0; first < sectors; first += step)
+	{
+		int last = MIN(first + step, sectors) - 1; // Merged sectors are [first, last]
+		for(uint r = 0; r + 1 < lod_rows.size(); r++)
+		{
+			// End points of the merged sector belong to the last sector, start points belong to the first one
+			const int quad[4] = {last * NoP + 2 * lod_rows[r], first * NoP + 2 * lod_rows[r] + 1,
+								 last * NoP + 2 * lod_rows[r + 1], first * NoP + 2 * lod_rows[r + 1] + 1};
+			addQuad(camera, quad, mesh);
+		}
+	}
+}
 
+/**************************************************************************************************************
+ *
+ * @brief  			Generate triangles of a grid quad.
+ *
+ * @param  in		Camera* camera - pointer to the Camera object
+ * 		   in		const int* p - indexes of 4 grid points: end and start sector points of the first row and
+ * 		   			end and start sector points of the next row
+ * 		   out		vector<float> &buf - buffer the triangles are appended to (vx vy vz tx ty)
+ *
+ * @return 			-
+ *
+ * @remarks 		The quad is divided into 2 triangles (p0 - p1 - p2) and (p1 - p3 - p2). Triangle is skipped if
+ * 					one of its points is not defined on the camera frame.
+ *
+ **************************************************************************************************************/
+void CurvilinearGrid::addQuad(Camera* camera, const int* p, vector<float> &buf)
+{
+	float height = (float)camera->xmap.rows;	// 2D grid height (texels)
+	float width = (float)camera->xmap.cols;	// 2D grid width (texels)
 
+	/**************************** Get triangles for I quadrant of template **********************************
+	 *   							 p0  _  p2
+	 *   Triangles orientation: 		| /|		1st triangle (p0 - p1 - p2)
+	 *   								|/_|		2nd triangle (p1 - p3 - p2)
+	 *   							 p1     p3
+	 *******************************************************************************************************/
+
+	if((round(p2d[p[1]].x) < width) && (round(p2d[p[1]].y) < height) && (p2d[p[1]].x >= 0.0) && (p2d[p[1]].y >= 0.0) &&
+	   (round(p2d[p[2]].x) < width) && (round(p2d[p[2]].y) < height) && (p2d[p[2]].x >= 0.0) && (p2d[p[2]].y >= 0.0))
+	{
+		// Get fisheye texels
+		Point2f t2 = p2t[p[1]];
+		Point2f t3 = p2t[p[2]];
 
+		// Rotate grid point according to the template
+		Point3f v2 = rotatePoint(camera->yaw, p3d[p[1]]);
+		Point3f v3 = rotatePoint(camera->yaw, p3d[p[2]]);
+
+		// 1st triangle (p0 - p1 - p2)
+		if((round(p2d[p[0]].x) < width) && (round(p2d[p[0]].y) < height) && (p2d[p[0]].x >= 0.0) && (p2d[p[0]].y >= 0.0))
+		{
+			Point3f v1 = rotatePoint(camera->yaw, p3d[p[0]]);
+			Point2f t1 = p2t[p[0]];
+
+			// Save triangle points to the buffer
+			buf.insert(buf.end(), {v1.x, v1.y, v1.z, t1.x, t1.y});
+			buf.insert(buf.end(), {v2.x, v2.y, v2.z, t2.x, t2.y});
+			buf.insert(buf.end(), {v3.x, v3.y, v3.z, t3.x, t3.y});
+		}
+
+		// 2nd triangle (p1 - p3 - p2)
+		if((round(p2d[p[3]].x) < width) && (round(p2d[p[3]].y) < height) && (p2d[p[3]].x >= 0.0) && (p2d[p[3]].y >= 0.0))
+		{
+			Point3f v4 = rotatePoint(camera->yaw, p3d[p[3]]);
+			Point2f t4 = p2t[p[3]];
+
+			// Save triangle points to the buffer
+			buf.insert(buf.end(), {v2.x, v2.y, v2.z, t2.x, t2.y});
+			buf.insert(buf.end(), {v4.x, v4.y, v4.z, t4.x, t4.y});
+			buf.insert(buf.end(), {v3.x, v3.y, v3.z, t3.x, t3.y});
+		}
+	}
+}
 
 /**************************************************************************************************************
  *
@@ -583,6 +783,7 @@ RectilinearGrid::RectilinearGrid(uint angles, uint start_angle, uint nop_z, doub
 	cam_info.height = 0;
 	cam_info.width = 0;
 	cam_info.index = -1;
+	cam_info.tile_size = 1.0f;
 }
 
 /**************************************************************************************************************
@@ -603,6 +804,8 @@ void RectilinearGrid::createGrid(Camera *camera, double radius)
 	cam_info.height = camera->xmap.rows;
 	cam_info.width = camera->xmap.cols;
 	cam_info.index = camera->index;
+	cam_info.tile = camera->tile;
+	cam_info.tile_size = camera->tile_size;
 	
 	p3d.clear();
 	p2d.clear();
@@ -616,10 +819,6 @@ void RectilinearGrid::createGrid(Camera *camera, double radius)
 	
 	double step_x_2 = parameters.step_x * parameters.step_x;
 
-	for(uint i = 0U; i < 2U * (parameters.angles - parameters.start_angle); i++) {
-		NoP.push_back(0);
-	}
-
 	// X and Y coordinates for circle base
 	vector<double> xxx; // Array of x coordinates of grid (in row z = 0, y = 0)
 	vector<double> yyy; // Array of y coordinates of grid (in column z = 0, x = 0)
@@ -632,46 +831,50 @@ void RectilinearGrid::createGrid(Camera *camera, double radius)
 		yyy.push_back(-radius * sin(ang));
 	}
 
-	// For each column of grid (II quadrant)
-	for(uint j = parameters.start_angle; j < xxx.size(); j++)
+	// Columns of II quadrant go from j = start_angle to j = angles, columns of I quadrant go back from j = angles - 1
+	// to j = start_angle. Set the number of grid points in each column and the offset of its first point.
+	int half = (int)parameters.angles - (int)parameters.start_angle; // Index of the last II quadrant column
+	if (half < 0) { return; }
+	NoP.resize(2 * half + 1);
+	vector<int> col_offset(NoP.size());
+	int total = 0;
+	for(int col = 0; col < (int)NoP.size(); col++)
 	{
-		// Add points of circle base (z = 0)
-		for(uint k = parameters.start_angle; k <= j; k++) {
-			p3d.push_back(Point3f(xxx[j], yyy[k], 0));
-		}
-		// Add 3D part of grid (bowl edge)
-		for(double zz = 1.0; zz <= (double)parameters.nop_z; zz++)
-		{
-			double new_z = zz * zz * step_x_2;
-			double new_x = xxx[j] * (1.0 + sqrt(new_z) / radius);
-			double new_y = yyy[j] * (1.0 + sqrt(new_z) / radius);
-			p3d.push_back(Point3f(new_x, new_y, -new_z));
-		}
-		// Set the number of grid point in the column
-		NoP[j - parameters.start_angle] = (int)j - (int)parameters.start_angle + 1 + (int)parameters.nop_z;
+		int j = (col <= half) ? ((int)parameters.start_angle + col) : (2 * (int)parameters.angles - (int)parameters.start_angle - col);
+		NoP[col] = j - (int)parameters.start_angle + 1 + (int)parameters.nop_z;
+		col_offset[col] = total;
+		total += NoP[col];
 	}
+	p3d.resize(total);
+	p2d.resize(total);
 
-	// For each column of grid (I quadrant)
-	for(int j = (int)xxx.size() - 2; j >= (int)parameters.start_angle; j--)
-	{
-		// Add points of circle base (z = 0)
-		for(int k = (int)parameters.start_angle; k <= j; k++) {
-			p3d.push_back(Point3f(- xxx[j], yyy[k], 0));
-		}
-		// Add 3D part of grid (bowl edge)
-		for(double zz = 1.0; zz <= (double)parameters.nop_z; zz++)
+	// Columns are independent, so each column is generated and projected in parallel
+	parallel_for_(Range(0, (int)NoP.size()), [&](const Range &range) {
+		for(int col = range.start; col < range.end; col++)
 		{
-			double new_z = zz * zz * step_x_2;
-			double new_x = xxx[j] * (-1.0 - sqrt(new_z) / radius);
-			double new_y = yyy[j] * (1.0 + sqrt(new_z) / radius);
-			p3d.push_back(Point3f(new_x, new_y, -new_z));
-		}
-		// Set the number of grid point in the column
-		NoP[2 * (int)xxx.size() - j - (int)parameters.start_angle - 2] = j - (int)parameters.start_angle + 1 + (int)parameters.nop_z;
-	}
+			bool left = (col <= half); // II quadrant column
+			int j = left ? ((int)parameters.start_angle + col) : (2 * (int)parameters.angles - (int)parameters.start_angle - col);
+			int p = col_offset[col];
 
-	// Projects 3D points to an image plane
-	projectPoints(p3d, camera->getRvec(), camera->getTvec(), camera->getK(), camera->getDistCoeffs(), p2d);
+			// Add points of circle base (z = 0)
+			for(int k = (int)parameters.start_angle; k <= j; k++) {
+				p3d[p++] = Point3f(left ? xxx[j] : - xxx[j], yyy[k], 0);
+			}
+			// Add 3D part of grid (bowl edge)
+			for(double zz = 1.0; zz <= (double)parameters.nop_z; zz++)
+			{
+				double new_z = zz * zz * step_x_2;
+				double new_x = xxx[j] * (left ? (1.0 + sqrt(new_z) / radius) : (-1.0 - sqrt(new_z) / radius));
+				double new_y = yyy[j] * (1.0 + sqrt(new_z) / radius);
+				p3d[p++] = Point3f(new_x, new_y, -new_z);
+			}
+
+			// Projects 3D points of the column to an image plane
+			for(p = col_offset[col]; p < col_offset[col] + NoP[col]; p++) {
+				p2d[p] = camera->project(p3d[p]);
+			}
+		}
+	});
 
 	// Find seam points
 	findSeam(camera, seam);
@@ -690,10 +893,10 @@ int RectilinearGrid::getGrid(float** points)
 	
 	if (p2d.size() == 0) { return (0); }
 		
-	Point2f top = Point2f((static_cast<float>(cam_info.index & 1U) - 1.0f), static_cast<float>((~cam_info.index >> 1U) & 1U));
+	Point2f top = cam_info.tile;
 		
-	float x_norm = 1.0f / (float)cam_info.width;
-	float y_norm = 1.0f / (float)cam_info.height;
+	float x_norm = cam_info.tile_size / (float)cam_info.width;
+	float y_norm = cam_info.tile_size / (float)cam_info.height;
 		
 	(*points) = (float*)malloc(6 * p2d.size() * sizeof(float));
 	if ((*points) == NULL) {
@@ -928,203 +1131,219 @@ void RectilinearGrid::findSeam(Camera* camera, vector<Point3f> &seam_points)
 
 /**************************************************************************************************************
  *
- * @brief  			Generate triangles from a 3D grid and save them to a file.
+ * @brief  			Generate triangles from a 3D grid.
  *
  * @param  in		Camera* camera - pointer to the Camera object
+ * 		   out		vector<float> &mesh - triangles: 5 floats (x, y, z, u, v) per vertex, 3 vertices per triangle
+ * 		   in		bool analytic - if true then texels are calculated with the polynomial camera model (see getTexels)
+ * 		   			instead of sampling xmap/ymap
  *
  * @return 			-
  *
- * @remarks 		The file with triangles description has been saved to the file arrayX, where X is camera index.
- * 					The grid has been rotated according to the camera index value:
- * 						index = 0 - without rotation;
- * 						index = 1 - 90 degree clockwise rotation;
- * 						index = 2 - 180 degree clockwise rotation;
- * 						index = 3 - 270 degree clockwise rotation;
+ * @remarks 		Vertices are 3D template points and texels are normalized fisheye coordinates.
+ * 					The grid has been rotated clockwise by the camera yaw (see rotatePoint).
  *
  **************************************************************************************************************/
-void RectilinearGrid::saveGrid(Camera* camera)
+void RectilinearGrid::createMesh(Camera* camera, vector<float> &mesh, bool analytic)
 {
 	float height = (float)camera->xmap.rows;	// 2D grid height (texels)
 	float width = (float)camera->xmap.cols;	// 2D grid width (texels)
 
-	// Generate output array
-	char file_name[50];
-	sprintf(file_name, "./array%d", camera->index + 1);
-
-    ofstream outC; // Output file
-    outC.open(file_name, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
+	// Recalculate grid points for fisheye image
+	if (analytic) { getTexels(camera->model, camera->sf, p2d, p2t); }
+	else { getTexels(camera->xmap, camera->ymap, p2d, p2t); }
 
-    int offset = NoP[0]; // Set offset of point in 3D grid (vertices)
+	// Offset of the first point of each grid column in 3D grid (vertices)
+	vector<int> col_offset(NoP.size(), 0);
+	for(uint xx = 1U; xx < NoP.size(); xx++) {
+		col_offset[xx] = col_offset[xx - 1U] + NoP[xx - 1U];
+	}
 
-    /**************************** Get triangles for II quadrant of template *********************************
-     *   							  p3 _  p2
-     *   Triangles orientation: 		| /|		1 triangle (p4-p1-p2)
-     *   								|/_|		2 triangle (p4-p2-p3)
-     *   							  p4   p1
-     *******************************************************************************************************/
+	// Generate triangles of each column in parallel into its own buffer
+	int half = (int)parameters.angles - (int)parameters.start_angle; // Index of the last II quadrant column
+	vector< vector<float> > column_buf(NoP.size());
 
-	for(uint xx = 1U; xx <= parameters.angles - parameters.start_angle; xx++) // Repeat for each column of 3D grid
-	{
-		for(int yy = 0; yy < NoP[xx]; yy ++) // Repeat for each row of the xx column
+	parallel_for_(Range(1, MAX((int)NoP.size(), 1)), [&](const Range &range) {
+		for(int xx = range.start; xx < range.end; xx++)
 		{
-			int p1 = offset + yy;						// Point with current offset (x, y)
-			int p2 = offset + (yy + 1);					// Next point in the same column (x, y + 1)
-			int p3 = offset + (yy + 1) - NoP[xx - 1U];	// Neighbor point from previous column (x - 1, y + 1)
-			int p4 = offset + yy - NoP[xx - 1U];			// Neighbor point from previous column (x - 1, y)
+			vector<float> &buf = column_buf[xx]; // Column buffer
+			int offset = col_offset[xx]; // Set offset of point in 3D grid (vertices)
 
-			if((p4 < offset) && (p2 < offset + NoP[xx])) // Check if points p2 and p4 are exist in the 3D vertices grid
+			if (xx <= half)
 			{
-			    /*******************************************************************************************************
-			     *   							  		p2
-			     *   1 triangle (p4-p1-p2): 		  /|
-			     *   								 /_|
+			    /**************************** Get triangles for II quadrant of template *********************************
+			     *   							  p3 _  p2
+			     *   Triangles orientation: 		| /|		1 triangle (p4-p1-p2)
+			     *   								|/_|		2 triangle (p4-p2-p3)
 			     *   							  p4   p1
 			     *******************************************************************************************************/
-				if((round(p2d[p2].x) < width) && (round(p2d[p2].y) < height) && (p2d[p2].x >= 0.0) && (p2d[p2].y >= 0.0) &&
-				   (round(p2d[p4].x) < width) && (round(p2d[p4].y) < height) && (p2d[p4].x >= 0.0) && (p2d[p4].y >= 0.0))
+				for(int yy = 0; yy < NoP[xx]; yy ++) // Repeat for each row of the xx column
 				{
-					if (((int)round(p2d[p1].x) < camera->xmap.cols) && ((int)round(p2d[p1].y) < camera->ymap.rows) && (p2d[p1].x >= 0.0) && (p2d[p1].y >= 0.0))
-					{
-						// Recalculate point for fisheye image
-						Point2f p4_new = Point2f(getMapAt(camera->xmap, p2d[p4]) / width, getMapAt(camera->ymap, p2d[p4]) / height);
-						Point2f p1_new = Point2f(getMapAt(camera->xmap, p2d[p1]) / width, getMapAt(camera->ymap, p2d[p1]) / height);
-						Point2f p2_new = Point2f(getMapAt(camera->xmap, p2d[p2]) / width, getMapAt(camera->ymap, p2d[p2]) / height);
-
-						// Rotate grid point according to the template
-						Point3f vertex4 = rotatePoint(camera->index, p3d[p4]);
-						Point3f vertex1 = rotatePoint(camera->index, p3d[p1]);
-						Point3f vertex2 = rotatePoint(camera->index, p3d[p2]);
-
-						// Save triangle points to the output file
-						outC << vertex4.x << " " << vertex4.y << " " << vertex4.z << " " << p4_new.x << " " << p4_new.y << endl;
-						outC << vertex1.x << " " << vertex1.y << " " << vertex1.z << " " << p1_new.x << " " << p1_new.y << endl;
-						outC << vertex2.x << " " << vertex2.y << " " << vertex2.z << " " << p2_new.x << " " << p2_new.y << endl;
-					}
+					int p1 = offset + yy;						// Point with current offset (x, y)
+					int p2 = offset + (yy + 1);					// Next point in the same column (x, y + 1)
+					int p3 = offset + (yy + 1) - NoP[xx - 1U];	// Neighbor point from previous column (x - 1, y + 1)
+					int p4 = offset + yy - NoP[xx - 1U];			// Neighbor point from previous column (x - 1, y)
 
-					/*******************************************************************************************************
-				     *   							  p3 _	p2
-				     *   2 triangle (p4-p2-p3): 		| /
-				     *   								|/
-				     *   							  p4
-				     *******************************************************************************************************/
-					if((p3 < offset) && (round(p2d[p3].x) < width) && (round(p2d[p3].y) < height) && (p2d[p3].x >= 0.0) && (p2d[p3].y >= 0.0))
+					if((p4 < offset) && (p2 < offset + NoP[xx])) // Check if points p2 and p4 are exist in the 3D vertices grid
 					{
-						// Recalculate point for fisheye image
-						Point2f p4_new = Point2f(getMapAt(camera->xmap, p2d[p4]) / width, getMapAt(camera->ymap, p2d[p4]) / height);
-						Point2f p2_new = Point2f(getMapAt(camera->xmap, p2d[p2]) / width, getMapAt(camera->ymap, p2d[p2]) / height);
-						Point2f p3_new = Point2f(getMapAt(camera->xmap, p2d[p3]) / width, getMapAt(camera->ymap, p2d[p3]) / height);
-
-						// Rotate grid point according to the template
-						Point3f vertex4 = rotatePoint(camera->index, p3d[p4]);
-						Point3f vertex2 = rotatePoint(camera->index, p3d[p2]);
-						Point3f vertex3 = rotatePoint(camera->index, p3d[p3]);
-
-						// Save triangle points to the output file
-						outC << vertex4.x << " " << vertex4.y << " " << vertex4.z << " " << p4_new.x << " " << p4_new.y << endl;
-						outC << vertex2.x << " " << vertex2.y << " " << vertex2.z << " " << p2_new.x << " " << p2_new.y << endl;
-						outC << vertex3.x << " " << vertex3.y << " " << vertex3.z << " " << p3_new.x << " " << p3_new.y << endl;
-					 }
+					    /*******************************************************************************************************
+					     *   							  		p2
+					     *   1 triangle (p4-p1-p2): 		  /|
+					     *   								 /_|
+					     *   							  p4   p1
+					     *******************************************************************************************************/
+						if((round(p2d[p2].x) < width) && (round(p2d[p2].y) < height) && (p2d[p2].x >= 0.0) && (p2d[p2].y >= 0.0) &&
+						   (round(p2d[p4].x) < width) && (round(p2d[p4].y) < height) && (p2d[p4].x >= 0.0) && (p2d[p4].y >= 0.0))
+						{
+							if (((int)round(p2d[p1].x) < camera->xmap.cols) && ((int)round(p2d[p1].y) < camera->ymap.rows) && (p2d[p1].x >= 0.0) && (p2d[p1].y >= 0.0))
+							{
+								// Get fisheye texels
+								Point2f p4_new = p2t[p4];
+								Point2f p1_new = p2t[p1];
+								Point2f p2_new = p2t[p2];
+
+								// Rotate grid point according to the template
+								Point3f vertex4 = rotatePoint(camera->yaw, p3d[p4]);
+								Point3f vertex1 = rotatePoint(camera->yaw, p3d[p1]);
+								Point3f vertex2 = rotatePoint(camera->yaw, p3d[p2]);
+
+								// Save triangle points to the column buffer
+								buf.insert(buf.end(), {vertex4.x, vertex4.y, vertex4.z, p4_new.x, p4_new.y});
+								buf.insert(buf.end(), {vertex1.x, vertex1.y, vertex1.z, p1_new.x, p1_new.y});
+								buf.insert(buf.end(), {vertex2.x, vertex2.y, vertex2.z, p2_new.x, p2_new.y});
+							}
+
+							/*******************************************************************************************************
+						     *   							  p3 _	p2
+						     *   2 triangle (p4-p2-p3): 		| /
+						     *   								|/
+						     *   							  p4
+						     *******************************************************************************************************/
+							if((p3 < offset) && (round(p2d[p3].x) < width) && (round(p2d[p3].y) < height) && (p2d[p3].x >= 0.0) && (p2d[p3].y >= 0.0))
+							{
+								// Get fisheye texels
+								Point2f p4_new = p2t[p4];
+								Point2f p2_new = p2t[p2];
+								Point2f p3_new = p2t[p3];
+
+								// Rotate grid point according to the template
+								Point3f vertex4 = rotatePoint(camera->yaw, p3d[p4]);
+								Point3f vertex2 = rotatePoint(camera->yaw, p3d[p2]);
+								Point3f vertex3 = rotatePoint(camera->yaw, p3d[p3]);
+
+								// Save triangle points to the column buffer
+								buf.insert(buf.end(), {vertex4.x, vertex4.y, vertex4.z, p4_new.x, p4_new.y});
+								buf.insert(buf.end(), {vertex2.x, vertex2.y, vertex2.z, p2_new.x, p2_new.y});
+								buf.insert(buf.end(), {vertex3.x, vertex3.y, vertex3.z, p3_new.x, p3_new.y});
+							 }
+						}
+					}
 				}
 			}
-		}
-		offset += NoP[xx]; // Update offset
-	}
-
-    /**************************** Get triangles for I quadrant of template **********************************
-     *   							  p3 _  p2
-     *   Triangles orientation: 		|\ |		1 triangle (p4-p1-p3)
-     *   								|_\|		2 triangle (p1-p2-p3)
-     *   							  p4   p1
-     *******************************************************************************************************/
-	for(uint xx = parameters.angles + 1U - parameters.start_angle; xx < 2U * (parameters.angles - parameters.start_angle) + 1U; xx++)
-	{
-		for(int yy = 0; yy < NoP[xx]; yy ++)
-		{
-			int p1 = offset + yy;						// Point with current offset (x, y)
-			int p2 = offset + (yy + 1);					// Next point in the same column (x, y + 1)
-			int p3 = offset + (yy + 1) - NoP[xx - 1U];	// Neighbor point from previous column (x - 1, y + 1)
-			int p4 = offset + yy - NoP[xx - 1U];			// Neighbor point from previous column (x - 1, y)
-
-			if(p3 < offset) // Check if point p3 is exist in the 3D vertices grid
+			else
 			{
-			    /*******************************************************************************************************
-			     *   							  p3
-			     *   1 triangle (p4-p1-p3): 		 |\
-			     *   								 |_\
+			    /**************************** Get triangles for I quadrant of template **********************************
+			     *   							  p3 _  p2
+			     *   Triangles orientation: 		|\ |		1 triangle (p4-p1-p3)
+			     *   								|_\|		2 triangle (p1-p2-p3)
 			     *   							  p4   p1
 			     *******************************************************************************************************/
-				if((round(p2d[p1].x) < width) && (round(p2d[p1].y) < height) && (p2d[p1].x >= 0.0) && (p2d[p1].y >= 0.0) &&
-				   (round(p2d[p3].x) < width) && (round(p2d[p3].y) < height) && (p2d[p3].x >= 0.0) && (p2d[p3].y >= 0.0))
+				for(int yy = 0; yy < NoP[xx]; yy ++)
 				{
-					if ((round(p2d[p4].x) < width) && (round(p2d[p4].y) < height) && (p2d[p4].x >= 0.0) && (p2d[p4].y >= 0.0))
-					{
-						// Recalculate point for fisheye image
-						Point2f p4_new = Point2f(getMapAt(camera->xmap, p2d[p4]) / width, getMapAt(camera->ymap, p2d[p4]) / height);
-						Point2f p1_new = Point2f(getMapAt(camera->xmap, p2d[p1]) / width, getMapAt(camera->ymap, p2d[p1]) / height);
-						Point2f p3_new = Point2f(getMapAt(camera->xmap, p2d[p3]) / width, getMapAt(camera->ymap, p2d[p3]) / height);
-
-						// Rotate grid point according to the template
-						Point3f vertex4 = rotatePoint(camera->index, p3d[p4]);
-						Point3f vertex1 = rotatePoint(camera->index, p3d[p1]);
-						Point3f vertex3 = rotatePoint(camera->index, p3d[p3]);
-
-						// Save triangle points to the output file
-						outC << vertex4.x << " " << vertex4.y << " " << vertex4.z << " " << p4_new.x << " " << p4_new.y << endl;
-						outC << vertex1.x << " " << vertex1.y << " " << vertex1.z << " " << p1_new.x << " " << p1_new.y << endl;
-						outC << vertex3.x << " " << vertex3.y << " " << vertex3.z << " " << p3_new.x << " " << p3_new.y << endl;
-					}
+					int p1 = offset + yy;						// Point with current offset (x, y)
+					int p2 = offset + (yy + 1);					// Next point in the same column (x, y + 1)
+					int p3 = offset + (yy + 1) - NoP[xx - 1U];	// Neighbor point from previous column (x - 1, y + 1)
+					int p4 = offset + yy - NoP[xx - 1U];			// Neighbor point from previous column (x - 1, y)
 
-					/*******************************************************************************************************
-				     *   							  p3  _	p2
-				     *   2 triangle (p1-p2-p3): 		 \ |
-				     *   								  \|
-				     *   							  		p1
-				     *******************************************************************************************************/
-					if((p2 < offset + NoP[xx]) && (round(p2d[p2].x) < width) && (round(p2d[p2].y) < height) && (p2d[p2].x >= 0.0) && (p2d[p2].y >= 0.0))
+					if(p3 < offset) // Check if point p3 is exist in the 3D vertices grid
 					{
-						// Recalculate point for fisheye image
-						Point2f p1_new = Point2f(getMapAt(camera->xmap, p2d[p1]) / width, getMapAt(camera->ymap, p2d[p1]) / height);
-						Point2f p2_new = Point2f(getMapAt(camera->xmap, p2d[p2]) / width, getMapAt(camera->ymap, p2d[p2]) / height);
-						Point2f p3_new = Point2f(getMapAt(camera->xmap, p2d[p3]) / width, getMapAt(camera->ymap, p2d[p3]) / height);
-
-						// Rotate grid point according to the template
-						Point3f vertex1 = rotatePoint(camera->index, p3d[p1]);
-						Point3f vertex2 = rotatePoint(camera->index, p3d[p2]);
-						Point3f vertex3 = rotatePoint(camera->index, p3d[p3]);
-
-						// Save triangle points to the output file
-						outC << vertex1.x << " " << vertex1.y << " " << vertex1.z << " " << p1_new.x << " " << p1_new.y << endl;
-						outC << vertex2.x << " " << vertex2.y << " " << vertex2.z << " " << p2_new.x << " " << p2_new.y << endl;
-						outC << vertex3.x << " " << vertex3.y << " " << vertex3.z << " " << p3_new.x << " " << p3_new.y << endl;
-					 }
+					    /*******************************************************************************************************
+					     *   							  p3
+					     *   1 triangle (p4-p1-p3): 		 |\
+					     *   								 |_\
+					     *   							  p4   p1
+					     *******************************************************************************************************/
+						if((round(p2d[p1].x) < width) && (round(p2d[p1].y) < height) && (p2d[p1].x >= 0.0) && (p2d[p1].y >= 0.0) &&
+						   (round(p2d[p3].x) < width) && (round(p2d[p3].y) < height) && (p2d[p3].x >= 0.0) && (p2d[p3].y >= 0.0))
+						{
+							if ((round(p2d[p4].x) < width) && (round(p2d[p4].y) < height) && (p2d[p4].x >= 0.0) && (p2d[p4].y >= 0.0))
+							{
+								// Get fisheye texels
+								Point2f p4_new = p2t[p4];
+								Point2f p1_new = p2t[p1];
+								Point2f p3_new = p2t[p3];
+
+								// Rotate grid point according to the template
+								Point3f vertex4 = rotatePoint(camera->yaw, p3d[p4]);
+								Point3f vertex1 = rotatePoint(camera->yaw, p3d[p1]);
+								Point3f vertex3 = rotatePoint(camera->yaw, p3d[p3]);
+
+								// Save triangle points to the column buffer
+								buf.insert(buf.end(), {vertex4.x, vertex4.y, vertex4.z, p4_new.x, p4_new.y});
+								buf.insert(buf.end(), {vertex1.x, vertex1.y, vertex1.z, p1_new.x, p1_new.y});
+								buf.insert(buf.end(), {vertex3.x, vertex3.y, vertex3.z, p3_new.x, p3_new.y});
+							}
+
+							/*******************************************************************************************************
+						     *   							  p3  _	p2
+						     *   2 triangle (p1-p2-p3): 		 \ |
+						     *   								  \|
+						     *   							  		p1
+						     *******************************************************************************************************/
+							if((p2 < offset + NoP[xx]) && (round(p2d[p2].x) < width) && (round(p2d[p2].y) < height) && (p2d[p2].x >= 0.0) && (p2d[p2].y >= 0.0))
+							{
+								// Get fisheye texels
+								Point2f p1_new = p2t[p1];
+								Point2f p2_new = p2t[p2];
+								Point2f p3_new = p2t[p3];
+
+								// Rotate grid point according to the template
+								Point3f vertex1 = rotatePoint(camera->yaw, p3d[p1]);
+								Point3f vertex2 = rotatePoint(camera->yaw, p3d[p2]);
+								Point3f vertex3 = rotatePoint(camera->yaw, p3d[p3]);
+
+								// Save triangle points to the column buffer
+								buf.insert(buf.end(), {vertex1.x, vertex1.y, vertex1.z, p1_new.x, p1_new.y});
+								buf.insert(buf.end(), {vertex2.x, vertex2.y, vertex2.z, p2_new.x, p2_new.y});
+								buf.insert(buf.end(), {vertex3.x, vertex3.y, vertex3.z, p3_new.x, p3_new.y});
+							 }
+						}
+					}
 				}
 			}
 		}
-		offset += NoP[xx]; // Update offset
+	});
+
+	// Concatenate columns in order
+	mesh.clear();
+	for(uint xx = 1U; xx < column_buf.size(); xx++) {
+		mesh.insert(mesh.end(), column_buf[xx].begin(), column_buf[xx].end());
 	}
-	outC.close(); // Close file
 }
 
 
 /**************************************************************************************************************
  *
- * @brief  			Rotate point according to the camera index
+ * @brief  			Rotate point according to the camera yaw
  *
- * @param  in		index - camera index
+ * @param  in		float yaw - camera yaw (degrees)
  * 		   in		Point3f point - grid point
  *
  * @return 			Point3f point - point after rotation
  *
- * @remarks 		The function rotate grid point according to the camera index value:
- * 						index = 0 - without rotation;
- * 						index = 1 - 90 degree clockwise rotation;
- * 						index = 2 - 180 degree clockwise rotation;
- * 						index = 3 - 270 degree clockwise rotation;
+ * @remarks 		The function rotate grid point clockwise by yaw degrees around the bowl axis and converts it
+ * 					into the render coordinates (y and z axes are flipped). Yaw 0, 90, 180 and 270 degrees
+ * 					correspond to the cameras of the default 4 cameras ring.
  *
  **************************************************************************************************************/
-Point3f rotatePoint(int index, Point3f point)
+Point3f rotatePoint(float yaw, Point3f point)
 {
 	Point3f result;
+	float quadrant = yaw / 90.0f;
+	int index = (int)floorf(quadrant);
+	if ((float)index != quadrant) { index = -1; } // Arbitrary angle
+	else { index = ((index % 4) + 4) % 4; }
+
 	switch(index)
 	{
 	case(0): // Without rotation
@@ -1142,11 +1361,21 @@ Point3f rotatePoint(int index, Point3f point)
 		result.y =   point.y;
 		result.z = - point.z;
 		break;
-	default: // case(3)    270 degree clockwise rotation
+	case(3): // 270 degree clockwise rotation
 		result.x =   point.y;
 		result.y =   point.x;
 		result.z = - point.z;
 		break;
+	default: // yaw degree clockwise rotation
+	{
+		float angle = yaw * (float)CV_PI / 180.0f;
+		float c = cosf(angle);
+		float s = sinf(angle);
+		result.x =   point.x * c - point.y * s;
+		result.y = - point.x * s - point.y * c;
+		result.z = - point.z;
+		break;
+	}
 	}
 	return(result);
 }
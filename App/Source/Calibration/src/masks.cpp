@@ -25,6 +25,39 @@
 
 #include "masks.hpp"
 
+/**************************************************************************************************************
+ *
+ * @brief  			Get ring angle between two cameras
+ *
+ * @param  	in		float from - yaw of the first camera (degrees)
+ * 			in		float to - yaw of the second camera (degrees)
+ *
+ * @return 			The function returns counterclockwise angle from the first to the second camera in (0, 360].
+ *
+ **************************************************************************************************************/
+static inline float ringAngle(float from, float to)
+{
+	float angle = fmodf(to - from, 360.0f);
+	if (angle <= 0.0f) { angle += 360.0f; }
+	return(angle);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Rotate point around z axis
+ *
+ * @param  	in		const Point3f &p - point
+ * 			in		double c - cosine of the rotation angle
+ * 			in		double s - sine of the rotation angle
+ *
+ * @return 			The function returns x and y coordinates of the point rotated counterclockwise.
+ *
+ **************************************************************************************************************/
+static inline Point2f rotatePoint2d(const Point3f &p, double c, double s)
+{
+	return(Point2f((float)((double)p.x * c - (double)p.y * s), (float)((double)p.x * s + (double)p.y * c)));
+}
+
 /**************************************************************************************************************
  *
  * @brief  			Calculate masks for 3D BEV.
@@ -70,15 +103,19 @@ void Masks::createMasks(vector<Camera*> &cameras, vector< vector<Point3f> > &sea
 		}
 	}
 
-
+	masks.clear();
+	seaml.clear();
+	seamr.clear();
 
 	// Get grids intersection points
 	for(uint i = 0; i < cameras.size(); i++)
 	{
 		Seam seam_left, seam_right;
-		getSeamPoints(seam_points[i], seam_points[next_id((int)i, (int)cameras.size() - 1)], seam_right, 1); // intersection with next grid
+		int next = cameras[i]->next;
+		int prev = cameras[i]->previous;
+		getSeamPoints(seam_points[i], seam_points[next], seam_right, ringAngle(cameras[i]->yaw, cameras[next]->yaw)); // intersection with next grid
 		seamr.push_back(seam_right);
-		getSeamPoints(seam_points[i], seam_points[previous_id((int)i, (int)cameras.size() - 1)], seam_left, -1); // intersection with previous grid
+		getSeamPoints(seam_points[i], seam_points[prev], seam_left, - ringAngle(cameras[prev]->yaw, cameras[i]->yaw)); // intersection with previous grid
 		seaml.push_back(seam_left);
 	}
 
@@ -139,7 +176,7 @@ void Masks::createMasks(vector<Camera*> &cameras, vector< vector<Point3f> > &sea
 
 		// Projects 3D seam points to an image plane
 		vector<Point2f> seam2d;
-		projectPoints(seam3d, cameras[i]->getRvec(), cameras[i]->getTvec(), cameras[i]->getK(), cameras[i]->getDistCoeffs(), seam2d);
+		cameras[i]->project(seam3d, seam2d);
 
 		// Get seam for fisheye image
 		vector<Point> seam;
@@ -164,7 +201,9 @@ void Masks::createMasks(vector<Camera*> &cameras, vector< vector<Point3f> > &sea
 		left_points.push_back(Point3f(seaml[i].p1.x, seaml[i].p1.y, 0));
 		left_points.push_back(Point3f(seaml[i].p2.x, sqrt(pow(radius, 2) - pow(seaml[i].p2.x, 2)), 0));
 		left_points.push_back(seam_points[i][3]);
-		smoothMaskEdge(masks[i], Vec2b(0, 255), Vec2d(smoothing_angle - smothing, smoothing_angle + smothing), 0.0039, left_points, cameras[i]);
+		Mat bowl;
+		getBowlMap(cameras[i], radius, bowl);
+		smoothMaskEdge(masks[i], Vec2b(0, 255), Vec2d(smoothing_angle - smothing, smoothing_angle + smothing), left_points, bowl);
 
 		// Define right edge of smoothing
 		smoothing_angle = atan(seamr[i].line.alpha);
@@ -172,20 +211,17 @@ void Masks::createMasks(vector<Camera*> &cameras, vector< vector<Point3f> > &sea
 		right_points.push_back(Point3f(seamr[i].p1.x, seamr[i].p1.y, 0));
 		right_points.push_back(Point3f(seamr[i].p2.x, sqrt(pow(radius, 2) - pow(seamr[i].p2.x, 2)), 0));
 		right_points.push_back(seam_points[i][4]);
-		smoothMaskEdge(masks[i], Vec2b(255, 0), Vec2d(smoothing_angle - smothing, smoothing_angle + smothing), 0.0039, right_points, cameras[i]);
+		smoothMaskEdge(masks[i], Vec2b(255, 0), Vec2d(smoothing_angle - smothing, smoothing_angle + smothing), right_points, bowl);
 
 		// Blurs an image using a Gaussian filter
-		for (int row = 0; row < masks[i].rows; row++) {
-			Mat roi = cam_mask(Rect(0, row, masks[i].cols, 1));
-			GaussianBlur(roi, roi, Size(2 * ((masks[i].rows - row) / 2) + 1, 1), 10.0, 1.0);
-		}
+		featherMask(masks[i], FEATHER_SIGMA);
 		GaussianBlur(masks[i], masks[i], Size(3, 3), 10.0);
 
 
 		// Save masks
 		char mask_name[50];
-		sprintf(mask_name, "./mask%d.jpg", i);
-		if (imwrite(mask_name, masks[i]) == false) {
+		sprintf(mask_name, "./mask%d.msk", i);
+		if (saveMaskFile(mask_name, masks[i]) != 0) {
 			cout << "Failed to save " << mask_name << endl;
 		}
 	}
@@ -196,87 +232,238 @@ void Masks::createMasks(vector<Camera*> &cameras, vector< vector<Point3f> > &sea
  * @brief  			Split vertices/texels grid into grid which will be rendered with blending and grid which will
  * 					be rendered without blending for all cameras
  *
- * @param  			-
+ * @param  	in		const vector< vector<float> > &meshes - grids of all cameras (5 floats per vertex: vx vy vz tx ty)
+ * 			in		bool weights - if true then overlap grids with baked blend weights are produced too
  *
- * @return 			Functions returns 0 if all grid files "arrayX" file (X = 1,2,3,4 is camera number) are existed.
- * 					If one of the files not found the function returns -1.
+ * @return 			Functions returns 0 if a grid is given for every mask. Otherwise the function returns -1.
  *
- * @remarks 		The function reads grid of texels/vertices from the "arrayX" file (X = 1,2,3,4 is camera number)
- * 					and pruduces two output grids: first for overlapping regions ("arrayX1") and second for
- * 					non-overlapping regions ("arrayX2").
- * 					Camera blending mask is used to split grid into two parts. The mask value has been checked
- * 					for each texels of a rendered triangle. If at least one of texels is masked with value less than
- * 					255 then the triangle is written to overlap grid. Otherwise the triangle is written to non-overlap
- * 					grid.
+ * @remarks 		The function produces two output grids for every camera: first for overlapping regions and
+ * 					second for non-overlapping regions (see getSplitGrid).
+ * 					Camera blending mask is used to split grid into two parts. The mask is eroded and dilated
+ * 					once with a (2 * SPLIT_RADIUS + 1) square. If all texels of a triangle are white in the eroded
+ * 					mask then the triangle is written to non-overlap grid. Otherwise, if at least one texel is not
+ * 					black in the dilated mask then the triangle is written to overlap grid.
+ * 					If weights is set then the overlap grid is also written with the mask value of every vertex
+ * 					(see getWeightedGrid), so the renderer can interpolate the blend weight instead of sampling
+ * 					the mask texture. Triangles are densified along the seam where the linear interpolation
+ * 					of vertex weights does not follow the mask (see bakeWeights).
  *
  **************************************************************************************************************/
-int Masks::splitGrids(void)
+int Masks::splitGrids(const vector< vector<float> > &meshes, bool weights)
 {
-	float vx[3], vy[3], vz[3], tx[3], ty[3];
+	split_b.assign(masks.size(), vector<float>());
+	split_wb.assign(masks.size(), vector<float>());
+	split_bw.assign(weights ? masks.size() : 0, vector<float>());
+
+	if (meshes.size() < masks.size())
+	{
+		cout << "Texels/vertices grids have not been split. Grids number is fewer than masks number" << endl;
+		return(-1);
+	}
 
+	Mat kernel = getStructuringElement(MORPH_RECT, Size(2 * SPLIT_RADIUS + 1, 2 * SPLIT_RADIUS + 1));
 	for(uint i = 0; i < masks.size(); i++)
 	{
-		char file_name[50], file_name_b[50], file_name_wb[50];
-		sprintf(file_name, "./array%d", i + 1U);		// Name of input grid
-		sprintf(file_name_b, "./array%d1", i + 1U); 	// Name of overlap grid
-		sprintf(file_name_wb, "./array%d2", i + 1U); // Name of non-overlap grid
+		// Pixel is white in the eroded mask if all its neighborhood is white, and it isn't black in the
+		// dilated mask if at least one pixel of its neighborhood isn't black
+		Mat eroded, dilated;
+		erode(masks[i], eroded, kernel, Point(-1, -1), 1, BORDER_CONSTANT, Scalar(0));
+		dilate(masks[i], dilated, kernel, Point(-1, -1), 1, BORDER_CONSTANT, Scalar(0));
 
-		ifstream ifs_ref(file_name);
-		if(ifs_ref) // // The file exists, and is open for input
+		const vector<float> &mesh = meshes[i];
+		EdgeSplits splits; // Overlap grid edges are split in the same way by both adjacent triangles
+		for(size_t t = 0; t + 14 < mesh.size(); t += 15) // For each triangle
 		{
-			ofstream outC_b, outC_wb; // Output file
-			outC_b.open(file_name_b, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
-			outC_wb.open(file_name_wb, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
-
-			while (ifs_ref >> vx[0] >> vy[0] >> vz[0] >> tx[0] >> ty[0] >> vx[1] >> vy[1] >> vz[1] >> tx[1] >> ty[1] >> vx[2] >> vy[2] >> vz[2] >> tx[2] >> ty[2] ) // Read triangle
+			bool is_white = true;
+			bool is_black = true;
+			for(int j = 0; j < 3; j ++) // For each vertexes of the triangle
 			{
-				uint pixels_sum = 0U; // Sum of pixels of triangle vertexes
-				for(int j = 0; j < 3; j ++) // For each vertexes of the triangle
+				int x = static_cast<int>(mesh[t + 5 * j + 3] * (float)masks[i].cols);
+				int y = static_cast<int>(mesh[t + 5 * j + 4] * (float)masks[i].rows);
+				if ((x >= 0) && (y >= 0) && (x < masks[i].cols) && (y < masks[i].rows))
+				{
+					is_white = is_white && (eroded.at<uchar>(y, x) == 255U);
+					is_black = is_black && (dilated.at<uchar>(y, x) == 0U);
+				}
+				else {
+					is_white = false;
+				}
+			}
+
+			if(is_white) { // Non-overlap region
+				split_wb[i].insert(split_wb[i].end(), mesh.begin() + t, mesh.begin() + t + 15);
+			}
+			else if(!is_black) { // Overlap region
+				split_b[i].insert(split_b[i].end(), mesh.begin() + t, mesh.begin() + t + 15);
+
+				if (weights)
 				{
-					Point idx1 = Point(static_cast<int>(tx[j] * (float)masks[i].cols) - 40, static_cast<int>(ty[j] * (float)masks[i].rows) - 40);
-					Point idx2 = Point(static_cast<int>(tx[j] * (float)masks[i].cols) + 40, static_cast<int>(ty[j] * (float)masks[i].rows) + 40);
-										
-					if ((idx1.x < masks[i].cols) && (idx1.y < masks[i].rows) && (idx1.x > 0) && (idx1.y > 0))
+					Vec6f tri[3];
+					for(int j = 0; j < 3; j ++)
 					{
-						pixels_sum += masks[i].at<uchar>(idx1); // Add pixel value
-						if((idx2.x < masks[i].cols) && (idx2.y < masks[i].rows) && (idx2.x > 0) && (idx2.y > 0))
-						{
-							pixels_sum += masks[i].at<uchar>(Point(idx2.x, idx2.y)); // Add pixel value
-							pixels_sum += masks[i].at<uchar>(Point(idx1.x, idx2.y)); // Add pixel value
-							pixels_sum += masks[i].at<uchar>(Point(idx2.x, idx1.y)); // Add pixel value
-						}
-					}	
-					else {
-						if((idx2.x < masks[i].cols) && (idx2.y < masks[i].rows) && (idx2.x > 0) && (idx2.y > 0))
-						{
-							pixels_sum += masks[i].at<uchar>(idx2); // Add pixel value
-						}
+						const float* v = &mesh[t + 5 * j];
+						tri[j] = Vec6f(v[0], v[1], v[2], v[3], v[4], getWeight(masks[i], v[3], v[4]));
 					}
-					
+					bakeWeights(masks[i], tri, 0, splits, split_bw[i]);
 				}
+			}
+		}
+	}
+	return(0);
+}
+
+
+/**************************************************************************************************************
+ *
+ * @brief  			Create 2D bird's-eye remap grid
+ *
+ * @param  	in		const vector< vector<float> > &meshes - grids of all cameras (5 floats per vertex: vx vy vz tx ty)
+ * 			in		uint density - number of grid cells along every side of the bowl bottom
+ * 			out		vector<float> &grid - triangles of the bird's-eye grid (TOP_VERTEX_SIZE floats per vertex:
+ * 					vx vy tx0 ty0 tx1 ty1 w camera0 camera1)
+ *
+ * @return 			Functions returns 0 if the grid has been created. Otherwise the function returns -1.
+ *
+ * @remarks 		The flat bottom (vz = 0) of the bowl is covered by a regular density x density grid of squares.
+ * 					Every grid point is located in the bottom triangles of every camera grid, its fisheye texel is
+ * 					interpolated from the triangle texels and its blend weight is the mask value at the texel.
+ * 					Every grid triangle is assigned to two cameras with the biggest sum of vertex weights among
+ * 					the cameras which see all its vertices (camera1 is equal to camera0 if only one camera is
+ * 					found). w is the weight of camera0 normalized by the sum of both weights, so the renderer can
+ * 					draw the whole bottom in one pass without blending and depth test. Triangles which are not
+ * 					seen by any camera are skipped. Grid points are processed in parallel.
+ *
+ **************************************************************************************************************/
+int Masks::createTopGrid(const vector< vector<float> > &meshes, uint density, vector<float> &grid)
+{
+	grid.clear();
+	if ((density == 0) || masks.empty() || (meshes.size() < masks.size()))
+	{
+		cout << "Bird's-eye grid has not been created. Grids number is fewer than masks number" << endl;
+		return(-1);
+	}
 
-				if(pixels_sum == 4U * 765U) // If all 3 vertexes of triangles are white (3 * 255 = 765) -> non-overlap region
+	// Flat bottom triangles of every camera (vx vy tx ty) and the half size of the bottom
+	uint cameras = (uint)masks.size();
+	vector< vector<Vec4f> > flat(cameras);
+	float extent = 0.0f;
+	for(uint i = 0; i < cameras; i++)
+	{
+		const vector<float> &mesh = meshes[i];
+		for(size_t t = 0; t + 14 < mesh.size(); t += 15)
+		{
+			const float* v = &mesh[t];
+			if ((abs(v[2]) > TOP_FLAT_Z) || (abs(v[7]) > TOP_FLAT_Z) || (abs(v[12]) > TOP_FLAT_Z)) { continue; }
+			for(int j = 0; j < 3; j ++)
+			{
+				flat[i].push_back(Vec4f(v[5 * j], v[5 * j + 1], v[5 * j + 3], v[5 * j + 4]));
+				extent = max(extent, max(abs(v[5 * j]), abs(v[5 * j + 1])));
+			}
+		}
+	}
+	if (extent <= 0.0f)
+	{
+		cout << "Bird's-eye grid has not been created. Grids have no flat bottom" << endl;
+		return(-1);
+	}
+
+	// Bin the bottom triangles into the grid cells which are overlapped by the triangle bounding boxes
+	int cells = (int)density;
+	float cell = 2.0f * extent / (float)cells;
+	vector< vector< vector<int> > > bins(cameras, vector< vector<int> >((size_t)(cells * cells)));
+	for(uint i = 0; i < cameras; i++)
+	{
+		for(size_t t = 0; t + 2 < flat[i].size(); t += 3)
+		{
+			float x0 = min(flat[i][t][0], min(flat[i][t + 1][0], flat[i][t + 2][0]));
+			float x1 = max(flat[i][t][0], max(flat[i][t + 1][0], flat[i][t + 2][0]));
+			float y0 = min(flat[i][t][1], min(flat[i][t + 1][1], flat[i][t + 2][1]));
+			float y1 = max(flat[i][t][1], max(flat[i][t + 1][1], flat[i][t + 2][1]));
+			int cx0 = max((int)floor((x0 + extent) / cell), 0), cx1 = min((int)floor((x1 + extent) / cell), cells - 1);
+			int cy0 = max((int)floor((y0 + extent) / cell), 0), cy1 = min((int)floor((y1 + extent) / cell), cells - 1);
+			for(int cy = cy0; cy <= cy1; cy++) {
+				for(int cx = cx0; cx <= cx1; cx++) { bins[i][cy * cells + cx].push_back((int)t); }
+			}
+		}
+	}
+
+	// Fisheye texel and mask value (tx ty w) of every grid point for every camera, (-1, -1, 0) if the point is not seen
+	int side = cells + 1;
+	vector<Vec3f> points((size_t)(side * side) * cameras, Vec3f(-1.0f, -1.0f, 0.0f));
+	parallel_for_(Range(0, side * side), [&](const Range &range) {
+		for(int p = range.start; p < range.end; p++)
+		{
+			int px = p % side, py = p / side;
+			Point2f pt(-extent + cell * (float)px, -extent + cell * (float)py);
+			const int bin = min(py, cells - 1) * cells + min(px, cells - 1);
+			for(uint i = 0; i < cameras; i++)
+			{
+				for(uint k = 0; k < bins[i][bin].size(); k++)
 				{
-					outC_wb << vx[0] << " " << vy[0] << " " << vz[0] << " " << tx[0] << " " << ty[0] << endl;
-					outC_wb << vx[1] << " " << vy[1] << " " << vz[1] << " " << tx[1] << " " << ty[1] << endl;
-					outC_wb << vx[2] << " " << vy[2] << " " << vz[2] << " " << tx[2] << " " << ty[2] << endl;
-				}
-				else {
-					if(pixels_sum != 0U) // Otherwise -> overlap region
-					{
-						outC_b << vx[0] << " " << vy[0] << " " << vz[0] << " " << tx[0] << " " << ty[0] << endl;
-						outC_b << vx[1] << " " << vy[1] << " " << vz[1] << " " << tx[1] << " " << ty[1] << endl;
-						outC_b << vx[2] << " " << vy[2] << " " << vz[2] << " " << tx[2] << " " << ty[2] << endl;
+					const Vec4f* tri = &flat[i][bins[i][bin][k]];
+					float d = (tri[1][1] - tri[2][1]) * (tri[0][0] - tri[2][0]) + (tri[2][0] - tri[1][0]) * (tri[0][1] - tri[2][1]);
+					if (abs(d) < 1e-12f) { continue; } // Degenerated triangle
+					float l0 = ((tri[1][1] - tri[2][1]) * (pt.x - tri[2][0]) + (tri[2][0] - tri[1][0]) * (pt.y - tri[2][1])) / d;
+					float l1 = ((tri[2][1] - tri[0][1]) * (pt.x - tri[2][0]) + (tri[0][0] - tri[2][0]) * (pt.y - tri[2][1])) / d;
+					float l2 = 1.0f - l0 - l1;
+					if ((l0 < -1e-4f) || (l1 < -1e-4f) || (l2 < -1e-4f)) { continue; } // The point is outside of the triangle
+
+					float tx = l0 * tri[0][2] + l1 * tri[1][2] + l2 * tri[2][2];
+					float ty = l0 * tri[0][3] + l1 * tri[1][3] + l2 * tri[2][3];
+					if ((tx >= 0.0f) && (ty >= 0.0f) && (tx <= 1.0f) && (ty <= 1.0f)) {
+						points[(size_t)p * cameras + i] = Vec3f(tx, ty, getWeight(masks[i], tx, ty));
 					}
+					break;
 				}
 			}
-			outC_b.close(); // Close file
-			outC_wb.close(); // Close file
 		}
-		else
+	});
+
+	// Two triangles per grid cell
+	for(int cy = 0; cy < cells; cy++)
+	{
+		for(int cx = 0; cx < cells; cx++)
 		{
-			cout << "Texels/vertices grids have not been split. File " << file_name << " not found" << endl;
-			return(-1);
+			int p00 = cy * side + cx;
+			const int tris[2][3] = {{p00, p00 + 1, p00 + side + 1}, {p00, p00 + side + 1, p00 + side}};
+			for(int t = 0; t < 2; t++)
+			{
+				// Two cameras with the biggest sum of weights which see all triangle vertices
+				int camera[2] = {-1, -1};
+				float sum[2] = {0.0f, 0.0f};
+				for(uint i = 0; i < cameras; i++)
+				{
+					float s = 0.0f;
+					bool seen = true;
+					for(int j = 0; j < 3; j ++)
+					{
+						const Vec3f &v = points[(size_t)tris[t][j] * cameras + i];
+						seen = seen && (v[0] >= 0.0f);
+						s += v[2];
+					}
+					if (!seen || (s <= 0.0f)) { continue; }
+					if (s > sum[0]) {
+						camera[1] = camera[0]; sum[1] = sum[0];
+						camera[0] = (int)i; sum[0] = s;
+					}
+					else if (s > sum[1]) {
+						camera[1] = (int)i; sum[1] = s;
+					}
+				}
+				if (camera[0] < 0) { continue; } // The triangle is not seen by any camera
+				if (camera[1] < 0) { camera[1] = camera[0]; }
+
+				for(int j = 0; j < 3; j ++)
+				{
+					int p = tris[t][j];
+					const Vec3f &v0 = points[(size_t)p * cameras + camera[0]];
+					const Vec3f &v1 = points[(size_t)p * cameras + camera[1]];
+					float w1 = (camera[1] == camera[0]) ? 0.0f : v1[2];
+					float w = (v0[2] + w1 > 0.0f) ? v0[2] / (v0[2] + w1) : 1.0f;
+					grid.insert(grid.end(), {-extent + cell * (float)(p % side), -extent + cell * (float)(p / side),
+											 v0[0], v0[1], v1[0], v1[1], w, (float)camera[0], (float)camera[1]});
+				}
+			}
 		}
 	}
 	return(0);
@@ -292,12 +479,11 @@ int Masks::splitGrids(void)
  * 									For left mask edge the color range will be [0, 255] - from black to white.
  * 									And for right mask edge the color range will be [255, 0] - from white to black.
  * 			in		Vec2d angles - 	smoothing will be apply in these angles in the left and right direction from mask border.
- * 			in		double angle_step - step of color gradient
  * 			in		vector<Point3f> edge_points - 	vector of template points. It must include 3 points:
  * 													1. The first point of seam (intersection of bottom grid borders, z = 0)
  * 													2. The intersection point of seam line and base circle (z = 0)
  * 													3. The 3rd point of seam points (with maximum value of z coordinate)
- * 			in		Camera* camera  - Camera object
+ * 			in		const Mat &bowl - bowl points seen by every fisheye pixel (see getBowlMap)
  *
  * @return 			-
  *
@@ -305,63 +491,153 @@ int Masks::splitGrids(void)
  * 					smoothing (2 * SMOTHING_ANGLE) defines the area in which mask edge will be smooth. The original seam divides
  * 					the smoothing angle into two angles with equal measures (angle bisector). The angle based smoothing is applied
  * 					only for flat base. The seam at the bowl side is smoothed with constant width of smoothing.
+ * 					The color of every mask pixel is calculated directly from the angle between the seam line and the line
+ * 					which goes from the first seam point to the bowl point seen by the pixel. Pixels are processed in parallel.
  *
  **************************************************************************************************************/
-void Masks::smoothMaskEdge(Mat &img, Vec2b colors, Vec2d angles, double angle_step, vector<Point3f> edge_points, Camera* camera)
+void Masks::smoothMaskEdge(Mat &img, Vec2b colors, Vec2d angles, vector<Point3f> edge_points, const Mat &bowl)
 {
-	double color = (double)colors[0];
-	double color_step = static_cast<double>(colors[1] - colors[0]) * angle_step / (angles[1] - angles[0]);
-	double radius = sqrt(pow(edge_points[1].x, 2) + pow(edge_points[1].y, 2));
+	if ((bowl.size() != img.size()) || (angles[1] <= angles[0])) {
+		return;
+	}
 
-	double x_start, x_end, angle_cos;
+	double color_scale = static_cast<double>(colors[1] - colors[0]) / (angles[1] - angles[0]);
+	double radius = sqrt(pow(edge_points[1].x, 2) + pow(edge_points[1].y, 2));
+	double height = abs(edge_points[2].z);
+	Point2d start = Point2d(edge_points[0].x, edge_points[0].y);
 
-	for(double ang = angles[0]; ang < angles[1]; ang+=angle_step)
+	parallel_for_(Range(0, img.rows), [&](const Range& range)
 	{
-		double alpha = tan(ang);
-		double beta = edge_points[0].y - alpha * edge_points[0].x;
-
-		if(alpha > 0.0)
-		{
-			x_start = (- alpha * beta - sqrt(pow(radius, 2) * (1 + pow(alpha, 2)) - pow(beta, 2))) / (1 + pow(alpha, 2));
-			x_end = edge_points[0].x;
-			angle_cos = x_start / radius;
-		}
-		else
+		for (int row = range.start; row < range.end; row++)
 		{
-			x_start = edge_points[0].x;
-			x_end = (- alpha * beta + sqrt(pow(radius, 2) * (1 + pow(alpha, 2)) - pow(beta, 2))) / (1 + pow(alpha, 2));
-			angle_cos = x_end / radius;
-		}
+			const Vec3f* p = bowl.ptr<Vec3f>(row);
+			uchar* data = img.ptr<uchar>(row);
 
-		vector<Point3f> seam3d;
-		vector<Point2f> seam2d, seam;
+			for (int col = 0; col < img.cols; col++)
+			{
+				if (cvIsNaN(p[col][2]) || ((double)(-p[col][2]) >= height)) { continue; }
 
-		// Horizontal part of seam
-		for(double xx = x_start; xx <= x_end; xx+=SEAM_STEP) {
-			seam3d.push_back(Point3f(xx, xx * alpha + beta, 0.0));
-		}
+				// Bowl side points are moved to the base circle along the radius
+				Point2d q = Point2d(p[col][0], p[col][1]);
+				double r = sqrt(q.x * q.x + q.y * q.y);
+				if (r > radius)
+				{
+					if (q.y > 0.0) { continue; }
+					q *= radius / r;
+				}
 
-		// Vertical part of seam
-		for(double zz = 0.0; zz < abs(edge_points[2].z); zz+=SEAM_STEP)
-		{
-			double new_x = (radius + sqrt(zz)) * angle_cos;
-			double new_y = - new_x * tan(acos(angle_cos));
-			seam3d.push_back(Point3f(new_x, new_y, - zz));
+				Point2d d = q - start;
+				if (d.x == 0.0) { continue; }
+				double ang = atan(d.y / d.x); // Angle of the line which goes from the first seam point to the bowl point
+
+				// The seam line goes to the left for positive slope and to the right otherwise
+				if ((ang < angles[0]) || (ang >= angles[1]) || ((ang > 0.0) && (d.x > 0.0)) || ((ang <= 0.0) && (d.x < 0.0))) {
+					continue;
+				}
+
+				data[col] = saturate_cast<uchar>((double)colors[0] + (ang - angles[0]) * color_scale);
+			}
 		}
+	});
+}
 
-		projectPoints(seam3d, camera->getRvec(), camera->getTvec(), camera->getK(), camera->getDistCoeffs(), seam2d);
 
+/**************************************************************************************************************
+ *
+ * @brief  			Get bowl points seen by fisheye image pixels
+ *
+ * @param  	in		Camera* camera - Camera object
+ * 			in		double radius - radius of flat circle bottom of bowl
+ * 			out		Mat &bowl - CV_32FC3 matrix of fisheye image size. Every element contains template coordinates of
+ * 					the bowl point which is seen by the pixel or NaN if the pixel is not mapped to the defisheye image.
+ *
+ * @return 			-
+ *
+ * @remarks 		The function inverts the xmap/ymap transformation with the polynomial camera model, back-projects the
+ * 					defisheye pixel with camera parameters and intersects the ray with the bowl surface: flat base
+ * 					(z = 0) inside the base circle and z = -(r - radius)^2 outside of it.
+ *
+ **************************************************************************************************************/
+void Masks::getBowlMap(Camera* camera, double radius, Mat &bowl)
+{
+	float nan = numeric_limits<float>::quiet_NaN();
+	bowl.create(camera->xmap.rows, camera->xmap.cols, CV_32FC3);
+	bowl.setTo(Scalar(nan, nan, nan));
 
-		for(uint j = 0; j < seam2d.size(); j++)
+	if (camera->getK().empty() || camera->getTvec().empty()) {
+		return;
+	}
+
+	Matx33d K_inv = ((Matx33d)camera->getK()).inv();
+	Matx33d R_t = camera->getR().t();
+	Vec3d c = -(R_t * (Vec3d)camera->getTvec().reshape(1, 3)); // Camera position in template coordinates
+
+	// Bowl surface: g(p) < 0 inside the bowl and g(p) = 0 on the surface
+	auto g = [radius](const Vec3d &p) {
+		double r = MAX(sqrt(p[0] * p[0] + p[1] * p[1]) - radius, 0.0);
+		return (p[2] + r * r);
+	};
+
+	if (g(c) >= 0.0) {
+		cout << "Camera " << camera->index << " is located outside of the bowl" << endl;
+		return;
+	}
+
+	double z = (double)(-camera->model.model.img_size.width) / (double)camera->sf; // Z of defisheye image plane (see Defisheye::createLUT)
+	double xc_norm = (double)camera->model.model.img_size.width / 2.0;
+	double yc_norm = (double)camera->model.model.img_size.height / 2.0;
+	int width = camera->xmap.cols;
+	int height = camera->xmap.rows;
+
+	parallel_for_(Range(0, bowl.rows), [&](const Range& range)
+	{
+		vector<Point2f> pixels(bowl.cols);
+		vector<Point3f> rays(bowl.cols);
+		for (int row = range.start; row < range.end; row++)
 		{
-			if((seam2d[j].x < (float)camera->xmap.cols - 1.0f) && (seam2d[j].y < (float)camera->xmap.rows - 1.0f) && (seam2d[j].x > 0.0f) && (seam2d[j].y > 0.0f))
+			// Fisheye pixels of the row are back-projected together
+			for (int col = 0; col < bowl.cols; col++) {
+				pixels[col] = Point2f((float)row, (float)col);
+			}
+			camera->model.cam2world(pixels.data(), rays.data(), bowl.cols);
+
+			Vec3f* out = bowl.ptr<Vec3f>(row);
+			for (int col = 0; col < bowl.cols; col++)
 			{
-					seam.push_back(Point2f(camera->xmap.at<float>(seam2d[j]), camera->ymap.at<float>(seam2d[j])));
-					circle(img, seam[j], 1, color, 1);
+				// Fisheye pixel -> defisheye pixel
+				Point3d ray = (Point3d)rays[col];
+				if (ray.z >= 0.0) { continue; }
+				double u = ray.y * z / ray.z + xc_norm;
+				double v = ray.x * z / ray.z + yc_norm;
+				if ((u <= 0.0) || (v <= 0.0) || (u >= (double)width - 1.0) || (v >= (double)height - 1.0)) { continue; }
+
+				// Defisheye pixel -> ray in template coordinates
+				Vec3d dir = R_t * (K_inv * Vec3d(u, v, 1.0));
+				dir *= 1.0 / norm(dir);
+
+				// Bracket the bowl surface intersection. g is convex along the ray, so there is only one root.
+				double t_in = 0.0, t_out = 1.0;
+				int iter = 0;
+				while ((g(c + t_out * dir) < 0.0) && (iter < 32)) {
+					t_in = t_out;
+					t_out *= 2.0;
+					iter++;
+				}
+				if (iter == 32) { continue; }
+
+				for (iter = 0; iter < 32; iter++)
+				{
+					double t = 0.5 * (t_in + t_out);
+					if (g(c + t * dir) < 0.0) { t_in = t; }
+					else { t_out = t; }
+				}
+
+				Vec3d p = c + t_out * dir;
+				if (sqrt(p[0] * p[0] + p[1] * p[1]) <= radius) { p[2] = 0.0; }
+				out[col] = Vec3f((float)p[0], (float)p[1], (float)p[2]);
 			}
 		}
-		color += color_step;
-	}
+	});
 }
 
 
@@ -381,8 +657,9 @@ void Masks::smoothMaskEdge(Mat &img, Vec2b colors, Vec2d angles, double angle_st
  * 					1st point - left bottom vertex, 4th point - left top vertex, 5th point - right top vertex,
  * 					8th point - right bottom point. The polygon must be convex.
  * 			out		Seam &seam - polygons intersection (2 points + line that goes through them)
- * 			in		int rotation - direction of rotation for the second polygon. If rotation < 0, then the second polygon
- * 					is rotated on 90 degrees angle to the left. Otherwise it is rotated on 90 degrees angle to the right.
+ * 			in		float rotation - yaw difference of the second and the first polygons cameras (degrees). The second
+ * 					polygon is rotated counterclockwise by this angle. If rotation < 0, then the second polygon is the left
+ * 					neighbor of the first polygon. Otherwise it is the right neighbor.
  *
  * @return 			-
  *
@@ -392,9 +669,12 @@ void Masks::smoothMaskEdge(Mat &img, Vec2b colors, Vec2d angles, double angle_st
  * 					according to the rotation value.
  *
  **************************************************************************************************************/
-void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2, Seam &seam, int rotation)
+void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2, Seam &seam, float rotation)
 {
 	bool intersection = false;
+	double angle = (double)rotation * CV_PI / 180.0;
+	double c = cos(angle);
+	double s = sin(angle);
 
 
 	// Search for the first intersection point of input polygons
@@ -405,14 +685,14 @@ void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2,
 		while((pnt_2 >= 0) && (!intersection)) // pnt_2 can be only 1 and 0 (1st and 2nd polygon points)
 		{
 			Point2f p1_1, p1_2, p2_1, p2_2;
-			if(rotation < 0) // Rotate polygon2 points to the left
+			if(rotation < 0.0f) // Rotate polygon2 points to the left
 			{
 				// 1st polygon, side 2-1 or 1-8
 				p1_1 = Point2f(polygon1[pnt_2].x, polygon1[pnt_2].y);
 				p1_2 = Point2f(polygon1[previous_id(pnt_2, (int)polygon2.size() - 1)].x, polygon1[previous_id(pnt_2, (int)polygon2.size() - 1)].y);
 				// 2nd polygon, side 7-8 or 8-1
-				p2_1 = Point2f(polygon2[pnt_1].y, - polygon2[pnt_1].x);
-				p2_2 = Point2f(polygon2[next_id(pnt_1, (int)polygon2.size() - 1)].y, - polygon2[next_id(pnt_1, (int)polygon2.size() - 1)].x);
+				p2_1 = rotatePoint2d(polygon2[pnt_1], c, s);
+				p2_2 = rotatePoint2d(polygon2[next_id(pnt_1, (int)polygon2.size() - 1)], c, s);
 			}
 			else // Rotate polygon2 points to the right
 			{
@@ -420,8 +700,8 @@ void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2,
 				p1_1 = Point2f(polygon1[pnt_1].x, polygon1[pnt_1].y);
 				p1_2 = Point2f(polygon1[next_id(pnt_1, (int)polygon1.size() - 1)].x, polygon1[next_id(pnt_1, (int)polygon1.size() - 1)].y);
 				// 2nd polygon, side 1-0 or 0-8
-				p2_1 = Point2f(- polygon2[pnt_2].y, polygon2[pnt_2].x);
-				p2_2 = Point2f(- polygon2[previous_id(pnt_2, (int)polygon2.size() - 1)].y, polygon2[previous_id(pnt_2, (int)polygon2.size() - 1)].x);
+				p2_1 = rotatePoint2d(polygon2[pnt_2], c, s);
+				p2_2 = rotatePoint2d(polygon2[previous_id(pnt_2, (int)polygon2.size() - 1)], c, s);
 			}
 
 			// Calculate polygon sides intersection
@@ -438,7 +718,7 @@ void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2,
 			{
 				intersection = true; // Terminate searching process
 				double radius;
-				if(rotation < 0) // left
+				if(rotation < 0.0f) // left
 				{
 					radius = MAX(pow(polygon1[0].y, 2) + pow(polygon1[0].x, 2),
 								 pow(polygon2[polygon2.size() - 1].y, 2) + pow(polygon2[polygon2.size() - 1].x, 2));
@@ -474,15 +754,15 @@ void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2,
 	p1_5 = Point2f(polygon1[4].x, polygon1[4].y);
 
 	// 2st polygon, side 4-5
-	if(rotation < 0) // Rotate polygon2 points to the left
+	if(rotation < 0.0f) // Rotate polygon2 points to the left
 	{
-		p2_4 = Point2f(polygon1[3].y, - polygon1[3].x);
-		p2_5 = Point2f(polygon1[4].y, - polygon1[4].x);
+		p2_4 = rotatePoint2d(polygon1[3], c, s);
+		p2_5 = rotatePoint2d(polygon1[4], c, s);
 	}
 	else // Rotate polygon2 points to the right
 	{
-		p2_4 = Point2f(- polygon2[3].y, polygon2[3].x);
-		p2_5 = Point2f(- polygon2[4].y, polygon2[4].x);
+		p2_4 = rotatePoint2d(polygon2[3], c, s);
+		p2_5 = rotatePoint2d(polygon2[4], c, s);
 	}
 
 	// Calculate polygon sides intersection
@@ -492,3 +772,277 @@ void Masks::getSeamPoints(vector<Point3f> &polygon1, vector<Point3f> &polygon2,
 
 	seam.line = getAlphaBeta(seam.p1, seam.p2);
 }
+
+
+/**************************************************************************************************************
+ *
+ * @brief  			Get index of reflected border element (BORDER_REFLECT_101)
+ *
+ * @param  	in		int i - element index
+ * 			in		int len - line length
+ *
+ * @return 			The function returns index inside [0, len - 1].
+ *
+ * @remarks 		The index is reflected once, so it must be inside [-(len - 1), 2 * (len - 1)].
+ *
+ **************************************************************************************************************/
+static inline int reflect101(int i, int len)
+{
+	if (i < 0) { i = -i; }
+	if (i >= len) { i = 2 * (len - 1) - i; }
+	return(i);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Blur line with box filter
+ *
+ * @param  	in		const float* src - input line
+ * 			out		float* dst - output line
+ * 			in		int len - line length
+ * 			in		int radius - box filter radius (the box width is 2 * radius + 1)
+ *
+ * @return 			-
+ *
+ * @remarks 		The function uses running sum, so the cost per element does not depend on radius. The running sum
+ * 					reads up to len + radius, so the radius must not exceed len - 2.
+ *
+ **************************************************************************************************************/
+static void boxBlurLine(const float* src, float* dst, int len, int radius)
+{
+	float norm = 1.0f / (float)(2 * radius + 1);
+	float sum = 0.0f;
+	for (int j = -radius; j <= radius; j++) {
+		sum += src[reflect101(j, len)];
+	}
+
+	for (int x = 0; x < len; x++)
+	{
+		dst[x] = sum * norm;
+		sum += src[reflect101(x + radius + 1, len)] - src[reflect101(x - radius, len)];
+	}
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Feather mask rows
+ *
+ * @param  	in/out	Mat &img - mask (CV_8UC1)
+ * 			in		double sigma - standard deviation of the feathering Gaussian
+ *
+ * @return 			-
+ *
+ * @remarks 		Every mask row is blurred in horizontal direction with Gaussian kernel which is truncated to
+ * 					the radius (rows - row) / 2, so the feathering is wider at the top of the fisheye frame.
+ * 					Rows which radius is bigger than 4 * sigma are filtered with FEATHER_PASSES running sum
+ * 					box filters of constant cost per pixel. Shorter kernels are convolved directly. Rows are
+ * 					processed in parallel.
+ *
+ **************************************************************************************************************/
+void Masks::featherMask(Mat &img, double sigma)
+{
+	if ((img.type() != CV_8UC1) || (img.cols < 2) || (sigma <= 0.0)) {
+		return;
+	}
+
+	int max_radius = (int)ceil(4.0 * sigma); // Longer kernels are equal to not truncated Gaussian
+
+	// Truncated Gaussian kernels for short radii
+	vector< vector<float> > kernels((uint)max_radius + 1U);
+	for (int r = 1; r <= max_radius; r++)
+	{
+		Mat k = getGaussianKernel(2 * r + 1, sigma, CV_32F);
+		kernels[(uint)r].assign((float*)k.data, (float*)k.data + 2 * r + 1);
+	}
+
+	// Box widths which approximate Gaussian with FEATHER_PASSES running sums
+	int box_radius[FEATHER_PASSES];
+	double w_ideal = sqrt(12.0 * sigma * sigma / (double)FEATHER_PASSES + 1.0);
+	int wl = (int)floor(w_ideal);
+	if ((wl % 2) == 0) { wl--; }
+	int m = (int)round((12.0 * sigma * sigma - (double)(FEATHER_PASSES * wl * wl + 4 * FEATHER_PASSES * wl + 3 * FEATHER_PASSES)) / (double)(-4 * wl - 4));
+	m = MIN(MAX(m, 0), FEATHER_PASSES);
+	for (int p = 0; p < FEATHER_PASSES; p++) {
+		box_radius[p] = MIN((((p < m) ? wl : wl + 2) - 1) / 2, img.cols - 2); // Border is reflected once
+	}
+
+	parallel_for_(Range(0, img.rows), [&](const Range& range)
+	{
+		vector<float> line_a((uint)img.cols), line_b((uint)img.cols);
+
+		for (int row = range.start; row < range.end; row++)
+		{
+			int radius = MIN((img.rows - row) / 2, img.cols - 1); // Kernel radius of the current row
+			if (radius == 0) { continue; }
+
+			uchar* data = img.ptr<uchar>(row);
+			for (int x = 0; x < img.cols; x++) {
+				line_a[(uint)x] = (float)data[x];
+			}
+
+			float* out = NULL;
+			if (radius > max_radius)
+			{
+				float* src = line_a.data();
+				float* dst = line_b.data();
+				for (int p = 0; p < FEATHER_PASSES; p++)
+				{
+					boxBlurLine(src, dst, img.cols, box_radius[p]);
+					swap(src, dst);
+				}
+				out = src;
+			}
+			else
+			{
+				const float* k = kernels[(uint)radius].data();
+				for (int x = 0; x < img.cols; x++)
+				{
+					float sum = 0.0f;
+					for (int j = -radius; j <= radius; j++) {
+						sum += k[j + radius] * line_a[(uint)reflect101(x + j, img.cols)];
+					}
+					line_b[(uint)x] = sum;
+				}
+				out = line_b.data();
+			}
+
+			for (int x = 0; x < img.cols; x++) {
+				data[x] = saturate_cast<uchar>(out[x]);
+			}
+		}
+	});
+}
+
+
+/**************************************************************************************************************
+ *
+ * @brief  			Get mask value at texel
+ *
+ * @param  	in		const Mat &mask - mask (CV_8UC1)
+ * 			in		float tx, float ty - normalized texel coordinates
+ *
+ * @return 			The function returns bilinear interpolated mask value in [0, 255]. Texels outside of the mask
+ * 					get the value of the nearest mask pixel.
+ *
+ * @remarks 		Pixel centers are placed at (i + 0.5) / size as in the texture sampling of the renderer.
+ *
+ **************************************************************************************************************/
+float Masks::getWeight(const Mat &mask, float tx, float ty)
+{
+	float x = min(max(tx * (float)mask.cols - 0.5f, 0.0f), (float)(mask.cols - 1));
+	float y = min(max(ty * (float)mask.rows - 0.5f, 0.0f), (float)(mask.rows - 1));
+	int x0 = (int)x;
+	int y0 = (int)y;
+	int x1 = min(x0 + 1, mask.cols - 1);
+	int y1 = min(y0 + 1, mask.rows - 1);
+	float ax = x - (float)x0;
+	float ay = y - (float)y0;
+
+	const uchar* r0 = mask.ptr<uchar>(y0);
+	const uchar* r1 = mask.ptr<uchar>(y1);
+	float v0 = (float)r0[x0] + ((float)r0[x1] - (float)r0[x0]) * ax;
+	float v1 = (float)r1[x0] + ((float)r1[x1] - (float)r1[x0]) * ax;
+	return(v0 + (v1 - v0) * ay);
+}
+
+
+/**************************************************************************************************************
+ *
+ * @brief  			Bake blend weights into the overlap grid triangle
+ *
+ * @param  	in		const Mat &mask - mask (CV_8UC1)
+ * 			in		const Vec6f* tri - triangle vertices (vx vy vz tx ty w), w is the mask value in [0, 255]
+ * 			in		int depth - subdivision depth of the triangle
+ * 			in/out	EdgeSplits &splits - split decisions of the grid edges which have been already processed
+ * 			out		vector<float> &out - weighted grid the triangles are appended to (vx vy vz tx ty w, w in [0, 1])
+ *
+ * @return 			-
+ *
+ * @remarks 		Every triangle edge is split at its midpoint if the mask value at the midpoint differs from the
+ * 					mean of the edge vertex weights by more than WEIGHT_TOLERANCE, the edge is not shorter than
+ * 					WEIGHT_MIN_EDGE mask pixels and the triangle is not deeper than WEIGHT_DEPTH. The decision is
+ * 					made by the first triangle which reaches the edge and it is stored in splits, so the adjacent
+ * 					triangle splits the shared edge in the same way whatever its depth is, and the densified grid
+ * 					has no T-junctions. The triangle is divided into 2, 3 or 4 triangles according to the number
+ * 					of split edges, and they are processed recursively. Triangles inside the smooth part of the
+ * 					overlap keep the original size.
+ *
+ **************************************************************************************************************/
+void Masks::bakeWeights(const Mat &mask, const Vec6f* tri, int depth, EdgeSplits &splits, vector<float> &out)
+{
+	Vec6f mid[3];
+	bool split[3];
+	int split_num = 0;
+	for (int k = 0; k < 3; k++)
+	{
+		const Vec6f &a = tri[k];
+		const Vec6f &b = tri[(k + 1) % 3];
+		mid[k] = (a + b) * 0.5f;
+		mid[k][5] = getWeight(mask, mid[k][3], mid[k][4]);
+
+		// The edge is looked up by its ends texels in the same order from both adjacent triangles
+		bool swap_ends = (b[3] < a[3]) || ((b[3] == a[3]) && (b[4] < a[4]));
+		tuple<float, float, float, float> key = swap_ends ? make_tuple(b[3], b[4], a[3], a[4]) : make_tuple(a[3], a[4], b[3], b[4]);
+		EdgeSplits::iterator edge = splits.find(key);
+		if (edge == splits.end())
+		{
+			float len = (float)norm(Point2f((a[3] - b[3]) * (float)mask.cols, (a[4] - b[4]) * (float)mask.rows));
+			bool split_edge = (depth < WEIGHT_DEPTH) && (len >= WEIGHT_MIN_EDGE) &&
+							  (abs(mid[k][5] - (a[5] + b[5]) * 0.5f) > WEIGHT_TOLERANCE);
+			edge = splits.insert(make_pair(key, split_edge)).first;
+		}
+		split[k] = edge->second;
+		if (split[k]) { split_num++; }
+	}
+
+	if (split_num == 0) // Linear interpolation follows the mask
+	{
+		for (int k = 0; k < 3; k++) {
+			out.insert(out.end(), {tri[k][0], tri[k][1], tri[k][2], tri[k][3], tri[k][4], tri[k][5] / 255.0f});
+		}
+		return;
+	}
+
+	int k = 0;
+	if (split_num == 1) {
+		while (!split[k]) { k++; }
+	}
+	else if (split_num == 2) {
+		while (split[k]) { k++; }
+	}
+
+	const Vec6f &a = tri[k];
+	const Vec6f &b = tri[(k + 1) % 3];
+	const Vec6f &c = tri[(k + 2) % 3];
+	const Vec6f &m0 = mid[k];
+	const Vec6f &m1 = mid[(k + 1) % 3];
+	const Vec6f &m2 = mid[(k + 2) % 3];
+
+	if (split_num == 1) // Edge a-b is split
+	{
+		const Vec6f t0[3] = {a, m0, c};
+		const Vec6f t1[3] = {m0, b, c};
+		bakeWeights(mask, t0, depth + 1, splits, out);
+		bakeWeights(mask, t1, depth + 1, splits, out);
+	}
+	else if (split_num == 2) // Edges b-c and c-a are split
+	{
+		const Vec6f t0[3] = {m1, c, m2};
+		const Vec6f t1[3] = {a, b, m1};
+		const Vec6f t2[3] = {a, m1, m2};
+		bakeWeights(mask, t0, depth + 1, splits, out);
+		bakeWeights(mask, t1, depth + 1, splits, out);
+		bakeWeights(mask, t2, depth + 1, splits, out);
+	}
+	else // All edges are split
+	{
+		const Vec6f t0[3] = {a, m0, m2};
+		const Vec6f t1[3] = {m0, b, m1};
+		const Vec6f t2[3] = {m2, m1, c};
+		const Vec6f t3[3] = {m0, m1, m2};
+		bakeWeights(mask, t0, depth + 1, splits, out);
+		bakeWeights(mask, t1, depth + 1, splits, out);
+		bakeWeights(mask, t2, depth + 1, splits, out);
+		bakeWeights(mask, t3, depth + 1, splits, out);
+	}
+}
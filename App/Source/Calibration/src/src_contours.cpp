@@ -58,135 +58,189 @@
 
 #include "src_contours.hpp"
 
+/**************************************************************************************************************
+ *
+ * @brief  			Calculate local mean of the image from its integral image
+ *
+ * @param  	in		const Mat &sum - integral image (CV_32S) of the input image padded by pad pixels on each side
+ * 			in		int pad - padding of the integral image source
+ * 			in		int block_size - size of the pixel neighborhood (odd)
+ * 			out		Mat &mean - local mean of each pixel of the input image (CV_8U)
+ *
+ * @return 			-
+ *
+ * @remarks 		The function replaces the box filter of the adaptive threshold. Sum of each block is taken
+ * 					as 4 reads of the integral image, so the cost does not depend on the block size.
+ * 					The padding is replicated border, as in adaptiveThreshold().
+ *
+ **************************************************************************************************************/
+static void IntegralMean(const Mat &sum, int pad, int block_size, Mat &mean)
+{
+	int r = block_size / 2;
+	int area = block_size * block_size;
+	mean.create(sum.rows - 2 * pad - 1, sum.cols - 2 * pad - 1, CV_8UC1);
+
+	parallel_for_(Range(0, mean.rows), [&](const Range &range) {
+		for (int y = range.start; y < range.end; y++)
+		{
+			const int* top = sum.ptr<int>(y + pad - r);
+			const int* bottom = sum.ptr<int>(y + pad + r + 1);
+			uchar* dst = mean.ptr<uchar>(y);
+			for (int x = 0; x < mean.cols; x++)
+			{
+				int x0 = x + pad - r;
+				int x1 = x + pad + r + 1;
+				int s = bottom[x1] - bottom[x0] - top[x1] + top[x0];
+				dst[x] = (uchar)((s + area / 2) / area);
+			}
+		}
+	});
+}
+
+
+/**************************************************************************************************************
+ *
+ * @brief  			Search quadrangles in thresholded image
+ *
+ * @param  	in/out	ContourPass &pass - pass buffers. The pass.threshold is the input binary image,
+ * 							pass.quads is the output.
+ *			in		int min_size - empiric bound for minimal allowed perimeter for contour squares
+ *
+ * @return 			-
+ *
+ * @remarks 		The function searches contours in the binary image, approximates them by polygons and
+ * 					keeps convex quadrangles only. Found quadrangles are filtered by FilterContours().
+ * 					Only the pass buffers are used, so passes can run concurrently.
+ *
+ **************************************************************************************************************/
+static void FindQuads(ContourPass &pass, int min_size)
+{
+	ContourQuads &quads = pass.quads;
+	quads.corners.clear();
+	quads.area.clear();
+	quads.source.clear();
+	quads.parent.clear();
+
+	findContours(pass.threshold, pass.contours, pass.hierarchy, RETR_CCOMP, CHAIN_APPROX_SIMPLE);
+
+	for (int idx = 0; idx < (int)pass.contours.size(); idx++)
+	{
+		const vector<Point> &src_contour = pass.contours[idx];
+		Rect rect = boundingRect(src_contour);
+
+		// reject contours with too small perimeter
+		if (rect.width * rect.height < min_size) { continue; }
+
+		int cur = 0;
+		for (int approx_level = 1; approx_level <= MAX_CONTOUR_APPROX; approx_level++)
+		{
+			approxPolyDP(src_contour, pass.approx[0], (double)approx_level, true);
+			cur = 0;
+			if (pass.approx[0].size() == 4) { break; }
+
+			// we call this again on its own output, because sometimes
+			// approxPolyDP() does not simplify as much as it should.
+			approxPolyDP(pass.approx[0], pass.approx[1], (double)approx_level, true);
+			cur = 1;
+			if (pass.approx[1].size() == 4) { break; }
+		}
+
+		// reject non-quadrangles
+		const vector<Point> &dst_contour = pass.approx[cur];
+		if ((dst_contour.size() != 4) || !isContourConvex(dst_contour)) { continue; }
+
+		double area = fabs(contourArea(dst_contour));
+		if (area <= (double)min_size) { continue; }
+
+		bool inside = true;
+		for (int i = 0; i < 4; i++) {
+			inside = inside && (dst_contour[i].x > 10) && (dst_contour[i].y > 10);
+		}
+		if (!inside) { continue; }
+
+		quads.corners.insert(quads.corners.end(), dst_contour.begin(), dst_contour.end());
+		quads.area.push_back(area);
+		quads.source.push_back(idx);
+		quads.parent.push_back(pass.hierarchy[idx][3]);
+	}
+
+	// filter found contours
+	FilterContours(pass);
+}
+
+
 /**************************************************************************************************************
  *
  * @brief  			Search contours in input image
  *
  * @param  	in		const Mat &img - input image
- * 			in/out	CvSeq** root - sequence of contours
- * 			in		CvMemStorage *mem_storage - memory storage
+ * 			out		ContourQuads &quads - found quadrangles
+ * 			in/out	ContourBuffers &buf - scratch buffers
  *			in		int min_size - empiric bound for minimal allowed perimeter for contour squares
  *
  * @return 			Functions returns the number of contours which were found.
  *
  * @remarks 		The function applies adaptive threshold on input image and searches contours in image.
- * 					If 4 contours are found then function has been terminated. Otherwise it changes block size
- * 					for adaptive threshold and tries again.
+ * 					THRESH_PASSES thresholds with different block sizes and offsets are checked concurrently,
+ * 					each pass in its own buffers. The result of the first pass (in pass order) which found
+ * 					4 contours is copied to the quads. If no pass found 4 contours then the result of the last
+ * 					pass is returned.
  *
  **************************************************************************************************************/
-int GetContours(const Mat &img, CvSeq** root, CvMemStorage *mem_storage, int min_size)
+int GetContours(const Mat &img, ContourQuads &quads, ContourBuffers &buf, int min_size)
 {
-	const int min_dilations = 0;
-	const int max_dilations = 0;
-
-	Mat temp_threshold_rgb(img.rows, img.cols, CV_8UC3, Scalar(0, 0, 0, 0));
-	
-	for (int k = 0; k < 6; k++) {
-		int block_size = static_cast<int>((uint)cvRound((float)MIN(img.cols, img.rows) * (k % 2 == 0 ? 0.2 : 0.1)) | 1U);
-		for (int dilations = min_dilations; dilations <= max_dilations; dilations++)
+	/*********************** Local mean ***************************/
+	// Block sizes alternate between 20% and 10% of the image size, so only 2 mean images are required
+	int block_size[2];
+	for (int i = 0; i < 2; i++) {
+		block_size[i] = static_cast<int>((uint)cvRound((float)MIN(img.cols, img.rows) * (i == 0 ? 0.2 : 0.1)) | 1U);
+	}
+	int pad = MAX(block_size[0], block_size[1]) / 2;
+
+	copyMakeBorder(img, buf.padded, pad, pad, pad, pad, BORDER_REPLICATE);
+	integral(buf.padded, buf.sum, CV_32S);
+
+	for (int i = 0; i < 2; i++) {
+		IntegralMean(buf.sum, pad, block_size[i], buf.mean[i]);
+	}
+
+	/*********************** Threshold passes ***********************/
+	buf.pass.resize(THRESH_PASSES);
+
+	parallel_for_(Range(0, THRESH_PASSES), [&](const Range &range) {
+		for (int k = range.start; k < range.end; k++)
 		{
-			Mat temp_threshold;
-			Mat temp_threshold_rgb(img.rows, img.cols, CV_8UC3, Scalar(0, 0, 0, 0));
-
-			/*********************** Thresholding ***************************/
-#if 1
-			//Adaptive threshold
-			adaptiveThreshold(img, temp_threshold, 255.0, CV_ADAPTIVE_THRESH_MEAN_C, CV_THRESH_BINARY, block_size, static_cast<double>(k / 2) * 5.0);
-#else
-			// Empiric threshold level
-			double mean = cvAvg(img).val[0];
-			int thresh_level = cvRound(mean - 10);
-			thresh_level = MAX(thresh_level, 10);
-
-			threshold(img, temp_threshold, thresh_level, 255, CV_THRESH_BINARY);
-#endif
-
-			/*********************** Generate Quads ***********************/
-			IplImage copy = cvIplImage(temp_threshold);
-			IplImage* tmp = &copy;
-
-			// create temporary storage for contours and the sequence of pointers to found quadrangles
-			Ptr<CvMemStorage> temp_storage;
-			temp_storage = cvCreateChildMemStorage( mem_storage );
-			*root = cvCreateSeq( 0, sizeof(CvSeq), sizeof(CvSeq*), temp_storage );
-
-			 // initialize contour retrieving routine
-			CvContourScanner scanner = cvStartFindContours(tmp, temp_storage, sizeof(CvContourEx), RETR_CCOMP, CV_CHAIN_APPROX_SIMPLE );
-
-			// get all the contours one by one
-			CvSeq *src_contour = 0;
-			while( (src_contour = cvFindNextContour( scanner )) != 0 )
+			ContourPass &pass = buf.pass[k];
+
+			// Adaptive threshold: dst = (src > mean - delta) ? 255 : 0
+			int delta = (k / 2) * 5;
+			const Mat &m = buf.mean[k % 2];
+			pass.threshold.create(img.rows, img.cols, CV_8UC1);
+			for (int y = 0; y < img.rows; y++)
 			{
-		        	CvSeq *dst_contour = 0;
-			        CvRect rect = ((CvContour*)src_contour)->rect;
-
-			        // reject contours with too small perimeter
-			        if(rect.width*rect.height >= min_size )
-		        	{
-					int approx_level;
-		            		const int min_approx_level = 1, max_approx_level = MAX_CONTOUR_APPROX;
-		            		for( approx_level = min_approx_level; approx_level <= max_approx_level; approx_level++ )
-		            		{
-		                		dst_contour = cvApproxPoly( src_contour, sizeof(CvContour), temp_storage, CV_POLY_APPROX_DP, (float)approx_level );
-
-						if(dst_contour != NULL) {
-			                		if( dst_contour->total == 4 ) { 
-			                    			break;
-							}
-						}
-
-		                		// we call this again on its own output, because sometimes
-			                	// cvApproxPoly() does not simplify as much as it should.
-			                	dst_contour = cvApproxPoly( dst_contour, sizeof(CvContour), temp_storage, CV_POLY_APPROX_DP, (float)approx_level );
-				
-						if(dst_contour != NULL) {
-				                	if( dst_contour->total == 4 ) { 
-			        	        		break;
-							}
-						}
-					}
-	
-					if(dst_contour != NULL) { 	
-						// reject non-quadrangles
-				       		if((dst_contour->total == 4) && (cvCheckContourConvexity(dst_contour) != 0))
-						{
-							if(fabs(cvContourArea(dst_contour, CV_WHOLE_SEQ)) > (float)min_size )
-							{
-								CvPoint pt[4];
-								for(int i = 0; i < 4; i++ ) {
-									pt[i] = *(CvPoint*)cvGetSeqElem(dst_contour, i);
-								}
-		
-        		  	        	        	if((pt[0].x > 10) && (pt[0].y > 10) && (pt[1].x > 10) && (pt[1].y > 10) &&
-          			                		   (pt[2].x > 10) && (pt[2].y > 10) && (pt[3].x > 10) && (pt[3].y > 10)) {
-									CvContourEx* parent = (CvContourEx*)(src_contour->v_prev);
-									parent->counter++;
-									dst_contour->v_prev = (CvSeq*)parent;
-									cvSeqPush(*root, &dst_contour);
-								}
-							}
-						}
-					}
+				const uchar* src = img.ptr<uchar>(y);
+				const uchar* avg = m.ptr<uchar>(y);
+				uchar* dst = pass.threshold.ptr<uchar>(y);
+				for (int x = 0; x < img.cols; x++) {
+					dst[x] = ((int)src[x] - (int)avg[x] > -delta) ? 255 : 0;
 				}
 			}
-			// finish contour retrieving
- 			cvEndFindContours(&scanner);
 
-			// filter found contours
-			if((*root) != NULL) {
-	 			FilterContours(root);
-			}
+			FindQuads(pass, min_size);
 		}
-		// if 4 contours are detected, then break
-		if((*root) != NULL) {
-			if((*root)->total == CONTOURS_NUM) {
-				break;
-			}
+	});
+
+	/*********************** Merge passes ***************************/
+	int result = THRESH_PASSES - 1;
+	for (int k = 0; k < THRESH_PASSES; k++) {
+		if ((int)buf.pass[k].quads.area.size() == CONTOURS_NUM) {
+			result = k;
+			break;
 		}
 	}
-	
-	if((*root) != NULL) { return ((*root)->total); }
-	else { return(0); }
+
+	quads = buf.pass[result].quads;
+	return ((int)quads.area.size());
 }
 
 
@@ -194,66 +248,49 @@ int GetContours(const Mat &img, CvSeq** root, CvMemStorage *mem_storage, int min
  *
  * @brief  			Filter found contours.
  *
- * @param  	in/out	CvSeq** root - sequence of contours
+ * @param  	in/out	ContourPass &pass - pass buffers with found quadrangles
  *
  * @return 			-
  *
- * @remarks 		The function checks all contours from the input sequence and removes contours
- * 					which are not located inside another sequence contour or which do not contain
- * 					another sequence contour.
+ * @remarks 		The function removes quads which are not paired with another quad: a hole quad is kept
+ * 					if its outer contour has produced a quad and an object quad is kept if one of its holes
+ * 					has produced a quad. The check is a single pass over the quads.
  *
  **************************************************************************************************************/
-void FilterContours(CvSeq** root)
+void FilterContours(ContourPass &pass)
 {
-	int idx = (*root)->total - 1; // index of the last sequence contour
-	int contours_num = (*root)->total; // number of contours
-	// for each sequence contour
-	while(idx >= 0)
-	{
-		if(cvGetSeqElem(*root, idx) == NULL) { return; }
-		CvSeq * src_contour = *(CvSeq**)cvGetSeqElem(*root, idx); // get idx contour
-		if(src_contour == NULL) { return; }
-		// get contour points
-		vector<Point2f> contour_1;
-		for(int i = 0; i < src_contour->total; i++) {
-			if(cvGetSeqElem(src_contour, i) != NULL) {
-				contour_1.push_back(*(CvPoint*)cvGetSeqElem(src_contour, i));
-			}
-		}
-
-		bool contours_test = false;
-		for(int j = 0; j < contours_num; j++)
-		{
-			if(cvGetSeqElem(*root, j) != NULL) {
-				CvSeq * contour = *(CvSeq**)cvGetSeqElem(*root, j); // get j contour
-				// get contour points
-				vector<Point2f> contour_2;
-				for(int i = 0; i < contour->total; i++) {
-					if(cvGetSeqElem(contour, i) != NULL) {
-						contour_2.push_back(*(CvPoint*)cvGetSeqElem(contour, i));
-					}
-				}
+	ContourQuads &quads = pass.quads;
+	int quads_num = (int)quads.area.size();
+
+	// mark contours which have produced a quad
+	pass.has_quad.assign(pass.contours.size(), 0);
+	pass.has_child.assign(pass.contours.size(), 0);
+	for (int i = 0; i < quads_num; i++) {
+		pass.has_quad[quads.source[i]] = 1;
+		if (quads.parent[i] >= 0) { pass.has_child[quads.parent[i]] = 1; }
+	}
 
-				bool is_inside = true; // idx contour is inside another contour
-				bool is_outside = true; // another contour is inside the idx contour
-				for(int i = 0; i < contour->total; i++) {
-					is_inside = is_inside && (pointPolygonTest(contour_1, contour_2[i], false) > 0.0f); // check all points of contour
-					is_outside = is_outside && (pointPolygonTest(contour_2, contour_1[i], false) > 0.0f); // check all points of contour
-				}
-				if(is_inside || is_outside) // if idx contour is inside j contour or j contour is inside idx contour
-				{
-					contours_test = true; // don't remove contour
-					break;
-				}
+	// compact paired quads in place
+	int num = 0;
+	for (int i = 0; i < quads_num; i++)
+	{
+		bool paired = (quads.parent[i] >= 0) ? (pass.has_quad[quads.parent[i]] != 0) : (pass.has_child[quads.source[i]] != 0);
+		if (!paired) { continue; }
+		if (num != i) {
+			for (int j = 0; j < 4; j++) {
+				quads.corners[4 * num + j] = quads.corners[4 * i + j];
 			}
+			quads.area[num] = quads.area[i];
+			quads.source[num] = quads.source[i];
+			quads.parent[num] = quads.parent[i];
 		}
-		if(!contours_test)
-		{
-			cvSeqRemove(*root, idx); // remove contour
-			contours_num--; // decrease contours number
-		}
-		idx--; // next contour
+		num++;
 	}
+
+	quads.corners.resize(4 * num);
+	quads.area.resize(num);
+	quads.source.resize(num);
+	quads.parent.resize(num);
 }
 
 
@@ -261,7 +298,7 @@ void FilterContours(CvSeq** root)
  *
  * @brief  			Sort contours from left to right
  *
- * @param  	in		CvSeq** root - sequence of contours
+ * @param  	in/out	ContourQuads &quads - quadrangles
  *
  * @return 			-
  *
@@ -269,48 +306,45 @@ void FilterContours(CvSeq** root)
  * 					according to this value from left to right.
  *
  **************************************************************************************************************/
-void SortContours(CvSeq** root)
+void SortContours(ContourQuads &quads)
 {
-	CvSeq * src_contour[CONTOURS_NUM];
-	CvPoint pt[CONTOURS_NUM][4];
+	if ((int)quads.area.size() != CONTOURS_NUM) { return; }
+
 	int min_x[CONTOURS_NUM] = {0};
 	int sort_seq[CONTOURS_NUM] = {0};
 
 	// Search min value of contour points in X axis
-    for(int idx = 0; idx < CONTOURS_NUM; idx++)
-    {
-	if(cvGetSeqElem(*root, idx) != NULL) {
-	    	src_contour[idx] = *(CvSeq**)cvGetSeqElem(*root, idx);
-	
-        	for(int i = 0; i < 4; i++) {
-	            if(cvGetSeqElem(src_contour[idx], i) != NULL) {
-        	        pt[idx][i] = *(CvPoint*)cvGetSeqElem(src_contour[idx], i);
-	            }
-        	}
-
-	        min_x[idx] = MIN4(pt[idx][0].x, pt[idx][1].x, pt[idx][2].x, pt[idx][3].x);
-        	sort_seq[idx] = idx;
+	for (int idx = 0; idx < CONTOURS_NUM; idx++)
+	{
+		const Point* pt = &quads.corners[4 * idx];
+		min_x[idx] = MIN4(pt[0].x, pt[1].x, pt[2].x, pt[3].x);
+		sort_seq[idx] = idx;
+	}
+
+	// Sort contours from left to right
+	for (int j = 0; j < CONTOURS_NUM; j++) {
+		for (int i = j + 1; i < CONTOURS_NUM; i++)
+		{
+			if (min_x[sort_seq[i]] < min_x[sort_seq[j]]) {
+				int tmp = sort_seq[j];
+				sort_seq[j] = sort_seq[i];
+				sort_seq[i] = tmp;
+			}
+		}
+	}
+
+	// Reorder quads fields
+	ContourQuads src = quads;
+	for (int idx = 0; idx < CONTOURS_NUM; idx++)
+	{
+		int s = sort_seq[idx];
+		for (int j = 0; j < 4; j++) {
+			quads.corners[4 * idx + j] = src.corners[4 * s + j];
+		}
+		quads.area[idx] = src.area[s];
+		quads.source[idx] = src.source[s];
+		quads.parent[idx] = src.parent[s];
 	}
-    }
-
-    // Sort contours from left to right
-    for(int j = 0; j < CONTOURS_NUM; j++) {
-        for(int i = j + 1; i < CONTOURS_NUM; i++)
-        {
-        	if(min_x[sort_seq[i]] < min_x[sort_seq[j]]){
-        		int tmp = sort_seq[j];
-        		sort_seq[j] = sort_seq[i];
-        		sort_seq[i] = tmp;
-        	}
-        }
-    }
-
-    // Push sorted contours to the input vector
-    cvClearSeq(*root);
-    for(int idx = 0; idx < CONTOURS_NUM; idx++)
-    {
-    	cvSeqPush(*root, &src_contour[sort_seq[idx]]);
-    }
 }
 
 
@@ -318,7 +352,7 @@ void SortContours(CvSeq** root)
  *
  * @brief  			Generate vector of contour points in proper order.
  *
- * @param  	in		CvSeq** root - sequence of contours
+ * @param  	in		const ContourQuads &quads - quadrangles
  * 			out		vector<Point2f> * feature_points
  * 			in		Point2f shift
  *
@@ -328,35 +362,24 @@ void SortContours(CvSeq** root)
  * 					coordinates and push the corners to the feature_points array in proper order.
  *
  **************************************************************************************************************/
-void GetFeaturePoints(CvSeq** root, vector<Point2f> &feature_points, Point2f shift)
+void GetFeaturePoints(const ContourQuads &quads, vector<Point2f> &feature_points, Point2f shift)
 {
-	if((*root) == NULL) { return; }
-	if((*root)-> total != 4) { return; }
-
-    	// Sort contour points clockwise (start from the top left point)
-   	for(int idx = 0; idx < 4; idx++)
-    	{
-		if(cvGetSeqElem(*root, idx) == NULL) { return; }
-    		CvSeq * src_contour = *(CvSeq**)cvGetSeqElem(*root, idx);
-		if(src_contour == NULL) { return; }
-	        CvPoint pt[4];
-
-        	for(int i = 0; i < 4; i++) {
-			if(cvGetSeqElem(src_contour, i) != NULL) {
-				pt[i] = *(CvPoint*)cvGetSeqElem(src_contour, i);
-			}
-			else { pt[i] = CvPoint{0, 0}; }
- 		}
-
-	        // Calculate Y coordinate of the contour center point
-        	float ym;
-	       	if(pt[0].x == pt[2].x) {
-        	   	ym = static_cast<float>(pt[0].y + pt[2].y) / 2.0f;
-	       	}
-        	else if(pt[1].x == pt[3].x) {
-       			ym = static_cast<float>(pt[1].y + pt[3].y) / 2.0f;
-       	 	}
-        	else {
+	if (quads.area.size() != 4) { return; }
+
+	// Sort contour points clockwise (start from the top left point)
+	for (int idx = 0; idx < 4; idx++)
+	{
+		const Point* pt = &quads.corners[4 * idx];
+
+		// Calculate Y coordinate of the contour center point
+		float ym;
+		if (pt[0].x == pt[2].x) {
+			ym = static_cast<float>(pt[0].y + pt[2].y) / 2.0f;
+		}
+		else if (pt[1].x == pt[3].x) {
+			ym = static_cast<float>(pt[1].y + pt[3].y) / 2.0f;
+		}
+		else {
 			float a1 = static_cast<float>(pt[2].y - pt[0].y) / static_cast<float>(pt[2].x - pt[0].x);
 			float b1 = static_cast<float>(pt[0].y * pt[2].x - pt[2].y * pt[0].x) / static_cast<float>(pt[2].x - pt[0].x);
 
@@ -364,70 +387,59 @@ void GetFeaturePoints(CvSeq** root, vector<Point2f> &feature_points, Point2f shi
 			float b2 = static_cast<float>(pt[1].y * pt[3].x - pt[3].y * pt[1].x) / static_cast<float>(pt[3].x - pt[1].x);
 
 			ym = (a1 * b2 - a2 * b1) / (a1 - a2);
-        	}
+		}
 
-        	// Sort contours corners from top-left clockwise
-        	CvPoint pt_[4] = {0};
-        	for(uint i = 0U; i < 4U; i++)
-        	{
+		// Sort contours corners from top-left clockwise
+		Point pt_[4];
+		bool is_hole = (quads.parent[idx] >= 0);
+		for (uint i = 0U; i < 4U; i++)
+		{
 			bool flag = false;
-        		// Contours found by findContours function has direction. Objects are counter-clockwise, and holes are clockwise
-	        	if(CV_IS_SEQ_HOLE(src_contour)) { // Holes
-        			if(((float)pt[i].y <= ym) && ((float)pt[(i + 1U) & 3U].y <= ym)){
-        		        	pt_[0] = pt[i];
-        	        		pt_[1] = pt[(i + 1U) & 3U];
-        	        		pt_[2] = pt[(i + 2U) & 3U];
-	        	        	pt_[3] = pt[(i + 3U) & 3U];
+			// Contours found by findContours function has direction. Objects are counter-clockwise, and holes are clockwise
+			if (is_hole) { // Holes
+				if (((float)pt[i].y <= ym) && ((float)pt[(i + 1U) & 3U].y <= ym)) {
+					pt_[0] = pt[i];
+					pt_[1] = pt[(i + 1U) & 3U];
+					pt_[2] = pt[(i + 2U) & 3U];
+					pt_[3] = pt[(i + 3U) & 3U];
 					flag = true;
-        			}
-	        	}
-        		else { // Objects
-        			if(((float)pt[i].y <= ym) && ((float)pt[(i + 3U) & 3U].y <= ym)){
+				}
+			}
+			else { // Objects
+				if (((float)pt[i].y <= ym) && ((float)pt[(i + 3U) & 3U].y <= ym)) {
 					pt_[0] = pt[i];
- 					pt_[1] = pt[(i + 3U) & 3U];
+					pt_[1] = pt[(i + 3U) & 3U];
 					pt_[2] = pt[(i + 2U) & 3U];
 					pt_[3] = pt[(i + 1U) & 3U];
 					flag = true;
-        			}
-	        	}
+				}
+			}
 			if (flag) { break; }
-	        }
-        	for(int i = 0; i < 4; i++) {
-	        	feature_points.push_back(Point2f((float)pt_[i].x + shift.x, (float)pt_[i].y + shift.y));
 		}
-    	}
+		for (int i = 0; i < 4; i++) {
+			feature_points.push_back(Point2f((float)pt_[i].x + shift.x, (float)pt_[i].y + shift.y));
+		}
+	}
 }
 
 
 /**************************************************************************************************************
  *
- * @brief  			Convert contours sequence into the vector of points.
+ * @brief  			Convert contours into the vector of points.
  *
- * @param  	in		CvSeq** root - sequence of contours
+ * @param  	in		const ContourQuads &quads - quadrangles
  * 			out		vector<Point2f> * feature_points
  * 			in		Point2f shift
  *
  * @return 			-
  *
- * @remarks 		The function convert sequence of contours into points array. The shift is applied on corners
+ * @remarks 		The function convert quadrangles into points array. The shift is applied on corners
  * 					coordinates.
  *
  **************************************************************************************************************/
-void sec2vector(CvSeq** root, vector<Point2f> &feature_points, Point2f shift)
+void sec2vector(const ContourQuads &quads, vector<Point2f> &feature_points, Point2f shift)
 {
-	if((*root) != NULL) {
-		for (int idx = 0; idx < (*root)->total; idx++)
-		{
-			if(cvGetSeqElem(*root, idx) != NULL) {
-				CvSeq * src_contour = *(CvSeq**)cvGetSeqElem(*root, idx);
-				if(src_contour == NULL) { return; }
-				for (int i = 0; i < (*root)->elem_size; i++) {
-					if(cvGetSeqElem(src_contour, i) != NULL) {
-						CvPoint pt = *(CvPoint*)cvGetSeqElem(src_contour, i);
- 						feature_points.push_back(Point2f((float)pt.x + shift.x, (float)pt.y + shift.y));
-					}
-				}
-			}
-		}
+	for (size_t i = 0; i < quads.corners.size(); i++) {
+		feature_points.push_back(Point2f((float)quads.corners[i].x + shift.x, (float)quads.corners[i].y + shift.y));
 	}
 }
@@ -54,8 +54,8 @@ int main(int argc, char** argv)
 	int camera_num = 0;
 	if (argc > 1) {
 		camera_num = atoi(argv[1]) - 1;
-		if ((camera_num < 0) || (camera_num > 3)) {
-			cout << "Camera numbers must be in [1, 4]" << endl;
+		if ((camera_num < 0) || (camera_num >= CAMERA_MAX)) {
+			cout << "Camera numbers must be in [1, " << CAMERA_MAX << "]" << endl;
 			camera_num = 0;
 		}
 		cout << "Camera " << camera_num + 1 << " will be opened" << endl;
@@ -109,6 +109,10 @@ int objectsInit(int camera_num)
 {
 	////////////////// Read XML parameters /////////////////////
 	if (param.readXML("../../App/Content/settings.xml") == -1) { return (-1); }
+	if (camera_num >= param.camera_num) {
+		cout << "Camera " << camera_num + 1 << " is not described in settings" << endl;
+		return (-1);
+	}
 	//param.printParam();
 
 	//////////////////////// Display ////////////////////////////
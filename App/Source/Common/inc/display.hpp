@@ -52,7 +52,7 @@ using namespace std;
  * Types
  *******************************************************************************************/
 // Type of input event
-enum ev_type { m_move, m_scroll_up, m_scroll_down, k_esc, k_up, k_down, k_right, k_left, k_f1, k_f5, k_p, ev_none };
+enum ev_type { m_move, m_scroll_up, m_scroll_down, k_esc, k_up, k_down, k_right, k_left, k_f1, k_f5, k_p, k_h, k_t, k_v, ev_none };
 
 /*******************************************************************************************
  * Classes
@@ -139,6 +139,10 @@ public:
 	 *																k_left - Left key pressing
 	 *																k_f1 - F1 key pressing
  	 *																k_f5 - F5 key pressing
+ 	 *																k_p - P key pressing
+ 	 *																k_h - H key pressing
+	 *																k_t - T key pressing
+	 *																k_v - V key pressing
 	 *																ev_none - other non classificate events
 	 *
 	 * @remarks 		The function returns checks current event description and returns event type.
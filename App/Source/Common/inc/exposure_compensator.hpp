@@ -109,7 +109,8 @@ class Compensator {
 		 * @return 			-
 		 *
 		 * @remarks 		The function fills CompensatorInfo property of Compensator. It calculates mask which
-		 * 					defines 4 overlap regions and circumscribed rectangles of each region.
+		 * 					defines overlap regions and circumscribed rectangles of each region. Region i lies between the
+		 * 					previous camera in the ring and camera i.
 		 *
 		 **************************************************************************************************************/
 		void feed(vector<Camera*> &cameras, vector< vector<Point3f> > &seam_points);
@@ -119,8 +120,10 @@ class Compensator {
 		 * @brief  			Save compensator info
 		 *
 		 * @param  	in		char* path - path name
+		 * 			in		const vector< vector<float> > &grids - grids of all cameras (5 floats per vertex: vx vy vz tx ty)
 		 *
-		 * @return 			-
+		 * @return 			Functions returns 0 if the compensator info has been saved. A return value of -1 indicates
+		 * 					an error.
 		 *
 		 * @remarks 		The function generates grids only for overlap regions which lays on flat bowl bottom for each
 		 * 					camera and saves the grids into "compensator" folder - 1 grid per camera. Each grid contained
@@ -130,7 +133,7 @@ class Compensator {
 		 *					regions from frame buffer when it calculates exposure correction coefficients.
 		 *
 		 **************************************************************************************************************/
-		int save(const char* path);
+		int save(const char* path, const vector< vector<float> > &grids);
 		/**************************************************************************************************************
 		 *
 		 * @brief  			Load compensator info
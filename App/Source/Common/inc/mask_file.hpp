@@ -0,0 +1,90 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef HEADERS_MASK_FILE_HPP_
+#define HEADERS_MASK_FILE_HPP_
+
+/*******************************************************************************************
+ * Includes
+ *******************************************************************************************/
+#include <fstream>
+#include <iostream>
+#include <stdint.h>
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+using namespace std;
+using namespace cv;
+
+/*******************************************************************************************
+ * Macros
+ *******************************************************************************************/
+#define MASK_FILE_MAGIC 0x4B4D5653	/* "SVMK" */
+#define MASK_FILE_VERSION 1
+#define MASK_LEVELS 6				/* Maximum number of mask mip levels */
+
+/*******************************************************************************************
+ * Types
+ *******************************************************************************************/
+struct MaskLevels {
+	Size frame;				/* Size of the camera frame the mask is defined for */
+	Rect roi;				/* Bounding rectangle of nonzero mask pixels. Mask is zero outside of it */
+	vector<Mat> levels;		/* Cropped mask (CV_8UC1) and its mip levels. Level i has size max(1, roi.size / 2^i) */
+};
+
+/*******************************************************************************************
+ * Global functions
+ *******************************************************************************************/
+/**************************************************************************************************************
+ *
+ * @brief  			Save blending mask
+ *
+ * @param  in		const char* file_name - output file name
+ * 		   in		const Mat &mask - full frame blending mask (CV_8UC1)
+ *
+ * @return 			Functions returns 0 if the file has been saved. A return value of -1 indicates an error.
+ *
+ * @remarks 		The mask is cropped to the bounding rectangle of its nonzero pixels and the mip levels are
+ * 					built from the cropped mask with area interpolation. The file consists of the header (magic,
+ * 					version, frame size, rectangle and levels number) followed by every level compressed
+ * 					to PNG with its byte size. PNG is lossless, so the mask gradient is stored without artefacts.
+ *
+ **************************************************************************************************************/
+extern int saveMaskFile(const char* file_name, const Mat &mask);
+
+/**************************************************************************************************************
+ *
+ * @brief  			Load blending mask
+ *
+ * @param  in		const char* file_name - mask file name (see saveMaskFile)
+ * 		   out		MaskLevels &mask - cropped mask and its mip levels
+ *
+ * @return 			Functions returns 0 if the mask has been loaded. A return value of -1 indicates an error.
+ *
+ **************************************************************************************************************/
+extern int loadMaskFile(const char* file_name, MaskLevels &mask);
+
+#endif /* HEADERS_MASK_FILE_HPP_ */
@@ -30,20 +30,35 @@
  * Includes
  *******************************************************************************************/
 #include <vector>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
+#include <time.h>
 #include <sys/stat.h>
 #include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 #include <libxml/xmlmemory.h>
 #include <libxml/parser.h>
 
+#include "macros.hpp"
+
 using namespace boost;
 using namespace std;
 
+#define CAMERA_MAX 8	/* Maximum number of cameras (camera frame and mask samplers must fit 16 texture units) */
+#define LOD_MAX 4		/* Maximum number of coarser bowl grid levels */
+#define PRESET_MAX 8	/* Maximum number of view presets */
+#define VIEWPORT_MAX 4	/* Maximum number of viewports rendered in one frame */
+#define VIEWPORT_SIZE 5	/* Number of values which describe one viewport: type x y width height */
+
+/* Viewport types */
+#define VIEW_ORBIT 0	/* 3D view controlled by mouse and keyboard */
+#define VIEW_TOP 1		/* Fixed top-down (bird's-eye) view */
+
 /*******************************************************************************************
  * Types
  *******************************************************************************************/
@@ -58,6 +73,23 @@ struct CamParam {		/* Camera settings */
 	string device;		/* Device name (/dev/videoX) */
 };
 
+struct PresetParam {	/* View preset settings */
+	string name;		/* Preset name */
+	float rx;			/* Rotation around the bowl axis in degrees */
+	float ry;			/* Tilt in degrees from the top view (0) to the side view (-90) */
+	float px;			/* Camera x offset */
+	float py;			/* Camera y offset */
+	float pz;			/* Camera distance (zoom) */
+};
+
+struct ViewParam {		/* Viewport settings */
+	int type;			/* Viewport type (VIEW_ORBIT or VIEW_TOP) */
+	float x;			/* Lower left corner x coordinate. In fractions of display width */
+	float y;			/* Lower left corner y coordinate. In fractions of display height */
+	float width;		/* Viewport width. In fractions of display width */
+	float height;		/* Viewport height. In fractions of display height */
+};
+
 /*******************************************************************************************
  * Classes
  *******************************************************************************************/
@@ -70,13 +102,20 @@ class XMLParameters {
 		string tmplt;			/* Path to template points files */
 		// Camera parameters 
 		int camera_num;		 	/* Number of cameras */
-		CamParam cameras[4];	/* Cameras parameters */
+		vector<CamParam> cameras;	/* Cameras parameters */
+		vector<float> camera_yaw;	/* Camera yaw angles in degrees. The cameras ring is ordered by increasing yaw.
+									 * If the parameter is not set the cameras are spaced evenly in index order */
 		// Display
 		int disp_height;		/* Display height */
 		int disp_width;			/* Display width */
 		bool show_debug_img;	/* Debug mode */
 		int max_fps;			/* If FPS is higher than max_fps, application sleeps to render at max_fps. 0 is unlimited */
 		int msaa;				/* MSAA samples count */
+		vector<ViewParam> viewports;	/* Viewports rendered in every frame. Viewports should not overlap.
+										 * If the parameter is not set one full screen orbit view is rendered */
+		// View presets
+		vector<PresetParam> presets;	/* View presets. The first preset is the initial view */
+		float transition_ms = 500.0f;	/* Transition time between view presets in ms */
 		// Grid parameters
 		int grid_angles;		/* Every quadrant of circle will be divided into this number of arcs */
 		int grid_start_angle;	/* The parameter sets a circle segment for which the grid will be generated.
@@ -87,7 +126,13 @@ class XMLParameters {
 		float grid_step_x;		/* Step in x axis for bowl side which is used to define grid points in z axis.
  	 	 	 	 	 	 		 * Step in z axis: step_z[i] = (i * step_x_2)^2, i = 1, 2, ... - number of point */
 		float bowl_radius;		/* Bowl radius*/
+		int lod_levels = 0;		/* Number of coarser levels of detail of the bowl grids (./lodN/arrayX*). Every level
+								 * halves the grid density. If the parameter is 0 or not set only the full grids are used */
+		int top_density = 0;	/* Number of cells along every side of the 2D bird's-eye grid (./top_grid).
+								 * If the parameter is 0 or not set the grid is not generated */
+		bool analytic_texels = false;	/* Calculate grid texels with the polynomial camera model instead of the defisheye LUT */
 		float smooth_angle;		/* Mask angle of smoothing */
+		bool blend_weights = false;	/* Bake blend weights into overlap grids instead of sampling mask textures at render time */
 		string keyboard;		/* Keyboard device */
 		string mouse;			/* Mouse device */
 		string out_disp;		/* Display device */
@@ -132,7 +177,73 @@ class XMLParameters {
 		 *
 		 **************************************************************************************************************/
 		void printParam(void);
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get next camera in the cameras ring
+		 *
+		 * @param	in		int index - camera index
+		 *
+		 * @return 			Index of the camera which follows the index camera in the ring (increasing yaw).
+		 *
+		 * @remarks			The function returns neighbor camera according to the ring which was built by readXML.
+		 *
+		 **************************************************************************************************************/
+		int nextCamera(int index);
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get previous camera in the cameras ring
+		 *
+		 * @param	in		int index - camera index
+		 *
+		 * @return 			Index of the camera which precedes the index camera in the ring (decreasing yaw).
+		 *
+		 * @remarks			The function returns neighbor camera according to the ring which was built by readXML.
+		 *
+		 **************************************************************************************************************/
+		int previousCamera(int index);
 	private:
+		vector<int> ring;		/* Camera indexes ordered by yaw */
+		vector<int> ring_pos;	/* Position of each camera in the ring */
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Check cameras settings and build the cameras ring
+		 *
+		 * @param			-
+		 *
+		 * @return 			The function returns 0 if cameras settings are consistent. Otherwise -1 has been returned.
+		 *
+		 * @remarks			The function checks that all camera_num cameras are described, sets default yaw angles
+		 *					(360 / camera_num degrees step) if they were not set and sorts cameras by yaw.
+		 *
+		 **************************************************************************************************************/
+		int setRing(void);
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Convert and write input string to the float vector
+		 *
+		 * @param	in		const char* src - property value (whitespace separated list)
+		 *			out		vector<float> &dst - output vector
+		 *
+		 * @return 			The function returns 0 if src contains a list of float values. Otherwise -1 has been returned.
+		 *
+		 * @remarks			The function converts and writes input string src to the vector dst.
+		 *
+		 **************************************************************************************************************/
+		int readFloatList(const char* src, vector<float> &dst);
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Convert and write input string to the viewports vector
+		 *
+		 * @param	in		const char* src - property value (VIEWPORT_SIZE values per viewport: type x y width height)
+		 *			out		vector<ViewParam> &dst - output vector
+		 *
+		 * @return 			The function returns 0 if src contains valid viewports. Otherwise -1 has been returned.
+		 *
+		 * @remarks			The function converts and writes input string src to the vector dst. Viewport rectangles
+		 *					must lie inside the display.
+		 *
+		 **************************************************************************************************************/
+		int readViewports(const char* src, vector<ViewParam> &dst);
 		/**************************************************************************************************************
 		 *
 		 * @brief  			Set public property with val value
@@ -201,6 +312,20 @@ class XMLParameters {
 		 *
 		 **************************************************************************************************************/
 		int readCamera(const char* src, int index, CamParam* dst);
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Convert and write input string to the PresetParam structure
+		 *
+		 * @param	in		const char* src - property value (name rx ry px py pz)
+		 *			out		PresetParam* dst - pointer to the PresetParam property
+		 *
+		 * @return 			The function returns -1 if there are too few parameters in the input src string. 
+		 *					Otherwise 0 has been returned.
+		 *
+		 * @remarks			The function converts and writes input string src to the PresetParam structure *dst.
+		 *
+		 **************************************************************************************************************/
+		int readPreset(const char* src, PresetParam* dst);
 		/**************************************************************************************************************
 		 *
 		 * @brief  			Get parameter number
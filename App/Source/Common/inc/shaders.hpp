@@ -22,6 +22,30 @@
 * DEALINGS IN THE SOFTWARE.
 */
 
+/******************************* Camera batching ************************************/
+// Grids of all cameras are drawn with one call. Camera index is found from the vertex index and myFirst
+// (first vertex of each camera, unused cameras start at INT_MAX). Sampler arrays can be indexed only with
+// constant expressions, so the frame of the camera is selected by comparison. 8 is CAMERA_MAX.
+#define CAMERA_INDEX \
+		" Camera = 0; \n " \
+		" for (int i = 1; i < 8; i++) { if (gl_VertexID >= myFirst[i]) { Camera = i; } } \n "
+
+#define CAMERA_FRAMES \
+	" uniform samplerExternalOES myTexture0, myTexture1, myTexture2, myTexture3, myTexture4, myTexture5, myTexture6, myTexture7; \n "
+
+#define CAMERA_MASKS \
+	" uniform sampler2D myMask0, myMask1, myMask2, myMask3, myMask4, myMask5, myMask6, myMask7; \n "
+
+#define SAMPLE_FRAME(i) \
+		" if (Camera == " #i ") { color = texture(myTexture" #i ", TexCoord); } \n "
+
+#define SAMPLE_PAIR(i) \
+		" if (Camera.x == " #i ") { color0 = texture(myTexture" #i ", TexCoord.xy); } \n " \
+		" if (Camera.y == " #i ") { color1 = texture(myTexture" #i ", TexCoord.zw); } \n "
+
+#define SAMPLE_MASK(i) \
+		" if (Camera == " #i ") { mask = textureGrad(myMask" #i ", maskCoord, dx, dy).r; } \n "
+
 /******************************* Vertices shaders ************************************/
 // Vertices shader with view and projection parameters
 static const char s_v_shader_glm[] =
@@ -29,11 +53,52 @@ static const char s_v_shader_glm[] =
 	" layout(location = 0) in vec4 vPosition; \n "
 	" layout(location = 1) in vec2 vTexCoord; \n "
 	" out vec2 TexCoord; \n "
+	" flat out int Camera; \n "
 	" uniform mat4 mvp; \n"
+	" uniform int myFirst[8]; \n "
 	" void main() \n "
 	" { \n "
 		" gl_Position = mvp * vec4(vPosition.xyz, 1); \n "
 		" TexCoord = vTexCoord; \n "
+		CAMERA_INDEX
+	" } \n ";
+
+// Vertices shader with view and projection parameters and baked blend weight
+static const char s_v_shader_glm_w[] =
+	" #version 300 es \n " 
+	" layout(location = 0) in vec4 vPosition; \n "
+	" layout(location = 1) in vec2 vTexCoord; \n "
+	" layout(location = 2) in float vWeight; \n "
+	" out vec2 TexCoord; \n "
+	" out float Weight; \n "
+	" flat out int Camera; \n "
+	" uniform mat4 mvp; \n"
+	" uniform int myFirst[8]; \n "
+	" void main() \n "
+	" { \n "
+		" gl_Position = mvp * vec4(vPosition.xyz, 1); \n "
+		" TexCoord = vTexCoord; \n "
+		" Weight = vWeight; \n "
+		CAMERA_INDEX
+	" } \n ";
+
+// Vertices shader of the 2D bird's-eye grid. Every vertex has texels of two cameras and the weight of the first one
+static const char s_v_shader_top[] =
+	" #version 300 es \n " 
+	" layout(location = 0) in vec2 vPosition; \n "
+	" layout(location = 1) in vec4 vTexCoord; \n "
+	" layout(location = 2) in float vWeight; \n "
+	" layout(location = 3) in vec2 vCamera; \n "
+	" out vec4 TexCoord; \n "
+	" out float Weight; \n "
+	" flat out ivec2 Camera; \n "
+	" uniform mat4 mvp; \n"
+	" void main() \n "
+	" { \n "
+		" gl_Position = mvp * vec4(vPosition, 0, 1); \n "
+		" TexCoord = vTexCoord; \n "
+		" Weight = vWeight; \n "
+		" Camera = ivec2(vCamera + 0.5); \n "
 	" } \n ";
 
 // Vertices shader without view and projection parameters for exposure correction
@@ -53,6 +118,7 @@ static const char s_v_shader_model[] =
 	" \n"
 	"layout(location = 0) in vec3 position; \n"
 	"layout(location = 1) in vec3 normal; \n"
+	"layout(location = 3) in uint material; \n"
 	" \n"
 	"uniform mat4 mvp, mv; \n"
 	"uniform mat3 mn; \n"
@@ -60,13 +126,20 @@ static const char s_v_shader_model[] =
 	"//light \n"
 	"const vec3 lightPosition = vec3( 0.0, 0.0, 20.0 ); \n"
 	" \n"
-	"//material \n"
+	"//material table, 64 is MODEL_MATERIAL_MAX \n"
+	"struct Material { vec4 ambient; vec4 diffuse; vec4 specular; }; \n"
+	"layout(std140) uniform Materials { Material materials[64]; }; \n"
 	" \n"
 	"out vec3 eyePosition, eyeNormal, eyeLight; \n"
 	"out vec4 normPosition; \n"
+	"flat out vec3 ambient, diffuse, specular; \n"
 	" \n"
 	"void main() \n"
 	"{ \n"
+	"    ambient = materials[material].ambient.rgb; \n"
+	"    diffuse = materials[material].diffuse.rgb; \n"
+	"    specular = materials[material].specular.rgb; \n"
+	" \n"
 	"    normPosition = mvp*vec4(position,1); \n"
 	"    gl_Position = normPosition;	 \n"
 	" \n"
@@ -95,13 +168,11 @@ static const char s_v_shader_font[] =
 	"//vertex attributes \n"
 	"layout(location = 0) in vec2 in_ScreenCoord; \n"
 	"layout(location = 1) in vec2 in_TexCoord; \n"
-	"uniform mat4 mat; \n"
 	"out vec2 fragTexCoord; \n"
 	" \n"
 	"void main() \n"
 	"{ \n"
-	"	vec4 transCoords = mat * vec4(in_ScreenCoord, 0.0, 1.0); \n"
-	"	gl_Position = transCoords; \n"
+	"	gl_Position = vec4(in_ScreenCoord, 0.0, 1.0); \n"
 	"	fragTexCoord = in_TexCoord; \n"
 	"} \n";
 	
@@ -128,34 +199,92 @@ static const char s_v_shader_bowl[] =
 
 /******************************* Fragment shaders ************************************/	
 // Fragment shader with blending and exposure correction
-// To render overlap regions
+// To render overlap regions of all cameras. The mask is cropped to myMaskRect (offset xy, inverse size zw) and zero
+// outside of it. Mask gradients are taken outside of the camera selection to keep mip level selection defined
 static const char s_f_shader_b_ec[] =
 	"#version 300 es \n"
 	"#extension GL_OES_EGL_image_external : require\n"
 	" precision mediump float;\n "
 	" in vec2 TexCoord; \n "
+	" flat in int Camera; \n "
 	" out vec4 fragColor; \n "
-	" uniform samplerExternalOES myTexture; \n "
-	" uniform sampler2D myMask; \n "
-	" uniform vec4 myGain; \n "
+	CAMERA_FRAMES
+	CAMERA_MASKS
+	" uniform vec4 myMaskRect[8]; \n "
+	" uniform vec4 myGain[8]; \n "
 	" void main() \n "
 	" {\n "
-		" fragColor = vec4(texture(myTexture, TexCoord).rgb, texture(myMask, TexCoord).r) * myGain; \n "
+		" vec2 maskCoord = (TexCoord - myMaskRect[Camera].xy) * myMaskRect[Camera].zw; \n "
+		" vec2 inside = step(vec2(0.0), maskCoord) * step(maskCoord, vec2(1.0)); \n "
+		" vec2 dx = dFdx(maskCoord); \n "
+		" vec2 dy = dFdy(maskCoord); \n "
+		" vec4 color = vec4(0.0); \n "
+		" float mask = 0.0; \n "
+		SAMPLE_FRAME(0) SAMPLE_FRAME(1) SAMPLE_FRAME(2) SAMPLE_FRAME(3)
+		SAMPLE_FRAME(4) SAMPLE_FRAME(5) SAMPLE_FRAME(6) SAMPLE_FRAME(7)
+		SAMPLE_MASK(0) SAMPLE_MASK(1) SAMPLE_MASK(2) SAMPLE_MASK(3)
+		SAMPLE_MASK(4) SAMPLE_MASK(5) SAMPLE_MASK(6) SAMPLE_MASK(7)
+		" fragColor = vec4(color.rgb, mask * inside.x * inside.y) * myGain[Camera]; \n "
+	" }\n ";
+
+// Fragment shader with baked blending weight and exposure correction
+// To render overlap regions of all cameras without mask textures
+static const char s_f_shader_w_ec[] =
+	"#version 300 es \n"
+	"#extension GL_OES_EGL_image_external : require\n"
+	" precision mediump float;\n "
+	" in vec2 TexCoord; \n "
+	" in float Weight; \n "
+	" flat in int Camera; \n "
+	" out vec4 fragColor; \n "
+	CAMERA_FRAMES
+	" uniform vec4 myGain[8]; \n "
+	" void main() \n "
+	" {\n "
+		" vec4 color = vec4(0.0); \n "
+		SAMPLE_FRAME(0) SAMPLE_FRAME(1) SAMPLE_FRAME(2) SAMPLE_FRAME(3)
+		SAMPLE_FRAME(4) SAMPLE_FRAME(5) SAMPLE_FRAME(6) SAMPLE_FRAME(7)
+		" fragColor = vec4(color.rgb, Weight) * myGain[Camera]; \n "
+	" }\n ";
+
+// Fragment shader of the 2D bird's-eye grid with exposure correction
+// Two camera frames are mixed in the shader, so the grid is drawn in one pass without blending
+static const char s_f_shader_top[] =
+	"#version 300 es \n"
+	"#extension GL_OES_EGL_image_external : require\n"
+	" precision mediump float;\n "
+	" in vec4 TexCoord; \n "
+	" in float Weight; \n "
+	" flat in ivec2 Camera; \n "
+	" out vec4 fragColor; \n "
+	CAMERA_FRAMES
+	" uniform vec4 myGain[8]; \n "
+	" void main() \n "
+	" {\n "
+		" vec4 color0 = vec4(0.0); \n "
+		" vec4 color1 = vec4(0.0); \n "
+		SAMPLE_PAIR(0) SAMPLE_PAIR(1) SAMPLE_PAIR(2) SAMPLE_PAIR(3)
+		SAMPLE_PAIR(4) SAMPLE_PAIR(5) SAMPLE_PAIR(6) SAMPLE_PAIR(7)
+		" fragColor = vec4(mix(color1.rgb * myGain[Camera.y].rgb, color0.rgb * myGain[Camera.x].rgb, Weight), 1.0); \n "
 	" }\n ";
 
 // Fragment shader without blending and with exposure correction
-// To render non-overlap regions
+// To render non-overlap regions of all cameras
 static const char s_f_shader_ec[] =
 	"#version 300 es \n"
 	"#extension GL_OES_EGL_image_external : require\n"
 	" precision mediump float;\n "
 	" in vec2 TexCoord; \n "
+	" flat in int Camera; \n "
 	" out vec4 fragColor; \n "
-	" uniform samplerExternalOES myTexture; \n "
-	" uniform vec4 myGain; \n "
+	CAMERA_FRAMES
+	" uniform vec4 myGain[8]; \n "
 	" void main() \n "
 	" {\n "
-		" fragColor = texture(myTexture, TexCoord) * myGain; \n "
+		" vec4 color = vec4(0.0); \n "
+		SAMPLE_FRAME(0) SAMPLE_FRAME(1) SAMPLE_FRAME(2) SAMPLE_FRAME(3)
+		SAMPLE_FRAME(4) SAMPLE_FRAME(5) SAMPLE_FRAME(6) SAMPLE_FRAME(7)
+		" fragColor = color * myGain[Camera]; \n "
 	" }\n ";
 	
 // Fragment shader with blending and without exposure correction	
@@ -191,9 +320,9 @@ static const char s_f_shader_model[] =
 		"#version 300 es \n"
 		" precision mediump float;\n "
 		" \n"
-		"uniform vec3 ambient; \n"
-		"uniform vec3 diffuse; \n" 
-		"uniform vec3 specular; \n"
+		"flat in vec3 ambient; \n"
+		"flat in vec3 diffuse; \n" 
+		"flat in vec3 specular; \n"
 		" \n"
 		"in vec3 eyePosition, eyeNormal, eyeLight; \n"
 		"in vec4 normPosition; \n"
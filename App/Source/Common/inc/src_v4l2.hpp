@@ -129,6 +129,12 @@ class v4l2Camera {
 
 		int camera_num = 0;
 
+		// Capture statistics (protected by frame_lock)
+		unsigned int frames_captured = 0;		// Frames received from the pipeline
+		unsigned int frames_dropped = 0;		// Frames released before they have been rendered
+		struct timespec last_time = {0, 0};		// Arrival time of the newest frame (CLOCK_MONOTONIC)
+		struct timespec render_time = {0, 0};	// Arrival time of the frame returned by getFrame (CLOCK_MONOTONIC)
+
 		int getWidth(void) {return width;}		// Camera frame width
 		int getHeight(void) {return height;}	// Camera frame height
 	
@@ -212,6 +218,20 @@ class v4l2Camera {
 		 *
 		 **************************************************************************************************************/
 		int getFrame(void);	
+		/**************************************************************************************************************
+		 *
+		 * @brief  			Get capture statistics
+		 *
+		 * @param   out		unsigned int &captured - frames received from the pipeline
+		 *			out		unsigned int &dropped - frames released before they have been rendered
+		 *			out		struct timespec &frame_time - arrival time of the frame returned by the last getFrame call
+		 *
+		 * @return 			-
+		 *
+		 * @remarks			Arrival time is taken in the appsink callback with CLOCK_MONOTONIC.
+		 *
+		 **************************************************************************************************************/
+		void getStats(unsigned int &captured, unsigned int &dropped, struct timespec &frame_time);
 	private:
 
 		FILE *fp = NULL;	// RAW video sources (has been used only for raw video inputs)
@@ -0,0 +1,41 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef HEADERS_TOP_GRID_HPP_
+#define HEADERS_TOP_GRID_HPP_
+
+/*******************************************************************************************
+ * Macros
+ *******************************************************************************************/
+// Vertex layout of the bird's-eye grid (./top_grid). The grid is written by Masks::createTopGrid
+// and drawn by the renderer in top views: vx vy tx0 ty0 tx1 ty1 w camera0 camera1
+#define TOP_VERTEX_SIZE 9		/* Floats per vertex */
+#define TOP_POSITION_OFFSET 0	/* vx vy - position on the bowl bottom */
+#define TOP_TEXELS_OFFSET 2		/* tx0 ty0 tx1 ty1 - normalized fisheye texels of both cameras */
+#define TOP_WEIGHT_OFFSET 6		/* w - weight of camera0, camera1 gets 1 - w */
+#define TOP_CAMERAS_OFFSET 7	/* camera0 camera1 - camera indexes */
+
+#endif /* HEADERS_TOP_GRID_HPP_ */
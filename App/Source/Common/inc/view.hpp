@@ -96,13 +96,15 @@ public:
 	
 	int addCamera(string device, int width, int height);
 	int addMesh(string filename);	
+	int addMesh(const GLfloat* vert, int num);
 	
 	void renderView(int camera, int mesh);
 	int runCamera(int index);
 	
 	int createMesh(Mat xmap, Mat ymap, string filename, int density, Point2f top);
 	void reloadMesh(int index, string filename);
-	int changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index);
+	void reloadMesh(int index, const GLfloat* vert, int num);
+	int changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index, float scale = 1.0f);
 	
 	Mat takeFrame(int index);
 	
@@ -123,7 +125,7 @@ private:
 	vector<v4l2Camera> v4l2_cameras;	// Camera buffers
 	
 	void vLoad(GLfloat** vert, int* num, string filename);
-	void bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, GLfloat* vert, int num);
+	void bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, const GLfloat* vert, int num);
 	void texture2dInit(GLuint* texture);	
 };
 
@@ -578,6 +578,11 @@ int MyDisplay::getEventsNum(void)
  *																k_right - Right key pressing
  *																k_left - Left key pressing
  *																k_f1 - F1 key pressing
+ *																k_f5 - F5 key pressing
+ *																k_p - P key pressing
+ *																k_h - H key pressing
+ *																k_t - T key pressing
+ *																k_v - V key pressing
  *																ev_none - other non classificate events
  *
  * @remarks 		The function returns checks current event description and returns event type.
@@ -615,6 +620,15 @@ ev_type MyDisplay::getNextEvent(void)
 			case KEY_P: 
 				ret_val = k_p;
 				break;
+			case KEY_H: 
+				ret_val = k_h;
+				break;
+			case KEY_T: 
+				ret_val = k_t;
+				break;
+			case KEY_V: 
+				ret_val = k_v;
+				break;
 			case BTN_LEFT: // Mouse left button pressing
 				if (inevent.value == 1)
 					{ btn_mouse_left = true; }
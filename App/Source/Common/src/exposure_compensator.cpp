@@ -75,7 +75,8 @@ Rect Compensator::getFlipROI(uint index)
  * @return 			-
  *
  * @remarks 		The function fills CompensatorInfo property of Compensator. It calculates mask which
- * 					defines 4 overlap regions and circumscribed rectangles of each region.
+ * 					defines overlap regions and circumscribed rectangles of each region. Region i lies between the
+ * 					previous camera in the ring and camera i.
  *
  **************************************************************************************************************/
 #ifdef CAMERA_HPP_EXIST
@@ -95,30 +96,25 @@ void Compensator::feed(vector<Camera*> &cameras, vector< vector<Point3f> > &seam
 	double x_gain = 2.0 * cinf.radius;
 	double y_gain = 2.0 * cinf.radius * (double)cinf.roi_mask.rows / (double)cinf.roi_mask.cols;
 
-	for(size_t i = 0; i < cameras.size(); i+=2U)
+	for(size_t i = 0; i < cameras.size(); i++) // Overlap region i lies between the previous camera and camera i
 	{
-		vector<Point> p_left, p_right;
-		double sg = (double)pow(-1.0f, (int)(i >> 1U));
-		int i_next = next_id((int)i, (int)cameras.size() - 1); // Index of the previous camera
-		int i_prev = previous_id((int)i, (int)cameras.size() - 1); // Index of the next camera
+		int i_prev = cameras[i]->previous; // Index of the previous camera
+		Point2f p_ring[4] = {cameras[i]->ringPoint(seam_points[i][0]), cameras[i]->ringPoint(seam_points[i][1]),
+							 cameras[i_prev]->ringPoint(seam_points[i_prev][6]), cameras[i_prev]->ringPoint(seam_points[i_prev][7])};
 
-		p_left.push_back(Point2f((float)((sg * (double)seam_points[i][0].x + cinf.radius) * height), (float)((sg * (double)seam_points[i][0].y + cinf.radius) * height)));
-		p_left.push_back(Point2f((float)((sg * (double)seam_points[i][1].x + cinf.radius) * height), (float)((sg * (double)seam_points[i][1].y + cinf.radius) * height)));
-		p_left.push_back(Point2f((float)((sg * (double)seam_points[i_prev][6].y + cinf.radius) * height), (float)((- sg * (double)seam_points[i_prev][6].x + cinf.radius) * height)));
-		p_left.push_back(Point2f((float)((sg * (double)seam_points[i_prev][7].y + cinf.radius) * height), (float)((- sg * (double)seam_points[i_prev][7].x + cinf.radius) * height)));
-
-		p_right.push_back(Point2f((float)((- sg * seam_points[i_next][0].y + cinf.radius) * height), (float)((sg * seam_points[i_next][0].x + cinf.radius) * height)));
-		p_right.push_back(Point2f((float)((- sg * seam_points[i_next][1].y + cinf.radius) * height), (float)((sg * seam_points[i_next][1].x + cinf.radius) * height)));
-		p_right.push_back(Point2f((float)((sg * seam_points[i][6].x + cinf.radius) * height), (float)((sg * seam_points[i][6].y + cinf.radius) * height)));
-		p_right.push_back(Point2f((float)((sg * seam_points[i][7].x + cinf.radius) * height), (float)((sg * seam_points[i][7].y + cinf.radius) * height)));
+		vector<Point> p_left;
+		Point2f p_min = p_ring[0], p_max = p_ring[0];
+		for(int j = 0; j < 4; j++)
+		{
+			p_left.push_back(Point2f((float)(((double)p_ring[j].x + cinf.radius) * height), (float)(((double)p_ring[j].y + cinf.radius) * height)));
+			p_min = Point2f(MIN(p_min.x, p_ring[j].x), MIN(p_min.y, p_ring[j].y));
+			p_max = Point2f(MAX(p_max.x, p_ring[j].x), MAX(p_max.y, p_ring[j].y));
+		}
 
-		cinf.roi.push_back(Rect2f(Point2f((float)(sg * (double)seam_points[i][1].x / x_gain), (float)(- sg * (double)seam_points[i_prev][6].x / y_gain)),
-								  Point2f((float)(sg * (double)seam_points[i_prev][7].y / x_gain), (float)(sg * (double)seam_points[i][0].y / y_gain))));
-		cinf.roi.push_back(Rect2f(Point2f((float)(- sg * (double)seam_points[i_next][0].y / x_gain), (float)(sg * (double)seam_points[i][7].y / y_gain)),
-								  Point2f((float)(sg * (double)seam_points[i][6].x / x_gain), (float)(sg * (double)seam_points[i_next][1].x / y_gain))));
+		cinf.roi.push_back(Rect2f(Point2f((float)((double)p_min.x / x_gain), (float)((double)p_min.y / y_gain)),
+								  Point2f((float)((double)p_max.x / x_gain), (float)((double)p_max.y / y_gain))));
 
 		fillConvexPoly(cinf.roi_mask, p_left, Scalar(255)); // Draws a filled convex polygon using all seam points
-		fillConvexPoly(cinf.roi_mask, p_right, Scalar(255)); // Draws a filled convex polygon using all seam points
 	}
 }
 #endif
@@ -128,8 +124,10 @@ void Compensator::feed(vector<Camera*> &cameras, vector< vector<Point3f> > &seam
  * @brief  			Save compensator info
  *
  * @param  	in		char* path - path name
+ * 			in		const vector< vector<float> > &grids - grids of all cameras (5 floats per vertex: vx vy vz tx ty)
  *
- * @return 			-
+ * @return 			Functions returns 0 if the compensator info has been saved. A return value of -1 indicates
+ * 					an error.
  *
  * @remarks 		The function generates grids only for overlap regions which lays on flat bowl bottom for each
  * 					camera and saves the grids into "compensator" folder - 1 grid per camera. Each grid contained
@@ -139,7 +137,7 @@ void Compensator::feed(vector<Camera*> &cameras, vector< vector<Point3f> > &seam
  *					regions from frame buffer when it calculates exposure correction coefficients.
  *
  **************************************************************************************************************/
-int Compensator::save(const char* path)
+int Compensator::save(const char* path, const vector< vector<float> > &grids)
 {
 	double x_gain = 2.0 * cinf.radius;
 	double y_gain = 2.0 * cinf.radius * (double)cinf.roi_mask.rows / (double)cinf.roi_mask.cols;
@@ -154,58 +152,54 @@ int Compensator::save(const char* path)
 		}
 	}
 
+	if (grids.size() < cinf.roi.size())
+	{
+		cout << "Compensator grids have not been saved. Grids number is fewer than regions number" << endl;
+		return(-1);
+	}
+
 	for(uint i = 0; i < cinf.roi.size(); i++)
 	{
-		char file_name[50], file_name_roi[50];
-		sprintf(file_name, "./array%d", i + 1U);
+		char file_name_roi[50];
 		sprintf(file_name_roi, "%s/array%d", path, i + 1U);
 
-		ifstream ifs_ref(file_name);
-		if(ifs_ref) // // The file exists, and is open for input
+		ofstream outC; // Output file
+		outC.open(file_name_roi, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
+
+		const vector<float> &grid = grids[i];
+		for(size_t t = 0; t + 14 < grid.size(); t += 15) // For each triangle
 		{
-			ofstream outC; // Output file
-			outC.open(file_name_roi, std::ofstream::out | std::ofstream::trunc); // Any contents that existed in the file before it is open are discarded.
+			const float* v = &grid[t]; // 3 vertices: vx vy vz tx ty
 
-			float vx[3], vy[3], vz[3], tx[3], ty[3];
-			while (ifs_ref >> vx[0] >> vy[0] >> vz[0] >> tx[0] >> ty[0] >> vx[1] >> vy[1] >> vz[1] >> tx[1] >> ty[1] >> vx[2] >> vy[2] >> vz[2] >> tx[2] >> ty[2] ) // Read triangle
+			if((v[2] == 0.0f) && (v[7] == 0.0f) && (v[12] == 0.0f))
 			{
-				if((vz[0] == 0.0f) && (vz[1] == 0.0f) && (vz[2] == 0.0f))
-				{
-					double x0 = (vx[0] + cinf.radius) * height;
-					double y0 = (- vy[0] + cinf.radius) * height;
+				double x0 = (v[0] + cinf.radius) * height;
+				double y0 = (- v[1] + cinf.radius) * height;
 
-					double x1 = (vx[1] + cinf.radius) * height;
-					double y1 = (- vy[1] + cinf.radius) * height;
+				double x1 = (v[5] + cinf.radius) * height;
+				double y1 = (- v[6] + cinf.radius) * height;
 
-					double x2 = (vx[2] + cinf.radius) * height;
-					double y2 = (- vy[2] + cinf.radius) * height;
+				double x2 = (v[10] + cinf.radius) * height;
+				double y2 = (- v[11] + cinf.radius) * height;
 
+				if((x0 >= (double)0.0) && (x0 < (double)cinf.roi_mask.cols) && (y0 >= (double)0.0) && (y0 < (double)cinf.roi_mask.rows) &&
+				   (x1 >= (double)0.0) && (x1 < (double)cinf.roi_mask.cols) && (y1 >= (double)0.0) && (y1 < (double)cinf.roi_mask.rows) &&
+				   (x2 >= (double)0.0) && (x2 < (double)cinf.roi_mask.cols) && (y2 >= (double)0.0) && (y2 < (double)cinf.roi_mask.rows))
+				{
+					uint vertexes_sum = (uint)cinf.roi_mask.at<uchar>(Point(x0, y0)) +
+										(uint)cinf.roi_mask.at<uchar>(Point(x1, y1)) +
+										(uint)cinf.roi_mask.at<uchar>(Point(x2, y2));
 
-					if((x0 >= (double)0.0) && (x0 < (double)cinf.roi_mask.cols) && (y0 >= (double)0.0) && (y0 < (double)cinf.roi_mask.rows) &&
-					   (x1 >= (double)0.0) && (x1 < (double)cinf.roi_mask.cols) && (y1 >= (double)0.0) && (y1 < (double)cinf.roi_mask.rows) &&
-					   (x2 >= (double)0.0) && (x2 < (double)cinf.roi_mask.cols) && (y2 >= (double)0.0) && (y2 < (double)cinf.roi_mask.rows))
-
+					if(vertexes_sum == 765U) // 3 * 255
 					{
-						uint vertexes_sum = (uint)cinf.roi_mask.at<uchar>(Point(x0, y0)) +
-											(uint)cinf.roi_mask.at<uchar>(Point(x1, y1)) +
-											(uint)cinf.roi_mask.at<uchar>(Point(x2, y2));
-
-						if(vertexes_sum == 765U) // 3 * 255
-						{
-							outC << vx[0] / x_gain << " " << vy[0] / y_gain << " " << vz[0] << " " << tx[0] << " " << ty[0] << endl;
-							outC << vx[1] / x_gain << " " << vy[1] / y_gain << " " << vz[1] << " " << tx[1] << " " << ty[1] << endl;
-							outC << vx[2] / x_gain << " " << vy[2] / y_gain << " " << vz[2] << " " << tx[2] << " " << ty[2] << endl;
+						for(int j = 0; j < 15; j += 5) {
+							outC << v[j] / x_gain << " " << v[j + 1] / y_gain << " " << v[j + 2] << " " << v[j + 3] << " " << v[j + 4] << "\n";
 						}
 					}
 				}
 			}
-			outC.close(); // Close file
-		}
-		else
-		{
-			cout << "Compensator grids have not been saved. File " << file_name << " not found" << endl;
-			return(-1);
 		}
+		outC.close(); // Close file
 	}
 
 	char file_name[50];
@@ -327,6 +327,7 @@ int v4l2Camera::getFrame(void)
       gst_buffer_unref(buffer_render);
     }
 	buffer_render = buffer_last;
+	render_time = last_time;
 	g_mutex_unlock(&frame_lock);
 	if (buffer_render != nullptr)
     {
@@ -350,6 +351,28 @@ int v4l2Camera::getFrame(void)
 }
 
 
+/**************************************************************************************************************
+ *
+ * @brief  			Get capture statistics
+ *
+ * @param   out		unsigned int &captured - frames received from the pipeline
+ *			out		unsigned int &dropped - frames released before they have been rendered
+ *			out		struct timespec &frame_time - arrival time of the frame returned by the last getFrame call
+ *
+ * @return 			-
+ *
+ * @remarks			Arrival time is taken in the appsink callback with CLOCK_MONOTONIC.
+ *
+ **************************************************************************************************************/
+void v4l2Camera::getStats(unsigned int &captured, unsigned int &dropped, struct timespec &frame_time)
+{
+	g_mutex_lock(&frame_lock);
+	captured = frames_captured;
+	dropped = frames_dropped;
+	frame_time = render_time;
+	g_mutex_unlock(&frame_lock);
+}
+
 GstFlowReturn v4l2Camera::OnNewSample(GstElement* appsink, gpointer data)
 {
 	//cout << " New sample CB " << endl;
@@ -371,9 +394,12 @@ GstFlowReturn v4l2Camera::OnNewSample(GstElement* appsink, gpointer data)
 		{
 			// Previous stored buffer has not been rendered, release it.
 			gst_buffer_unref(self->buffer_last);
+			self->frames_dropped++;
 		}
 		// Lock new buffer
 		self->buffer_last = gst_buffer_ref(buffer);
+		self->frames_captured++;
+		clock_gettime(CLOCK_MONOTONIC, &self->last_time);
 
 		gst_sample_unref (sample);
 		g_mutex_unlock(&self->frame_lock);
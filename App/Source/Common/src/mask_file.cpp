@@ -0,0 +1,146 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "mask_file.hpp"
+
+/**************************************************************************************************************
+ *
+ * @brief  			Save blending mask
+ *
+ * @param  in		const char* file_name - output file name
+ * 		   in		const Mat &mask - full frame blending mask (CV_8UC1)
+ *
+ * @return 			Functions returns 0 if the file has been saved. A return value of -1 indicates an error.
+ *
+ * @remarks 		The mask is cropped to the bounding rectangle of its nonzero pixels and the mip levels are
+ * 					built from the cropped mask with area interpolation. The file consists of the header (magic,
+ * 					version, frame size, rectangle and levels number) followed by every level compressed
+ * 					to PNG with its byte size. PNG is lossless, so the mask gradient is stored without artefacts.
+ *
+ **************************************************************************************************************/
+int saveMaskFile(const char* file_name, const Mat &mask)
+{
+	if (mask.empty() || (mask.type() != CV_8UC1))
+	{
+		cout << "Mask " << file_name << " must be a single channel 8 bit image" << endl;
+		return(-1);
+	}
+
+	Rect roi = boundingRect(mask); // Bounding rectangle of nonzero pixels
+	if (roi.area() == 0) { roi = Rect(0, 0, 1, 1); } // Black mask is stored as one pixel
+
+	vector<Mat> levels(1, mask(roi));
+	while ((levels.size() < MASK_LEVELS) && ((levels.back().cols > 1) || (levels.back().rows > 1)))
+	{
+		Mat level;
+		resize(levels.back(), level, Size(max(1, levels.back().cols / 2), max(1, levels.back().rows / 2)), 0, 0, INTER_AREA);
+		levels.push_back(level);
+	}
+
+	ofstream out(file_name, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+	if (!out.is_open())
+	{
+		cout << "File " << file_name << " cannot be opened" << endl;
+		return(-1);
+	}
+
+	int32_t header[9] = {MASK_FILE_MAGIC, MASK_FILE_VERSION, mask.cols, mask.rows,
+						 roi.x, roi.y, roi.width, roi.height, (int32_t)levels.size()};
+	out.write((const char*)header, sizeof(header));
+
+	vector<uchar> buf;
+	for (uint i = 0; i < levels.size(); i++)
+	{
+		if (!imencode(".png", levels[i], buf))
+		{
+			cout << "Mask " << file_name << " level " << i << " cannot be compressed" << endl;
+			return(-1);
+		}
+		int32_t size = (int32_t)buf.size();
+		out.write((const char*)&size, sizeof(size));
+		out.write((const char*)buf.data(), (streamsize)buf.size());
+	}
+
+	return(out.good() ? 0 : -1);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Load blending mask
+ *
+ * @param  in		const char* file_name - mask file name (see saveMaskFile)
+ * 		   out		MaskLevels &mask - cropped mask and its mip levels
+ *
+ * @return 			Functions returns 0 if the mask has been loaded. A return value of -1 indicates an error.
+ *
+ **************************************************************************************************************/
+int loadMaskFile(const char* file_name, MaskLevels &mask)
+{
+	mask.levels.clear();
+
+	ifstream in(file_name, std::ifstream::in | std::ifstream::binary);
+	if (!in.is_open())
+	{
+		cout << "File " << file_name << " cannot be opened" << endl;
+		return(-1);
+	}
+
+	int32_t header[9];
+	in.read((char*)header, sizeof(header));
+	if (!in.good() || (header[0] != MASK_FILE_MAGIC) || (header[1] != MASK_FILE_VERSION) ||
+		(header[8] < 1) || (header[8] > MASK_LEVELS))
+	{
+		cout << "File " << file_name << " is not a mask file" << endl;
+		return(-1);
+	}
+	mask.frame = Size(header[2], header[3]);
+	mask.roi = Rect(header[4], header[5], header[6], header[7]);
+
+	vector<uchar> buf;
+	for (int i = 0; i < header[8]; i++)
+	{
+		int32_t size = 0;
+		in.read((char*)&size, sizeof(size));
+		if (!in.good() || (size <= 0))
+		{
+			cout << "File " << file_name << " is truncated" << endl;
+			return(-1);
+		}
+		buf.resize((size_t)size);
+		in.read((char*)buf.data(), size);
+
+		Mat level = imdecode(buf, IMREAD_GRAYSCALE);
+		if (!in.good() || level.empty() ||
+			(level.cols != max(1, mask.roi.width >> i)) || (level.rows != max(1, mask.roi.height >> i)))
+		{
+			cout << "Mask " << file_name << " level " << i << " cannot be decoded" << endl;
+			mask.levels.clear();
+			return(-1);
+		}
+		mask.levels.push_back(level);
+	}
+
+	return(0);
+}
@@ -35,6 +35,7 @@
  * 					The public properties are set.
  *
  * @remarks			The function reeds settings from filename xml file and write them to public properties. 
+ * 					Cameras, yaw angles and view presets are cleared before reading.
  *
  **************************************************************************************************************/
 int XMLParameters::readXML(const char* filename)
@@ -57,6 +58,11 @@ int XMLParameters::readXML(const char* filename)
 		return (-1);
 	}
 	
+	// Lists are rebuilt on every read, so deleted tags do not keep values of the previous read
+	cameras.clear();
+	camera_yaw.clear();
+	presets.clear();
+
 	for (pnode = pnode->children; pnode != NULL; pnode = pnode->next) {
 		if (pnode->type == XML_ELEMENT_NODE) {
 			xmlNodePtr pchildren  = pnode->xmlChildrenNode;
@@ -74,9 +80,78 @@ int XMLParameters::readXML(const char* filename)
 		}
 	}
 	xmlFreeDoc(pdoc);
+	return (setRing());
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Check cameras settings and build the cameras ring
+ *
+ * @param			-
+ *
+ * @return 			The function returns 0 if cameras settings are consistent. Otherwise -1 has been returned.
+ *
+ * @remarks			The function checks that all camera_num cameras are described, sets default yaw angles
+ *					(360 / camera_num degrees step) if they were not set and sorts cameras by yaw.
+ *
+ **************************************************************************************************************/
+int XMLParameters::setRing(void)
+{
+	if ((int)cameras.size() < camera_num) {
+		cout << "Only " << cameras.size() << " of " << camera_num << " cameras are described in settings" << endl;
+		return (-1);
+	}
+	
+	if (camera_yaw.size() == 0) {
+		for (int i = 0; i < camera_num; i++) {
+			camera_yaw.push_back(360.0f * (float)i / (float)camera_num);
+		}
+	}
+	else if ((int)camera_yaw.size() != camera_num) {
+		cout << "Yaw angles number must be equal to the cameras number" << endl;
+		return (-1);
+	}
+
+	ring.resize(camera_num);
+	ring_pos.resize(camera_num);
+	for (int i = 0; i < camera_num; i++) { ring[i] = i; }
+	stable_sort(ring.begin(), ring.end(), [this](int a, int b) { return (camera_yaw[a] < camera_yaw[b]); });
+	for (int i = 0; i < camera_num; i++) { ring_pos[ring[i]] = i; }
 	return (0);
 }
 
+/**************************************************************************************************************
+ *
+ * @brief  			Get next camera in the cameras ring
+ *
+ * @param	in		int index - camera index
+ *
+ * @return 			Index of the camera which follows the index camera in the ring (increasing yaw).
+ *
+ * @remarks			The function returns neighbor camera according to the ring which was built by readXML.
+ *
+ **************************************************************************************************************/
+int XMLParameters::nextCamera(int index)
+{
+	return (ring[next_id(ring_pos[index], camera_num - 1)]);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Get previous camera in the cameras ring
+ *
+ * @param	in		int index - camera index
+ *
+ * @return 			Index of the camera which precedes the index camera in the ring (decreasing yaw).
+ *
+ * @remarks			The function returns neighbor camera according to the ring which was built by readXML.
+ *
+ **************************************************************************************************************/
+int XMLParameters::previousCamera(int index)
+{
+	return (ring[previous_id(ring_pos[index], camera_num - 1)]);
+}
+
 /**************************************************************************************************************
  *
  * @brief  			Set public property with val value
@@ -106,8 +181,8 @@ int XMLParameters::setParam(int num, const char* val)
 			break;
 		case 3: // int camera_num;
 			camera_num = atoi(val);
-			if ((camera_num < 1) || (camera_num > 4)) {
-				cout << "Camera numbers must be in [1, 4]" << endl;
+			if ((camera_num < 1) || (camera_num > CAMERA_MAX)) {
+				cout << "Camera numbers must be in [1, " << CAMERA_MAX << "]" << endl;
 				return (-1);
 			}
 			break;
@@ -162,12 +237,44 @@ int XMLParameters::setParam(int num, const char* val)
 		case 20: // int msaa;
 			ret_val = readUInt(val, &msaa);
 			break;
-		case 100: case 101: case 102: case 103: // CamParam cameras[4];
-			ret_val = readCamera(val, num - 100, &cameras[num - 100]);
-			break;		
+		case 21: // bool blend_weights;
+			readBool(val, &blend_weights);
+			break;
+		case 22: // bool analytic_texels;
+			readBool(val, &analytic_texels);
+			break;
+		case 23: // vector<float> camera_yaw;
+			ret_val = readFloatList(val, camera_yaw);
+			break;
+		case 24: // vector<ViewParam> viewports;
+			ret_val = readViewports(val, viewports);
+			break;
+		case 25: // int top_density;
+			ret_val = readUInt(val, &top_density);
+			break;
+		case 26: // int lod_levels;
+			ret_val = readUInt(val, &lod_levels);
+			if ((ret_val == 0) && (lod_levels > LOD_MAX)) {
+				cout << "Levels of detail number must not exceed " << LOD_MAX << endl;
+				ret_val = -1;
+			}
+			break;
+		case 27: // float transition_ms;
+			ret_val = readFloat(val, &transition_ms);
+			break;
 		default:
-			cout << "Too much parameters in xml file" << endl;
-			ret_val = -1;
+			if ((num >= 100) && (num < 100 + CAMERA_MAX)) { // vector<CamParam> cameras;
+				if ((int)cameras.size() <= num - 100) { cameras.resize(num - 99); }
+				ret_val = readCamera(val, num - 100, &cameras[num - 100]);
+			}
+			else if ((num >= 200) && (num < 200 + PRESET_MAX)) { // vector<PresetParam> presets;
+				if ((int)presets.size() <= num - 200) { presets.resize(num - 199); }
+				ret_val = readPreset(val, &presets[num - 200]);
+			}
+			else {
+				cout << "Too much parameters in xml file" << endl;
+				ret_val = -1;
+			}
 			break;
 	}	
 	return (ret_val);
@@ -217,6 +324,69 @@ int XMLParameters::readFloat(const char* src, float* dst)
 	return (0);
 }
 
+/**************************************************************************************************************
+ *
+ * @brief  			Convert and write input string to the float vector
+ *
+ * @param	in		const char* src - property value (whitespace separated list)
+ *			out		vector<float> &dst - output vector
+ *
+ * @return 			The function returns 0 if src contains a list of float values. Otherwise -1 has been returned.
+ *
+ * @remarks			The function converts and writes input string src to the vector dst.
+ *
+ **************************************************************************************************************/
+int XMLParameters::readFloatList(const char* src, vector<float> &dst)
+{
+	float val;
+	stringstream str; 
+	str << src;
+	
+	dst.clear();
+	while (str >> val) { dst.push_back(val); }
+	if (!str.eof()) {
+		cout << "Cannot read the list of values: " << src << endl;
+		return (-1);
+	}
+	return (0);
+}
+
+/**************************************************************************************************************
+ *
+ * @brief  			Convert and write input string to the viewports vector
+ *
+ * @param	in		const char* src - property value (VIEWPORT_SIZE values per viewport: type x y width height)
+ *			out		vector<ViewParam> &dst - output vector
+ *
+ * @return 			The function returns 0 if src contains valid viewports. Otherwise -1 has been returned.
+ *
+ * @remarks			The function converts and writes input string src to the vector dst. Viewport rectangles
+ *					must lie inside the display.
+ *
+ **************************************************************************************************************/
+int XMLParameters::readViewports(const char* src, vector<ViewParam> &dst)
+{
+	vector<float> list;
+	if (readFloatList(src, list) == -1) { return (-1); }
+	if ((list.size() % VIEWPORT_SIZE != 0) || (list.size() > VIEWPORT_MAX * VIEWPORT_SIZE)) {
+		cout << "Viewports must be set as up to " << VIEWPORT_MAX << " groups of " << VIEWPORT_SIZE << " values: " << src << endl;
+		return (-1);
+	}
+	
+	dst.clear();
+	for (uint i = 0; i < list.size(); i += VIEWPORT_SIZE) {
+		ViewParam view = { (int)list[i], list[i + 1], list[i + 2], list[i + 3], list[i + 4] };
+		if (((view.type != VIEW_ORBIT) && (view.type != VIEW_TOP)) ||
+			(view.x < 0.0f) || (view.y < 0.0f) || (view.width <= 0.0f) || (view.height <= 0.0f) ||
+			(view.x + view.width > 1.001f) || (view.y + view.height > 1.001f)) {
+			cout << "Wrong viewport " << i / VIEWPORT_SIZE + 1 << ": " << src << endl;
+			return (-1);
+		}
+		dst.push_back(view);
+	}
+	return (0);
+}
+
 /**************************************************************************************************************
  *
  * @brief  			Convert and write input string to the bool variable
@@ -286,6 +456,32 @@ int XMLParameters::readCamera(const char* src, int index, CamParam* dst)
 	return (0);
 }
 
+/**************************************************************************************************************
+ *
+ * @brief  			Convert and write input string to the PresetParam structure
+ *
+ * @param	in		const char* src - property value (name rx ry px py pz)
+ *			out		PresetParam* dst - pointer to the PresetParam property
+ *
+ * @return 			The function returns -1 if there are too few parameters in the input src string. 
+ *					Otherwise 0 has been returned.
+ *
+ * @remarks			The function converts and writes input string src to the PresetParam structure *dst.
+ *
+ **************************************************************************************************************/
+int XMLParameters::readPreset(const char* src, PresetParam* dst)
+{
+	stringstream str; 
+	str << src;
+
+	if (!(str >> dst->name >> dst->rx >> dst->ry >> dst->px >> dst->py >> dst->pz))
+	{
+		cout << "Too few parameters for a view preset: " << src << endl;
+		return (-1);
+	}
+	return (0);
+}
+
 /**************************************************************************************************************
  *
  * @brief  			Write all public parameters values
@@ -303,9 +499,10 @@ void XMLParameters::printParam(void)
 	cout << "Path to camera models " << camera_models << endl;
 	cout << "Path to templates " << tmplt << endl;
 	cout << "Number of cameras " << camera_num << endl;
-	for (int i = 0; i < 4; i++)
+	for (int i = 0; i < camera_num; i++)
 	{
 		cout << "Camera " << i + 1 << endl;
+		cout << "\tYaw " << camera_yaw[i] << " (previous camera " << previousCamera(i) + 1 << ", next camera " << nextCamera(i) + 1 << ")" << endl;
 		cout << "\tResolution " << cameras[i].height << " x " << cameras[i].width  << endl;
 		cout << "\tDefisheye scale factor sf = " << cameras[i].sf << endl;
 		cout << "\tROI in which contours will be searched (% of image height) roi = " << cameras[i].roi << endl;
@@ -317,13 +514,28 @@ void XMLParameters::printParam(void)
 	cout << "Show debug info " << show_debug_img << endl;
 	cout << "Max FPS = " << max_fps << endl;
 	cout << "MSAA samples count = " << msaa << endl;
+	for (uint i = 0; i < viewports.size(); i++)
+	{
+		cout << "Viewport " << i + 1 << (viewports[i].type == VIEW_TOP ? " top" : " orbit") << " (x, y, width, height) " << viewports[i].x << ", "
+			<< viewports[i].y << ", " << viewports[i].width << ", " << viewports[i].height << endl;
+	}
+	cout << "View presets (transition " << transition_ms << " ms)" << endl;
+	for (uint i = 0; i < presets.size(); i++)
+	{
+		cout << "\t" << presets[i].name << ": rx " << presets[i].rx << ", ry " << presets[i].ry << ", position (" << presets[i].px << ", "
+			<< presets[i].py << ", " << presets[i].pz << ")" << endl;
+	}
 	cout << "Grig parameters" << endl;
 	cout << "\tAngles number " << grid_angles << endl;
 	cout << "\tStart angle " << grid_start_angle << endl;
 	cout << "\tNumber of grid points in z axis " << grid_nop_z << endl;
 	cout << "\tStep in x axis " << grid_step_x << endl;
 	cout << "\tRadius of 3D bowl " << bowl_radius << endl;
+	cout << "\tAnalytic texels " << analytic_texels << endl;
+	cout << "\tLevels of detail " << lod_levels << endl;
+	cout << "\tBird's-eye grid density " << top_density << endl;
 	cout << "Mask angle of smoothing " << smooth_angle << endl;
+	cout << "Baked blend weights " << blend_weights << endl;
 	cout << "Keyboard events " << keyboard << endl;
 	cout << "Mouse events " << mouse << endl;
 	cout << "Display file " << out_disp << endl;
@@ -398,10 +610,15 @@ int XMLParameters::getParam(const char* name)
 	else if (strcmp(name, "z_scale") == 0) { return_val = 18; }
 	else if (strcmp(name, "max_fps") == 0) { return_val = 19; }
 	else if (strcmp(name, "msaa") == 0) { return_val = 20; }
-	else if (strcmp(name, "camera1") == 0) { return_val = 100; }
-	else if (strcmp(name, "camera2") == 0) { return_val = 101; }
-	else if (strcmp(name, "camera3") == 0) { return_val = 102; }
-	else if (strcmp(name, "camera4") == 0) { return_val = 103; }
+	else if (strcmp(name, "blend_weights") == 0) { return_val = 21; }
+	else if (strcmp(name, "analytic_texels") == 0) { return_val = 22; }
+	else if (strcmp(name, "yaw") == 0) { return_val = 23; }
+	else if (strcmp(name, "viewports") == 0) { return_val = 24; }
+	else if (strcmp(name, "top_density") == 0) { return_val = 25; }
+	else if (strcmp(name, "lod_levels") == 0) { return_val = 26; }
+	else if (strcmp(name, "transition_ms") == 0) { return_val = 27; }
+	else if ((strncmp(name, "camera", 6) == 0) && (isdigit(name[6]) != 0) && (atoi(&name[6]) > 0)) { return_val = 99 + atoi(&name[6]); }
+	else if ((strncmp(name, "preset", 6) == 0) && (isdigit(name[6]) != 0) && (atoi(&name[6]) > 0)) { return_val = 199 + atoi(&name[6]); }
 	else { return_val = -1; }
 	return (return_val);		
 }
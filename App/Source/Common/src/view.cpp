@@ -166,6 +166,25 @@ int View::addMesh(string filename)
 	return ((int)v_obj.size() - 1);
 }
 
+/***************************************************************************************
+***************************************************************************************/
+int View::addMesh(const GLfloat* vert, int num)
+{
+	vertices_obj vo_tmp;
+	vo_tmp.num = num;
+		
+	//////////////////////// Camera textures initialization /////////////////////////////
+	glGenVertexArrays(1, &vo_tmp.vao);
+	glGenBuffers(1, &vo_tmp.vbo);
+
+	bufferObjectInit(&vo_tmp.vao, &vo_tmp.vbo, vert, vo_tmp.num);
+	texture2dInit(&vo_tmp.tex);
+	
+	v_obj.push_back(vo_tmp); 
+	
+	return ((int)v_obj.size() - 1);
+}
+
 
 /***************************************************************************************
 ***************************************************************************************/
@@ -215,7 +234,7 @@ void View::texture2dInit(GLuint* texture)
 
 /***************************************************************************************
 ***************************************************************************************/
-void View::bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, GLfloat* vert, int num)
+void View::bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, const GLfloat* vert, int num)
 {
 	// rectangle
 	glBindBuffer(GL_ARRAY_BUFFER, *text_vbo);
@@ -342,11 +361,20 @@ void View::reloadMesh(int index, string filename)
 	if(vert != NULL) { free(vert); }
 }
 
+/***************************************************************************************
+***************************************************************************************/
+void View::reloadMesh(int index, const GLfloat* vert, int num)
+{
+	v_obj[index].num = num;
+	glBindBuffer(GL_ARRAY_BUFFER, v_obj[index].vbo);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * 5 * num, vert, GL_DYNAMIC_DRAW);
+}
+
 
 
 /***************************************************************************************
 ***************************************************************************************/
-int View::changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index)
+int View::changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index, float scale)
 {
 	if ((xmap.rows == 0) || (xmap.cols == 0) || (ymap.rows == 0) || (ymap.cols == 0))
 	{
@@ -368,6 +396,8 @@ int View::changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index)
 	
 	float x_norm = 1.0f / (float)xmap.cols;
 	float y_norm = 1.0f / (float)xmap.rows;
+	float x_scale = scale * x_norm;	// Vertex scale (the mesh is drawn in scale x scale tile)
+	float y_scale = scale * y_norm;
 	
 	
 	int k =  0;
@@ -404,20 +434,20 @@ int View::changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index)
 				 *******************************************************************************************************/
 				if ((p1.x >= 0.0f) && (p1.y >= 0.0f) && (p1.x < (float)xmap.cols) && (p1.y < (float)xmap.rows))	// Check if p1 belongs to the input frame
 				{
-					vert[k] = v1.x * x_norm + top.x;
-					vert[k + 1] = (top.y - v1.y * y_norm);
+					vert[k] = v1.x * x_scale + top.x;
+					vert[k + 1] = (top.y - v1.y * y_scale);
 					vert[k + 2] = 0.0f;
 					vert[k + 3] = p1.x * x_norm;
 					vert[k + 4] = p1.y * y_norm;
 					
-					vert[k + 5] = v2.x * x_norm + top.x;
-					vert[k + 6] = (top.y - v2.y * y_norm);
+					vert[k + 5] = v2.x * x_scale + top.x;
+					vert[k + 6] = (top.y - v2.y * y_scale);
 					vert[k + 7] = 0.0f;
 					vert[k + 8] = p2.x * x_norm;
 					vert[k + 9] = p2.y * y_norm;
 
-					vert[k + 10] = v4.x * x_norm + top.x;
-					vert[k + 11] = (top.y - v4.y * y_norm);
+					vert[k + 10] = v4.x * x_scale + top.x;
+					vert[k + 11] = (top.y - v4.y * y_scale);
 					vert[k + 12] = 0.0f;
 					vert[k + 13] = p4.x * x_norm;
 					vert[k + 14] = p4.y * y_norm;
@@ -433,20 +463,20 @@ int View::changeMesh(Mat xmap, Mat ymap, int density, Point2f top, int index)
 				 *******************************************************************************************************/
 				if ((p3.x > 0.0f) && (p3.y > 0.0f) && (p3.x < (float)xmap.cols) && (p3.y < (float)xmap.rows))	// Check if p3 belongs to the input frame)
 				{
-					vert[k] = v4.x * x_norm + top.x;
-					vert[k + 1] = (top.y - v4.y * y_norm);
+					vert[k] = v4.x * x_scale + top.x;
+					vert[k + 1] = (top.y - v4.y * y_scale);
 					vert[k + 2] = 0.0f;
 					vert[k + 3] = p4.x * x_norm;
 					vert[k + 4] = p4.y * y_norm;
 					
-					vert[k + 5] = v2.x * x_norm + top.x;
-					vert[k + 6] = (top.y - v2.y * y_norm);
+					vert[k + 5] = v2.x * x_scale + top.x;
+					vert[k + 6] = (top.y - v2.y * y_scale);
 					vert[k + 7] = 0.0f;
 					vert[k + 8] = p2.x * x_norm;
 					vert[k + 9] = p2.y * y_norm;
 
-					vert[k + 10] = v3.x * x_norm + top.x;
-					vert[k + 11] = (top.y - v3.y * y_norm);
+					vert[k + 10] = v3.x * x_scale + top.x;
+					vert[k + 11] = (top.y - v3.y * y_scale);
 					vert[k + 12] = 0.0f;
 					vert[k + 13] = p3.x * x_norm;
 					vert[k + 14] = p3.y * y_norm;
@@ -27,6 +27,7 @@
 #include <fstream>
 #include <iomanip>
 #include <string>
+#include <vector>
 
 //Camera movement
 #include <glm/glm.hpp> 
@@ -47,6 +48,23 @@
 #define FONT_TEX_SIZE 512
 #define FONT_TEX_GLYPH_SIZE FONT_TEX_SIZE/FONT_TEX_GLYPH_COUNT
 
+// Glyphs of all strings of a frame are drawn with one call
+#define FONT_BATCH_GLYPHS 1024	// Capacity of the streaming vertex buffer
+#define FONT_GLYPH_VERTICES 6	// Two triangles per glyph
+#define FONT_VERTEX_SIZE 4		// Position (2) and texture coordinates (2)
+
+struct FontText
+{
+	std::string text;
+	float top, left;	// Position of the top left corner in percent of the screen size
+	float scale;		// Glyph scale
+
+	bool operator==(const FontText &other) const
+	{
+		return ((text == other.text) && (top == other.top) && (left == other.left) && (scale == other.scale));
+	}
+};
+
 class FontRenderer
 {
 protected:
@@ -55,10 +73,14 @@ protected:
 	float size;
 		
 	GLuint texFont;
-	GLuint small_quad, small_quad_tex;
-	GLint texLoc, colorLoc, matLoc;
+	GLuint vao, vbo;
+	GLint texLoc, colorLoc;
 	GLuint shaderProgram;
 
+	std::vector<FontText> frameText;	// Strings queued for the current frame
+	std::vector<FontText> drawnText;	// Strings in the vertex buffer
+	std::vector<GLfloat> vertices;
+	int glyphs;							// Glyphs in the vertex buffer
 	
 public:
 	FontRenderer(int width, int height, std::string atlas);
@@ -66,12 +88,20 @@ public:
 	
 	void Initialize(void);
 	
+	void AddText(const char *text, float top, float left, float scale = 1.0f);
+	void Flush(void);
 	void RenderText(const char *text, float top, float left);
-	void RenderGlyph(int glyphId);
 	
 	void SetShader(GLuint shader);
+
+	// Height of a text line in percent of the screen height
+	float GetLineHeight(float scale = 1.0f)
+	{
+		return (100.0f * GetRealFontSize() * scale / (float)screenHeight);
+	}
 	
 protected:
+	void AddGlyph(int glyphId, float x, float y, glm::vec3 scale);
 	glm::vec3 ComputeFontSize(void);
 	float GetRealFontSize(void)
 	{
@@ -25,6 +25,7 @@
 #ifndef MRT_HPP_
 #define MRT_HPP_
 
+#include <stddef.h>
 #include <GLES3/gl3.h>
 
 #define MRT_ENABLED 1
@@ -38,10 +39,12 @@ protected:
 	GLuint small_quad_tex;
 
 	GLuint fbo, depth;
-	GLuint screenTex, videoTex;
+	GLuint screenTex;
 
 	bool enabled;
 
+	bool Allocate(void);
+
 public:
 	MRT(int mrtWidth, int mrtHeight);
 	~MRT(void);
@@ -49,6 +52,11 @@ public:
 	GLuint getFBO(void){ return fbo; }
 
 	void Initialize(void);
+	// Allocates the offscreen target on the first call. No post-process needs it yet, so nothing calls Enable and
+	// the composite path in Render() is intentionally dormant: the frame goes straight to the back buffer
+	bool Enable(void);
+	void Disable(void) { enabled = false; }
+	size_t GetMemorySize(void) { return (fbo == 0) ? 0 : (size_t)width * height * 6; } // RGBA8 color + DEPTH16
 
 	void RenderSmallQuad(GLuint showTexP);
 	bool isEnabled(void) { return ((MRT_ENABLED != 0) && enabled); }
@@ -0,0 +1,116 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef MODELCACHE_HPP_
+#define MODELCACHE_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include <GLES3/gl3.h>
+
+using namespace std;
+
+#define MODEL_CACHE_MAGIC 0x434D5653	/* "SVMC" */
+#define MODEL_CACHE_VERSION 2
+#define MODEL_CACHE_EXT ".svm"
+///floats per interleaved vertex: position(3), normal(3), texture coordinates(2)
+#define MODEL_VERTEX_SIZE 8
+///size of the material uniform block of s_v_shader_model, models with more materials are rejected
+#define MODEL_MATERIAL_MAX 64
+
+///material record of the cache file
+struct CacheMaterial
+{
+	GLfloat ambient[3];
+	GLfloat diffuse[3];
+	GLfloat specular[3];
+	GLfloat shininess;
+	uint32_t pathLength;	//length of the diffuse texture path in the path table
+};
+
+///mesh record of the cache file
+struct CacheMesh
+{
+	int32_t materialId;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+};
+
+///post-processed scene: materials and indexed meshes with interleaved vertices
+struct ModelData
+{
+	vector<CacheMaterial> materials;
+	vector<string> texPaths;
+	vector<CacheMesh> meshes;	//ranges of vertices and indices, sorted by material
+	vector<GLfloat> vertices;	//vertices of all meshes, MODEL_VERTEX_SIZE floats each
+	vector<GLuint> indices;		//indices of all meshes, relative to the first vertex of the model
+};
+
+///@brief Binary cache of the post-processed car model
+///
+///The file consists of the header (magic, version, source hash, counts) followed by the material
+///and mesh tables, the texture path table padded to 4 bytes, the vertices and the indices of all meshes.
+///The file is mapped to memory, so the merged vertex and index buffers are uploaded to GPU without copying.
+class ModelCache
+{
+protected:
+	void *data;
+	size_t size;
+
+	const CacheMaterial *materials;
+	const CacheMesh *meshes;
+	unsigned int meshCount;
+	vector<string> texPaths;
+	const GLfloat *vertices;
+	const GLuint *indices;
+	unsigned int vertexCount;
+	unsigned int indexCount;
+
+public:
+	ModelCache(void);
+	~ModelCache(void);
+
+	static int HashFile(const string &path, uint64_t &hash);
+	static int Save(const string &path, uint64_t hash, const ModelData &model);
+
+	bool Open(const string &path, uint64_t hash);
+	void Close(void);
+
+	unsigned int GetMaterialCount(void){ return (unsigned int)texPaths.size(); }
+	const CacheMaterial& GetMaterial(unsigned int i){ return materials[i]; }
+	const string& GetTexPath(unsigned int i){ return texPaths[i]; }
+
+	unsigned int GetMeshCount(void){ return meshCount; }
+	const CacheMesh& GetMesh(unsigned int i){ return meshes[i]; }
+
+	const GLfloat* GetVertices(void){ return vertices; }
+	unsigned int GetVertexCount(void){ return vertexCount; }
+	const GLuint* GetIndices(void){ return indices; }
+	unsigned int GetIndexCount(void){ return indexCount; }
+};
+
+#endif /* MODELCACHE_HPP_ */
@@ -35,19 +35,31 @@ using namespace std;
 
 #define CONFIG_MODEL_FILE "../Content/model.cfg"
 
+///uniform buffer binding point of the material block
+#define MODEL_MATERIAL_BINDING 0
+
 typedef vector<Material*> MaterialList;
 typedef MaterialList::iterator MaterialListIter;
 
-typedef vector<VBO*> VBOList;
-typedef VBOList::iterator VBOListIter;
-
 class ModelLoader
 {
 protected:
 	bool isInitialized;
 
 	MaterialList materials;
-	VBOList objects;
+	///merged geometry of all meshes, drawn with one call
+	VBO *object;
+	///uniform buffer with the material table
+	GLuint materialBuffer;
+	///program the material block has been bound for
+	GLuint blockShader;
+	///GPU memory of vertex, index and uniform buffers
+	size_t memorySize;
+
+	bool Import(const string &filepath, ModelData &model);
+	void AddMaterial(const CacheMaterial &material, const string &texPath);
+	void CreateObject(const CacheMesh *meshes, unsigned int meshCount,
+			const GLfloat *vertices, unsigned int vertexCount, const GLuint *indices, unsigned int indexCount);
 
 public:
 	ModelLoader(void);
@@ -56,6 +68,7 @@ public:
 	bool Initialize(void);
 	string GetModelFileName(void);
 	void Draw(GLuint shader);
+	size_t GetMemorySize(void){ return memorySize; }
 
 };
 
@@ -28,8 +28,10 @@
 #include <GLES3/gl3.h>
 #include <assimp/scene.h>
 
+#include "ModelCache.hpp"
+
 ///vertex buffer indices
-enum VBOindices{P_VERTEX,P_NORMAL,P_TEXCOORD,P_INDEX};
+enum VBOindices{P_VERTEX,P_MATERIAL,P_INDEX};
 ///data structure to store vertex/texture/faces data
 typedef GLfloat Vertex[3];
 ///data structure to store texture data
@@ -39,23 +41,22 @@ typedef GLfloat Coord[2];
 class VBO
 {
 protected:
-    ///pointers to all buffers: vertex, normal, texcoordinate and faces
-    GLuint buffer[4] = {0};
+    ///pointers to all buffers: interleaved vertex, material index and faces
+    GLuint buffer[3] = {0};
     ///pointer vertex array
     GLuint vao;
 
+    ///number of indices
     GLuint count;
-    int matId;
 
 public:
-	VBO(Vertex *vertices, Vertex *normals, Coord *texcoords, int count, int materialId);
+	VBO(const GLfloat *vertices, const GLubyte *materials, int vertexCount, const GLuint *indices, int indexCount);
 	~VBO(void);
 
     void CreateRenderableObject(int id, aiMesh* mesh);
 
 	GLuint GetVAO(void){ return vao; }
 	GLuint GetCount(void){ return count; }
-	int GetMatId(void){ return matId; }
 };
 
 #endif /* VBO_HPP_ */
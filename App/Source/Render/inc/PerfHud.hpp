@@ -0,0 +1,93 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef PERF_HUD_HPP_
+#define PERF_HUD_HPP_
+
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "FontRenderer.hpp"
+
+#define HUD_UPDATE_MS 500.0		// Period of the statistics update (text is regenerated only then)
+#define HUD_TEXT_SCALE 0.5f		// Glyph scale of the HUD text
+
+// Render stages timed by the HUD (CPU time spent in the stage)
+enum HudStage { HUD_STAGE_CAR, HUD_STAGE_BOWL, HUD_STAGE_TOP, HUD_STAGE_EC, HUD_STAGE_COMPOSE, HUD_STAGE_TEXT, HUD_STAGE_SWAP, HUD_STAGE_NUM };
+
+// GPU memory groups
+enum HudMemory { HUD_MEM_MESH, HUD_MEM_MASK, HUD_MEM_TEXTURE, HUD_MEM_NUM };
+
+struct HudCamera
+{
+	unsigned int captured;		// Captured frames at the start of the period
+	unsigned int current;		// Captured frames
+	unsigned int dropped;		// Dropped frames since the capturing start
+	double fps;					// Input frame rate of the last period
+	double latency;				// Accumulated capture to display latency (ms) of the current period
+	int samples;				// Latency samples of the current period
+	float gain[3];				// Exposure correction gains (RGB)
+};
+
+class PerfHud
+{
+protected:
+	bool enabled;
+	
+	struct timespec periodStart;
+	struct timespec stageStart;
+	double stageTime[HUD_STAGE_NUM];	// Accumulated stage times (ms) of the current period
+	int frames;							// Frames of the current period
+	double vertices;					// Bowl vertices drawn in the current period
+
+	std::vector<HudCamera> cameras;
+	double ecAge, ecTime;				// Age and duration of the last exposure correction update (ms)
+	size_t memory[HUD_MEM_NUM];
+
+	std::vector<std::string> lines;
+
+public:
+	PerfHud(int cameraNum);
+	~PerfHud(void);
+
+	void Toggle(void);
+	bool isEnabled(void) { return enabled; }
+
+	void Start(void);
+	void Stage(HudStage stage);
+	void FrameEnd(void);
+
+	void SetCamera(int camera, unsigned int captured, unsigned int dropped, double latency);
+	void SetGains(const std::vector<float> &gain, int stride, double age, double duration);
+	void AddMemory(HudMemory type, size_t bytes);
+	void AddVertices(int num);
+
+	void Render(FontRenderer *font, float top, float left);
+
+protected:
+	void Update(double period);
+};
+
+#endif //PERF_HUD_HPP_
@@ -38,26 +38,44 @@ static double fpsValue = 0.0;
 //Cameras parameters
 static XMLParameters param;
 static int camera_num;						// Cameras number
+static vector<int> camera_ring;				// Camera indexes in the ring order
 static vector<int> g_in_width;				// Input frame width
 static vector<int> g_in_height;			// Input frame height
 static vector<v4l2Camera> v4l2_cameras;	// Camera buffers
 
 // Cameras mapping
-static GLuint gTexObj[VAO_NUM] = {0};		// Camera textures
-static GLuint txtMask[CAMERA_NUM] = {0};	// Camera masks textures
-static vector<Mat> masks;			// Mask images
+static vector<GLuint> txtMask;				// Camera masks textures (cropped, R8 with mip levels)
+static vector<GLfloat> maskRect;			// Camera masks rectangles (texel offset, inverse size), 4 per camera
+static GLint locMaskRect;
+static bool blend_weights = false;	// Overlap grids have baked blend weights (./arrayX3), mask textures are not used
 
 #define GL_PIXEL_TYPE GL_VIV_UYVY
 #define CAM_PIXEL_TYPE V4L2_PIX_FMT_UYVY
 
-static GLuint VAO[VAO_NUM];
-static vector<int> vertices;						   
+// Grids of all cameras are batched: one VAO for overlap regions and one for non-overlap regions.
+// Every camera has all levels of detail in the batch (level 0 - ./arrayXY, level N - ./lodN/arrayXY) and
+// every level is split into chunks of neighbor sectors, so invisible chunks are skipped
+struct BowlChunk {
+	GLint first;		// First vertex in the batch
+	GLsizei count;		// Number of vertices
+	glm::vec4 sphere;	// Bounding sphere (center xyz, radius w)
+};
+static GLuint VAO[2];
+static GLint firstVertex[2][CAMERA_MAX];	// First vertex of each camera in the batch (INT_MAX for unused cameras)
+static vector<BowlChunk> bowlChunks[2][CAMERA_MAX][LOD_MAX + 1];
+static glm::vec4 bowlSphere[CAMERA_MAX];	// Bounding sphere of the full level grids of each camera
+static int lod_num = 1;						// Number of levels of detail
+
+#define LOD_SECTORS 32		// The bowl is divided into this number of angular sectors to cull grid chunks
+#define LOD_FULL_SIZE 1.0f	// Camera grid projected to this fraction of viewport height or bigger is drawn with level 0.
+							// Every next level is used when the projected size is halved
+static GLint locFirst[2], locMvp[2];
 
 static Programs renderProgram;
 static Programs renderProgramWB;
 
 // Exposure correction
-static GLuint VAO_EC[CAMERA_NUM];
+static vector<GLuint> VAO_EC;
 static vector<int> vertices_ec;
 
 static GLint viewport[4];
@@ -66,10 +84,49 @@ static Programs exposureCorrectionProgram;
 static GLint locGain[2];
 static Gains* gain = NULL;
 
+//Viewports
+struct View {
+	int type;				// VIEW_ORBIT or VIEW_TOP
+	GLint rect[4];			// Viewport rectangle in pixels (x, y, width, height)
+	glm::mat4 projection;	// Projection matrix (viewport aspect ratio)
+	glm::mat4 ortho;		// Orthographic projection of the bird's-eye grid (top views)
+	bool remap;				// Top view is drawn with the bird's-eye grid instead of the bowl, updated once per frame
+	glm::mat4 mv;			// ModelView matrix, updated once per frame
+	glm::mat4 mvp;			// ModelViewProjection matrix, updated once per frame
+	glm::vec4 planes[6];	// Frustum planes (normalized), updated once per frame
+	int lod[CAMERA_MAX];	// Level of detail of each camera grid, updated once per frame
+	glm::mat4 carMvp;		// ModelViewProjection matrix of the car model, updated once per frame
+	glm::mat3 carMn;		// Normal matrix of the car model, updated once per frame
+};
+static vector<View> views;	// Initialization is needed
+#define VIEW_TOP_Z -10.0f	// Distance from the top view camera to the ground
+
+// 2D bird's-eye grid (./top_grid) of the bowl bottom, it is drawn in top views with one pass
+static GLuint VAO_TOP;
+static int vertices_top = 0;
+static bool top_remap = true;	// Toggled with the T key to compare with the 3D bowl path
+static Programs topProgram;
+static GLint locMvpTop, locGainTop;
+
+// View presets. The orbit camera is moved to a preset with an animated transition:
+// rx, ry, px, py, pz are set to the target at once and the drawn view is interpolated from the previous one
+struct ViewPreset {
+	string name;
+	float rx, ry;			// Orbit angles in radians
+	glm::vec3 position;		// Camera position
+};
+static vector<ViewPreset> presets;
+static int preset_index = 0;				// Last selected preset
+static bool transition = false;				// Transition is running
+static struct timespec transition_start;
+static double transition_ms = 500.0;		// Transition time
+static glm::quat from_rotation;				// Orbit camera state at the start of the transition
+static glm::vec3 from_position;
+
 //Model Loader
-static glm::mat4 gProjection;	// Initialization is needed
 static float rx = 0.0f, ry = 0.0f, px = 0.0f, py = 0.0f, pz = -10.0f;
 static glm::vec3 car_scale = glm::vec3(1.0f, 1.0f, 1.0f);
+static glm::mat4 carRotation, carModelMatrix;	// Constant, calculated in setParam
 
 #define CAR_ORIENTATION_X 90.0f 
 #define CAR_ORIENTATION_Y 270.0f
@@ -90,6 +147,9 @@ static Programs showTexProgram;
 static FontRenderer* fontRenderer = NULL;	// Initialization is needed
 static Programs fontProgram;
 
+//Performance HUD (toggled with the H key)
+static PerfHud* hud = NULL;	// Initialization is needed
+
 //Display
 static MyDisplay* out_disp = NULL; // Initialization is needed 
 
@@ -107,12 +167,22 @@ static int programsInit(void);
 static void programsDestroj(void);
 static int setParam(XMLParameters* xml_param);
 static void texture2dInit(GLuint* texture);
-static void bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, GLfloat* vert, int num);
-static void vLoad(GLfloat** vert, int* num, string filename);
+static void bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, GLfloat* vert, int num, int stride = 5);
+static void samplersInit(Programs* program, bool masks);
+static void vLoad(GLfloat** vert, int* num, string filename, int stride = 5);
 static int camerasInit(void);
 static void camTexInit(void);
 static void ecTexInit(void);
+static void topTexInit(void);
+static void chunksInit(const GLfloat* vert, int num, int stride, GLint first, vector<BowlChunk> &chunks, glm::vec3 &bmin, glm::vec3 &bmax);
+static bool isVisible(const View &view, const glm::vec4 &sphere);
+static int bowlDraw(const View &view, int pass);
 static inline void mapFrame(int buf_index, int camera);
+static void viewState(glm::quat &rotation, glm::vec3 &position);
+static int viewPreset(int index);
+static void viewsUpdate(void);
+static void carRender(void);
+static void hudUpdate(void);
 	
 #endif /* CAMERA_TEX_HPP_ */
 
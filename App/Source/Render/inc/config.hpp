@@ -32,6 +32,9 @@
 #include <iomanip>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -63,6 +66,7 @@
 #include <glm/glm.hpp> 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 //Shaders
 #include "gl_shaders.hpp"
@@ -72,10 +76,17 @@
 #include "ModelLoader/ModelLoader.hpp"
 #include "MRT.hpp"
 #include "FontRenderer.hpp"
+#include "PerfHud.hpp"
 
 //XML settings
 #include "settings.hpp"
 
+//Blending masks
+#include "mask_file.hpp"
+
+//Bird's-eye grid layout
+#include "top_grid.hpp"
+
 //Macros
 #include "macros.hpp"
 
@@ -85,8 +96,6 @@
 /*******************************************************************************************
  * Macros
  *******************************************************************************************/
-#define CAMERA_NUM  4
-#define VAO_NUM 8 // 2 * CAMERA_NUM
 
 /* GL_VIV_direct_texture */
 #ifndef GL_VIV_direct_texture
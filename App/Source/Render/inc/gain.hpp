@@ -42,7 +42,7 @@
 #include "macros.hpp"
 
 #define CHANELS_NUM 3
-#define CAMERAS_NUM 4
+#define GAIN_STRIDE 4	// Gain values per camera (RGB gains and alpha 1.0, uploaded as vec4 array)
 
 /*******************************************************************************************
  * Classes
@@ -50,10 +50,12 @@
 class Gains {
 	public:
 	
-		static Mat overlap_roi[CAMERAS_NUM][2];			// Overlaps ROI (two for each camera: left and right)
+		static vector< vector<Mat> > overlap_roi;		// Overlaps ROI (two for each camera: left and right)
 		static sem_t th_semaphore;						// Semaphore
 		static pthread_mutex_t th_mutex;				// Mutex
-		static float gain[CAMERAS_NUM][CHANELS_NUM];	// Gain values
+		static vector<float> gain;						// Gain values (GAIN_STRIDE per camera)
+		static struct timespec update_time;				// Time of the last gains update (CLOCK_MONOTONIC)
+		static double update_ms;						// Duration of the last gains update (ms)
 		Compensator* compensator;
 	
 		/**************************************************************************************************************
@@ -61,14 +63,16 @@ class Gains {
 		 * @brief  			Gains class constructor.
 		 *
 		 * @param	in		int width - display width;
-		 *					int height - display height.
+		 *					int height - display height;
+		 *					const vector<int> &camera_ring - camera indexes in the ring order.
 		 *
 		 * @return 			The function creates the Gains object.
 		 *
-		 * @remarks 		The function creates Gains object and sets object attributes.
+		 * @remarks 		The function creates Gains object and sets object attributes. The overlap region between
+		 *					two cameras is the right region of the first camera and the left region of the next one.
 		 *
 		 **************************************************************************************************************/
-		Gains(int width, int height);
+		Gains(int width, int height, const vector<int> &camera_ring);
 	
 		/**************************************************************************************************************
 		 *
@@ -99,6 +103,7 @@ class Gains {
 	private:
 		pthread_t update_gains_th = 0;	// Thread for exposure correction calculation
 		static int exit_flag;		// Exit flag
+		static vector<int> ring;	// Camera indexes in the ring order
 		/**************************************************************************************************************
 		 *
 		 * @brief  			Calculate exposure correction coefficients.
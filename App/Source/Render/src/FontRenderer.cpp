@@ -35,12 +35,12 @@ FontRenderer::FontRenderer(int width, int height, string atlas)
 	this->fontAtlas= atlas;
 	this->size = 1.0f;
 	this->texFont = 0;
-	this->small_quad = 0;
-	this->small_quad_tex = 0;
+	this->vao = 0;
+	this->vbo = 0;
 	this->shaderProgram = 0;
 	this->texLoc = 0;
 	this->colorLoc = 0;
-	this->matLoc = 0;
+	this->glyphs = 0;
 	
 
 }
@@ -66,23 +66,21 @@ void FontRenderer::Initialize(void)
 	
 	assert(GL_NO_ERROR == glGetError() && "An error occured during font texture loading.");
 
-	// Init data for texture quads
-	GLfloat vertattribs[] = { 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 1.0f };
-	GLfloat texattribs[] = { 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
-	
-	glGenBuffers(1, &small_quad);
-	glBindBuffer(GL_ARRAY_BUFFER, small_quad);
-	glBufferData(GL_ARRAY_BUFFER, 8L * (GLsizeiptr)sizeof(GLfloat), &vertattribs, GL_STATIC_DRAW);
-	glVertexAttribPointer(GLuint(0), 2, GL_FLOAT, GL_FALSE, 0, 0);
+	// Streaming vertex buffer for glyph quads: screen position and texture coordinates per vertex
+	GLsizei stride = FONT_VERTEX_SIZE * (GLsizei)sizeof(GLfloat);
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)FONT_BATCH_GLYPHS * FONT_GLYPH_VERTICES * stride, NULL, GL_DYNAMIC_DRAW);
+	glVertexAttribPointer(GLuint(0), 2, GL_FLOAT, GL_FALSE, stride, 0);
 	glEnableVertexAttribArray(0);
-	//also texcoords
-	glGenBuffers(1, &small_quad_tex);
-	glBindBuffer(GL_ARRAY_BUFFER, small_quad_tex);
-	glBufferData(GL_ARRAY_BUFFER, 8L * (GLsizeiptr)sizeof(GLfloat), &texattribs, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(GLuint(1), 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glVertexAttribPointer(GLuint(1), 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(2 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
-
+	glBindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	vertices.reserve(FONT_BATCH_GLYPHS * FONT_GLYPH_VERTICES * FONT_VERTEX_SIZE);
 	
 	assert(GL_NO_ERROR == glGetError() && "An error occured during font VBO loading.");
 }
@@ -90,8 +88,8 @@ void FontRenderer::Initialize(void)
 FontRenderer::~FontRenderer(void)
 {
 	glDeleteTextures(1, &texFont);	
-	glDeleteBuffers(1, &small_quad);
-	glDeleteBuffers(1, &small_quad_tex);
+	glDeleteBuffers(1, &vbo);
+	glDeleteVertexArrays(1, &vao);
 }
 
 void FontRenderer::SetShader(GLuint shader)
@@ -104,22 +102,58 @@ void FontRenderer::SetShader(GLuint shader)
 	assert(texLoc != -1);
 	colorLoc = glGetUniformLocation(shaderProgram, "color");
 	assert(colorLoc != -1);
-	matLoc = glGetUniformLocation(shaderProgram, "mat");
-	assert(matLoc != -1);
 }
 
-void FontRenderer::RenderText(const char *text, float top, float left)
+void FontRenderer::AddText(const char *text, float top, float left, float scale)
 {
 	if (top < 0.0f || left < 0.0f) {
 		return; }
-	
+
+	FontText entry;
+	entry.text = text;
+	entry.top = top;
+	entry.left = left;
+	entry.scale = scale;
+	frameText.push_back(entry);
+}
+
+void FontRenderer::Flush(void)
+{
 	if (shaderProgram == 0U) {
+		frameText.clear();
+		return; }
+
+	// Glyph quads are regenerated only if the strings have changed since the last frame
+	if (!(frameText == drawnText))
+	{
+		vertices.clear();
+		glyphs = 0;
+		for (unsigned int i = 0; i < frameText.size(); i++)
+		{
+			glm::vec3 font_scale = ComputeFontSize() * frameText[i].scale;
+
+			//calculate real text position on a screen: the first glyph center is half of the glyph size
+			//from the top left corner (2.0 is the size of a screen in normalized coordinates (-1..1))
+			float tx = font_scale.x + 2.0f * (frameText[i].left / 100.0f);
+			float ty = font_scale.y + 2.0f * (frameText[i].top / 100.0f);
+
+			float x = -1.0f + tx;
+			for (const char *p = frameText[i].text.c_str(); (*p != '\0') && (glyphs < FONT_BATCH_GLYPHS); p++)
+			{
+				AddGlyph((unsigned char)*p, x, 1.0f - ty, font_scale);
+				x += 2.0f * font_scale.x;
+			}
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(vertices.size() * sizeof(GLfloat)), vertices.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		drawnText.swap(frameText);
+	}
+	frameText.clear();
+
+	if (glyphs == 0) {
 		return; }
-	
-	//calculate real text position on a screen
-	float tx = GetRealFontSize() / (float)screenWidth + 2.0f * (left / 100.0f); // 2.0 is the size of a screen in normalized coordinates (-1..1)
-	//TODO: Compute correct value. Where is 0? Is the border included?
-	float ty = 0.1f; 
 	
 	glDisable(GL_DEPTH_TEST);
 	glActiveTexture(GL_TEXTURE0);
@@ -130,21 +164,10 @@ void FontRenderer::RenderText(const char *text, float top, float left)
 	glUniform1i(texLoc, 0);
 	glm::vec4 color = glm::vec4(0.0, 1.0, 0.0, 1.0);
 	glUniform4fv(colorLoc, 1, glm::value_ptr(color));
-	
-	glm::vec3 font_scale = ComputeFontSize();
-	glm::mat4 translation = glm::translate(glm::mat4(1.0f), glm::vec3(-1.0 + tx, 1.0 - ty, 0.0));
-	
-	const char *p;
-	for (p = text; *p != '\0'; p++) 
-	{
-		int glyphId = int(*p);
-		
-		glm::mat4 transMat = glm::scale(translation, font_scale);
-		glUniformMatrix4fv(matLoc, 1, GL_FALSE, glm::value_ptr(transMat)); 
-		
-		RenderGlyph(glyphId);	
-		translation = glm::translate(translation, glm::vec3(2.0f * GetRealFontSize() / (float)screenWidth, 0.0, 0.0));
-	}
+
+	glBindVertexArray(vao);
+	glDrawArrays(GL_TRIANGLES, 0, glyphs * FONT_GLYPH_VERTICES);
+	glBindVertexArray(0);
 	
 	glUseProgram(0);
 	
@@ -154,31 +177,39 @@ void FontRenderer::RenderText(const char *text, float top, float left)
 	glEnable(GL_DEPTH_TEST);
 }
 
-void FontRenderer::RenderGlyph(int glyphId)
+void FontRenderer::RenderText(const char *text, float top, float left)
+{
+	AddText(text, top, left);
+	Flush();
+}
+
+void FontRenderer::AddGlyph(int glyphId, float x, float y, glm::vec3 scale)
 {
 	int i = glyphId / FONT_TEX_GLYPH_COUNT; // i-th row in the font texture
 	int j = glyphId % FONT_TEX_GLYPH_COUNT; // j-th column in the font texture
 	
 	float normSize = ((float)FONT_TEX_GLYPH_SIZE) / ((float)FONT_TEX_SIZE);
     
-	//update texture attributes
+	//texture attributes
 	float texLeft = (float)j * normSize;
 	float texRight = texLeft + normSize;
 	float texTop = (float)i * normSize;
 	float texBottom = texTop + normSize;
-	
-	GLfloat texattribs[] = { texRight, texBottom, texRight, texTop, texLeft, texBottom, texLeft, texTop };
-
-	glBindBuffer(GL_ARRAY_BUFFER, small_quad);
-	glVertexAttribPointer(GLuint(0), 2, GL_FLOAT, GL_FALSE, 0, 0);  //bind attributes to index
 
-	glBindBuffer(GL_ARRAY_BUFFER, small_quad_tex);
-	glBufferData(GL_ARRAY_BUFFER, 8L * (GLsizeiptr)sizeof(GLfloat), &texattribs, GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(GLuint(1), 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	//glyph quad is centered at (x, y) with half size of the font scale
+	float left = x - scale.x, right = x + scale.x;
+	float bottom = y - scale.y, top = y + scale.y;
 	
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLfloat quad[FONT_GLYPH_VERTICES * FONT_VERTEX_SIZE] = {
+		right, bottom, texRight, texBottom,
+		right, top, texRight, texTop,
+		left, bottom, texLeft, texBottom,
+		left, bottom, texLeft, texBottom,
+		right, top, texRight, texTop,
+		left, top, texLeft, texTop };
+
+	vertices.insert(vertices.end(), quad, quad + FONT_GLYPH_VERTICES * FONT_VERTEX_SIZE);
+	glyphs++;
 }
 
 glm::vec3 FontRenderer::ComputeFontSize(void)
@@ -39,12 +39,52 @@ MRT::MRT(int mrtWidth, int mrtHeight)
 	this->fbo = 0;
 	this->depth = 0;
 	this->screenTex = 0;
-	this->videoTex = 0;
 }
 
 void MRT::Initialize(void)
 {
-	enabled = true;
+	// Offscreen target is allocated on the first Enable call: without post-processing the frame is rendered
+	// directly to the back buffer
+	enabled = false;
+
+	// Init data for texture quads
+	const GLfloat vertattribs[] = { 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 1.0f };
+	const GLfloat texattribs[] = { 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+	glGenBuffers(1, &small_quad);
+	glBindBuffer(GL_ARRAY_BUFFER, small_quad);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * 8, &vertattribs, GL_STATIC_DRAW);
+	glVertexAttribPointer(GLuint(0), 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glEnableVertexAttribArray(0);
+	//also texcoords
+	glGenBuffers(1, &small_quad_tex);
+	glBindBuffer(GL_ARRAY_BUFFER, small_quad_tex);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * 8, &texattribs, GL_STATIC_DRAW);
+	glVertexAttribPointer(GLuint(1), 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	assert(GL_NO_ERROR == glGetError());
+
+	cout << "MRT Support: " << ((MRT_ENABLED != 0) ? "On demand" : "Disabled") << endl;
+}
+
+bool MRT::Enable(void)
+{
+	if ((MRT_ENABLED != 0) && (fbo == 0U)) {
+		enabled = Allocate();
+	}
+	else {
+		enabled = (fbo != 0U);
+	}
+
+	return isEnabled();
+}
+
+bool MRT::Allocate(void)
+{
+	bool result = true;
 
 	//generate FBO
 	glGenFramebuffers(1, &fbo);
@@ -60,16 +100,10 @@ void MRT::Initialize(void)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,  width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-	//normal texture
-	glGenTextures(1, &videoTex);
-	glBindTexture(GL_TEXTURE_2D, videoTex);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,  width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glBindTexture(GL_TEXTURE_2D, 0);
 
 	//bind texture to FBO
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, screenTex, 0);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, videoTex, 0);
 	glFramebufferRenderbuffer(GL_FRAMEBUFFER,GL_DEPTH_ATTACHMENT,GL_RENDERBUFFER, depth);
 
 	// Test FrameBuffer completness
@@ -77,43 +111,41 @@ void MRT::Initialize(void)
 	if(status != (GLenum)GL_FRAMEBUFFER_COMPLETE)
 	{
 		cerr << "FrameBuffer initialization failed. Error: " << status << endl;
-		enabled = false;
+		result = false;
 	}
 
 	// Unbind FBO
 	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
 
-	// Init data for texture quads
-	const GLfloat vertattribs[] = { 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, 1.0f };
-	const GLfloat texattribs[] = { 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
-
-	glGenBuffers(1, &small_quad);
-	glBindBuffer(GL_ARRAY_BUFFER, small_quad);
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * 8, &vertattribs, GL_STATIC_DRAW);
-	glVertexAttribPointer(GLuint(0), 2, GL_FLOAT, GL_FALSE, 0, 0);
-	glEnableVertexAttribArray(0);
-	//also texcoords
-	glGenBuffers(1, &small_quad_tex);
-	glBindBuffer(GL_ARRAY_BUFFER, small_quad_tex);
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * 8, &texattribs, GL_STATIC_DRAW);
-	glVertexAttribPointer(GLuint(1), 2, GL_FLOAT, GL_FALSE, 0, 0);
-	glEnableVertexAttribArray(1);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if (!result)
+	{
+		// Incomplete target is released, so the next Enable call tries to allocate it again
+		glDeleteTextures(1, &screenTex);
+		glDeleteRenderbuffers(1, &depth);
+		glDeleteFramebuffers(1, &fbo);
+		screenTex = 0;
+		depth = 0;
+		fbo = 0;
+		return result;
+	}
 
-	assert(GL_NO_ERROR == glGetError());
+	cout << "MRT allocated: " << width << "x" << height << ", " << GetMemorySize() / 1024 << " KB" << endl;
 
-	cout << "MRT Support: " << (this->isEnabled() ? "Enabled" : "Disabled") << endl;
+	return result;
 }
 
 MRT::~MRT(void)
 {
 	//Delete resources
-	glDeleteTextures(1, &screenTex);
-	glDeleteTextures(1, &videoTex);
-	glDeleteRenderbuffers(1, &depth);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	glDeleteFramebuffers(1, &fbo);
+	glDeleteBuffers(1, &small_quad);
+	glDeleteBuffers(1, &small_quad_tex);
+	if (fbo != 0U)
+	{
+		glDeleteTextures(1, &screenTex);
+		glDeleteRenderbuffers(1, &depth);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &fbo);
+	}
 }
 
 void MRT::RenderSmallQuad(GLuint showTexP)
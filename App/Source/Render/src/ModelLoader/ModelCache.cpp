@@ -0,0 +1,234 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ModelLoader/ModelCache.hpp"
+
+#include <iostream>
+#include <fstream>
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+///header of the cache file
+struct CacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t hash;			//FNV-1a hash of the source model file
+	uint32_t materialCount;
+	uint32_t meshCount;
+	uint32_t pathBytes;		//size of the texture path table including padding
+	uint32_t vertexCount;	//vertices of all meshes
+	uint32_t indexCount;	//indices of all meshes
+	uint32_t reserved;
+};
+
+static size_t CacheSize(const CacheHeader &header)
+{
+	return sizeof(CacheHeader) +
+		(size_t)header.materialCount * sizeof(CacheMaterial) +
+		(size_t)header.meshCount * sizeof(CacheMesh) +
+		(size_t)header.pathBytes +
+		(size_t)header.vertexCount * MODEL_VERTEX_SIZE * sizeof(GLfloat) +
+		(size_t)header.indexCount * sizeof(GLuint);
+}
+
+ModelCache::ModelCache(void)
+	: data(NULL), size(0), materials(NULL), meshes(NULL), meshCount(0),
+	vertices(NULL), indices(NULL), vertexCount(0), indexCount(0)
+{
+}
+
+ModelCache::~ModelCache(void)
+{
+	Close();
+}
+
+int ModelCache::HashFile(const string &path, uint64_t &hash)
+{
+	ifstream file(path.c_str(), ios::binary);
+	if (!file.is_open()) {
+		cout << "Unable to open file: " << path << endl;
+		return -1;
+	}
+
+	hash = 14695981039346656037ULL;
+	char buffer[65536];
+	while (file) {
+		file.read(buffer, sizeof(buffer));
+		streamsize n = file.gcount();
+		for (streamsize i = 0; i < n; i++) {
+			hash ^= (uint8_t)buffer[i];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	return 0;
+}
+
+int ModelCache::Save(const string &path, uint64_t hash, const ModelData &model)
+{
+	CacheHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = MODEL_CACHE_MAGIC;
+	header.version = MODEL_CACHE_VERSION;
+	header.hash = hash;
+	header.materialCount = (uint32_t)model.materials.size();
+	header.meshCount = (uint32_t)model.meshes.size();
+	header.vertexCount = (uint32_t)(model.vertices.size() / MODEL_VERTEX_SIZE);
+	header.indexCount = (uint32_t)model.indices.size();
+
+	string paths;
+	for (unsigned int i = 0; i < model.texPaths.size(); i++) {
+		paths += model.texPaths[i];
+	}
+	//keep vertex data 4 bytes aligned
+	paths.resize((paths.size() + 3) & ~(size_t)3, '\0');
+	header.pathBytes = (uint32_t)paths.size();
+
+	//write to the temporary file first, so the cache is never left partially written
+	string tmp = path + ".tmp";
+	ofstream file(tmp.c_str(), ios::binary | ios::trunc);
+	if (!file.is_open()) {
+		cout << "Unable to create file: " << tmp << endl;
+		return -1;
+	}
+
+	file.write((const char*)&header, sizeof(header));
+	if (header.materialCount > 0)
+		file.write((const char*)&model.materials[0], header.materialCount * sizeof(CacheMaterial));
+	if (header.meshCount > 0)
+		file.write((const char*)&model.meshes[0], header.meshCount * sizeof(CacheMesh));
+	file.write(paths.data(), paths.size());
+	if (header.vertexCount > 0)
+		file.write((const char*)&model.vertices[0], model.vertices.size() * sizeof(GLfloat));
+	if (header.indexCount > 0)
+		file.write((const char*)&model.indices[0], model.indices.size() * sizeof(GLuint));
+	file.close();
+
+	if (file.fail() || (rename(tmp.c_str(), path.c_str()) != 0)) {
+		cout << "Unable to write file: " << path << endl;
+		remove(tmp.c_str());
+		return -1;
+	}
+
+	return 0;
+}
+
+bool ModelCache::Open(const string &path, uint64_t hash)
+{
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(CacheHeader))) {
+		close(fd);
+		return false;
+	}
+
+	size = (size_t)st.st_size;
+	data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		data = NULL;
+		size = 0;
+		return false;
+	}
+
+	const CacheHeader *header = (const CacheHeader*)data;
+	if ((header->magic != MODEL_CACHE_MAGIC) || (header->version != MODEL_CACHE_VERSION) ||
+		(header->hash != hash) || (header->meshCount == 0) || (header->materialCount > MODEL_MATERIAL_MAX) ||
+		(CacheSize(*header) != size)) {
+		Close();
+		return false;
+	}
+
+	const uint8_t *ptr = (const uint8_t*)data + sizeof(CacheHeader);
+	materials = (const CacheMaterial*)ptr;
+	ptr += header->materialCount * sizeof(CacheMaterial);
+	meshes = (const CacheMesh*)ptr;
+	ptr += header->meshCount * sizeof(CacheMesh);
+
+	//texture paths
+	const char *paths = (const char*)ptr;
+	size_t offset = 0;
+	for (unsigned int i = 0; i < header->materialCount; i++) {
+		if (offset + materials[i].pathLength > header->pathBytes) {
+			Close();
+			return false;
+		}
+		texPaths.push_back(string(paths + offset, materials[i].pathLength));
+		offset += materials[i].pathLength;
+	}
+	ptr += header->pathBytes;
+
+	//vertices and indices of the model
+	size_t meshVertices = 0, meshIndices = 0;
+	for (unsigned int i = 0; i < header->meshCount; i++) {
+		if ((meshes[i].materialId < 0) || ((uint32_t)meshes[i].materialId >= header->materialCount)) {
+			Close();
+			return false;
+		}
+		meshVertices += meshes[i].vertexCount;
+		meshIndices += meshes[i].indexCount;
+	}
+
+	if ((meshVertices != header->vertexCount) || (meshIndices != header->indexCount)) {
+		Close();
+		return false;
+	}
+
+	meshCount = header->meshCount;
+	vertexCount = header->vertexCount;
+	indexCount = header->indexCount;
+	vertices = (const GLfloat*)ptr;
+	indices = (const GLuint*)(ptr + (size_t)vertexCount * MODEL_VERTEX_SIZE * sizeof(GLfloat));
+
+	return true;
+}
+
+void ModelCache::Close(void)
+{
+	if (data != NULL) {
+		munmap(data, size);
+	}
+	data = NULL;
+	size = 0;
+	materials = NULL;
+	meshes = NULL;
+	meshCount = 0;
+	texPaths.clear();
+	vertices = NULL;
+	indices = NULL;
+	vertexCount = 0;
+	indexCount = 0;
+}
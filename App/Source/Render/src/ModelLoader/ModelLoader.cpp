@@ -29,13 +29,14 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 ModelLoader::ModelLoader(void)
-	: isInitialized(false)
+	: isInitialized(false), object(NULL), materialBuffer(0), blockShader(0), memorySize(0)
 {
 }
 
@@ -51,15 +52,15 @@ ModelLoader::~ModelLoader(void)
 	}
 	materials.clear();
 
-	for(VBOListIter iterator = objects.begin(); iterator != objects.end(); iterator++)
-	{
-		VBO* object = *(iterator);
-		if (object != NULL) {
-			delete object;
-		}
+	if (object != NULL) {
+		delete object;
+		object = NULL;
 	}
-	materials.clear();
 
+	if (materialBuffer != 0) {
+		glDeleteBuffers(1, &materialBuffer);
+		materialBuffer = 0;
+	}
 }
 string ModelLoader::GetModelFileName(void)
 {
@@ -81,15 +82,60 @@ string ModelLoader::GetModelFileName(void)
 
 bool ModelLoader::Initialize(void)
 {
-	bool result = true;
-
 	string filename = GetModelFileName();
 	if (filename.empty()) {
 		return false;
 	}
 	
 	string filepath = "../Content/models/" + filename;
+	string cachepath = filepath + MODEL_CACHE_EXT;
+
+	uint64_t hash;
+	if (ModelCache::HashFile(filepath, hash) != 0) {
+		return false;
+	}
+
+	ModelCache cache;
+	if (cache.Open(cachepath, hash))
+	{
+		//Cache hit: upload mapped data directly
+		cout << "Loading model: " << cachepath << endl;
+		for (unsigned int i = 0; i < cache.GetMaterialCount(); i++) {
+			AddMaterial(cache.GetMaterial(i), cache.GetTexPath(i));
+		}
+		CreateObject(&cache.GetMesh(0), cache.GetMeshCount(),
+				cache.GetVertices(), cache.GetVertexCount(), cache.GetIndices(), cache.GetIndexCount());
+		cache.Close();
+	}
+	else
+	{
+		//Cache miss: import the model with Assimp and save the post-processed scene for the next start
+		ModelData model;
+		if (!Import(filepath, model)) {
+			return false;
+		}
+
+		if (ModelCache::Save(cachepath, hash, model) == 0) {
+			cout << "Model cache saved: " << cachepath << endl;
+		}
+
+		for (unsigned int i = 0; i < model.materials.size(); i++) {
+			AddMaterial(model.materials[i], model.texPaths[i]);
+		}
+		CreateObject(&model.meshes[0], (unsigned int)model.meshes.size(),
+				&model.vertices[0], (unsigned int)(model.vertices.size() / MODEL_VERTEX_SIZE),
+				&model.indices[0], (unsigned int)model.indices.size());
+	}
+
+	cout << "Scene loaded: " << object->GetCount() / 3 << " polygons, 1 draw call.\n\n";
 	
+	isInitialized = true;
+
+	return true;
+}
+
+bool ModelLoader::Import(const string &filepath, ModelData &model)
+{
 	cout << "Loading model: " << filepath << endl;
 	Assimp::Importer importer;
 
@@ -115,6 +161,13 @@ bool ModelLoader::Initialize(void)
 		return false;
 	}
 
+	//Material table of the shader has a fixed size, so the model is not imported and cached
+	if (scene->mNumMaterials > MODEL_MATERIAL_MAX)
+	{
+		cerr << "Model Loader: " << scene->mNumMaterials << " materials exceed " << MODEL_MATERIAL_MAX << " materials of the shader" << endl;
+		return false;
+	}
+
 	//Load materials
 	for (unsigned int i = 0; i < scene->mNumMaterials; i++)
 	{
@@ -151,21 +204,13 @@ bool ModelLoader::Initialize(void)
 			cout << "Cannot load shininess property" << endl;;
 		}
 
-		Material *mat = new Material( 
-			glm::vec3(ambient.r, ambient.g, ambient.b), 
-			glm::vec3(diffuse.r, diffuse.g, diffuse.b), 
-			glm::vec3(specular.r, specular.g, specular.b),
-			glm::max(shininess, 255.0f));
-
-		materials.push_back(mat);
-
 		//Loads up base textures for material
 		//TODO: What to do when the count is greater than 1
+		string path;
 		unsigned int numTex = m->GetTextureCount(aiTextureType_DIFFUSE);
 		for (unsigned int j = 0; j < numTex; ++j)
 		{
 			//Textures
-			string path;
 			aiString pth;
 			aiReturn texFound;
 
@@ -175,93 +220,133 @@ bool ModelLoader::Initialize(void)
 				break;
 			}
 
-			path += pth.C_Str();
-
 			//TODO: implement to method
-			cout << "Texture: " << path << endl;
+			cout << "Texture: " << pth.C_Str() << endl;
+			if (path.empty()) {
+				path = pth.C_Str();
+			}
 		}
+
+		CacheMaterial mat;
+		mat.ambient[0] = ambient.r; mat.ambient[1] = ambient.g; mat.ambient[2] = ambient.b;
+		mat.diffuse[0] = diffuse.r; mat.diffuse[1] = diffuse.g; mat.diffuse[2] = diffuse.b;
+		mat.specular[0] = specular.r; mat.specular[1] = specular.g; mat.specular[2] = specular.b;
+		mat.shininess = glm::max(shininess, 255.0f);
+		mat.pathLength = (uint32_t)path.size();
+
+		model.materials.push_back(mat);
+		model.texPaths.push_back(path);
 	}
 
 	cout << "\nLoading scene ( " << scene->mNumMeshes << " objects ):" << endl;
 	cout << "-------------------------------------------------------------------------------" << endl;
 
+	//Meshes are merged in order of materials, so every material is a continuous range of the model
+	vector<unsigned int> order;
+	for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+		order.push_back(i);
+	}
+	stable_sort(order.begin(), order.end(), [scene](unsigned int a, unsigned int b) {
+		return scene->mMeshes[a]->mMaterialIndex < scene->mMeshes[b]->mMaterialIndex; });
+
 	//Load meshes
 	aiMesh * mesh;
-	unsigned int polygons = 0;
 	for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
 	{
-		mesh = scene->mMeshes[i];
+		mesh = scene->mMeshes[order[i]];
+		GLuint first = (GLuint)(model.vertices.size() / MODEL_VERTEX_SIZE);
 
 		if (mesh->mNumFaces == 0U) {
 			continue;
 		}
 
-		polygons += mesh->mNumFaces;
+		//Interleave position, normal and texture coordinates (if present) of every vertex.
+		//aiProcess_JoinIdenticalVertices is turned on, so the faces share vertices
+		bool texcoords = mesh->HasTextureCoords(0);
+		for (unsigned int v = 0; v < mesh->mNumVertices; v++)
+		{
+			model.vertices.push_back(mesh->mVertices[v].x);
+			model.vertices.push_back(mesh->mVertices[v].y);
+			model.vertices.push_back(mesh->mVertices[v].z);
+			model.vertices.push_back(mesh->mNormals[v].x);
+			model.vertices.push_back(mesh->mNormals[v].y);
+			model.vertices.push_back(mesh->mNormals[v].z);
+			model.vertices.push_back(texcoords ? mesh->mTextureCoords[0][v].x : 0.0f);
+			model.vertices.push_back(texcoords ? mesh->mTextureCoords[0][v].y : 0.0f);
+		}
+
+		//aiProcess_Triangulate is turned on, so every face has 3 vertices
+		for (unsigned int f = 0; f < mesh->mNumFaces; f++)
+		{
+			aiFace *face = &mesh->mFaces[f];
+			for (unsigned int k = 0; k < 3U; k++) {
+				model.indices.push_back(first + (GLuint)face->mIndices[k]);
+			}
+		}
 
-		//Create object from mesh
+		CacheMesh m;
+		m.materialId = (int32_t)mesh->mMaterialIndex;
+		m.vertexCount = mesh->mNumVertices;
+		m.indexCount = mesh->mNumFaces * 3U;
+		model.meshes.push_back(m);
 
-		 //count faces
-		int indices = (int)mesh->mNumFaces;
+		cout << "Done(vertices: " << mesh->mNumVertices << ", faces: " << mesh->mNumFaces << ")\n";
+	}
 
-				    // Allocate memory for our vertices and normals
-		Vertex *vertices = new Vertex[indices * 3];
-		Vertex *normals = new Vertex[indices * 3];
-		Coord *texcoords = new Coord[indices * 3];
+	if (model.meshes.empty())
+	{
+		cerr << "Model Loader: scene has no meshes!" << endl;
+		return false;
+	}
 
-		unsigned int FinishedFaces = 0;
+	return true;
+}
 
-				    // Loop through every face
-		for (unsigned curr_face = 0; curr_face < mesh->mNumFaces; curr_face++)
+void ModelLoader::AddMaterial(const CacheMaterial &material, const string &texPath)
+{
+	materials.push_back(new Material(
+		glm::vec3(material.ambient[0], material.ambient[1], material.ambient[2]),
+		glm::vec3(material.diffuse[0], material.diffuse[1], material.diffuse[2]),
+		glm::vec3(material.specular[0], material.specular[1], material.specular[2]),
+		material.shininess, texPath));
+}
+
+void ModelLoader::CreateObject(const CacheMesh *meshes, unsigned int meshCount,
+		const GLfloat *vertices, unsigned int vertexCount, const GLuint *indices, unsigned int indexCount)
+{
+	//Material index of every vertex. Import and the cache accept at most MODEL_MATERIAL_MAX materials
+	vector<GLubyte> vertexMaterials(vertexCount, 0);
+	size_t first = 0;
+	for (unsigned int i = 0; i < meshCount; i++)
+	{
+		fill(vertexMaterials.begin() + first, vertexMaterials.begin() + first + meshes[i].vertexCount, (GLubyte)meshes[i].materialId);
+		first += meshes[i].vertexCount;
+	}
+
+	object = new VBO(vertices, &vertexMaterials[0], (int)vertexCount, indices, (int)indexCount);
+
+	//Material table (std140: ambient, diffuse and specular are vec4)
+	vector<GLfloat> table(MODEL_MATERIAL_MAX * 12, 0.0f);
+	for (unsigned int i = 0; (i < materials.size()) && (i < MODEL_MATERIAL_MAX); i++)
+	{
+		glm::vec3 color[3] = { materials[i]->GetAmbient(), materials[i]->GetDiffuse(), materials[i]->GetSpecular() };
+		for (int j = 0; j < 3; j++)
 		{
-			aiFace *face = &mesh->mFaces[curr_face];
-
-							//aiProcess_Triangulate is turned on, so looping through 3 vertices
-			for (unsigned i = 0; i < 3U; i++)
-			{			
-				Vertex v;
-				v[0] = mesh->mVertices[face->mIndices[i]].x;
-				v[1] = mesh->mVertices[face->mIndices[i]].y;
-				v[2] = mesh->mVertices[face->mIndices[i]].z;
-
-									//vertices
-				memcpy(&vertices[FinishedFaces * 3U + i], &v, sizeof(Vertex));
-
-									//normals	
-				v[0] = mesh->mNormals[face->mIndices[i]].x;	
-				v[1] = mesh->mNormals[face->mIndices[i]].y;	
-				v[2] = mesh->mNormals[face->mIndices[i]].z;
-
-				memcpy(&normals[FinishedFaces * 3U + i], &v, sizeof(Vertex));
-
-
-									//texture coordinates (if present)
-				if (mesh->HasTextureCoords(0))
-				{	
-					Coord c;	
-					c[0] = mesh->mTextureCoords[0][face->mIndices[i]].x;	
-					c[1] = mesh->mTextureCoords[0][face->mIndices[i]].y;	
-					memcpy(&texcoords[FinishedFaces * 3U + i], &c, sizeof(Coord));	
-				}
-			}
-			FinishedFaces++;
+			table[i * 12 + j * 4 + 0] = color[j].x;
+			table[i * 12 + j * 4 + 1] = color[j].y;
+			table[i * 12 + j * 4 + 2] = color[j].z;
 		}
+	}
 
-			
-		int count = indices * 3;
-		objects.push_back(new VBO(vertices, normals, texcoords, count, mesh->mMaterialIndex)); 
+	glGenBuffers(1, &materialBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, materialBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)(table.size() * sizeof(GLfloat)), &table[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-				    // Clean up our allocated memory
-		delete[] vertices;
-		delete[] normals;
-		delete[] texcoords;
+	memorySize = (size_t)vertexCount * (MODEL_VERTEX_SIZE * sizeof(GLfloat) + sizeof(GLubyte)) +
+			(size_t)indexCount * sizeof(GLuint) + table.size() * sizeof(GLfloat);
 
-		cout << "Done(vertices: " << indices * 3 << ", faces: " << indices << ")\n";
-	}	
-	cout << "Scene loaded: " << polygons << " polygons.\n\n";
-	
-	isInitialized = result;
-
-	return result;
+	cout << "Model: " << meshCount << " meshes, " << materials.size() << " materials merged to one object" << endl;
 }
 
 void ModelLoader::Draw(GLuint shader)
@@ -269,27 +354,19 @@ void ModelLoader::Draw(GLuint shader)
 	if (!isInitialized) {
 		return;
 	}
-	
-	GLint ambientLoc = glGetUniformLocation(shader, "ambient");
-	GLint diffuseLoc = glGetUniformLocation(shader, "diffuse");
-	GLint specularLoc = glGetUniformLocation(shader, "specular");
 
-	for(VBOListIter iterator = objects.begin(); iterator != objects.end(); iterator++)
+	//Block binding is a program state, so it is set once per program
+	if (shader != blockShader)
 	{
-		VBO* vbo = *iterator;
-		int matId = vbo->GetMatId();
-		Material* mat = materials.at(matId);
-		
-		glm::vec3 ambient = mat->GetAmbient();
-		glUniform3f(ambientLoc, ambient.x, ambient.y, ambient.z);
-		glm::vec3 diffuse = mat->GetDiffuse();
-		glUniform3f(diffuseLoc, diffuse.x, diffuse.y, diffuse.z);
-		glm::vec3 specular = mat->GetSpecular();
-		glUniform3f(specularLoc, specular.x, specular.y, specular.z);
-
-		glBindVertexArray(vbo->GetVAO());
-		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vbo->GetCount());
-		glBindVertexArray( 0 );
+		GLuint block = glGetUniformBlockIndex(shader, "Materials");
+		if (block != GL_INVALID_INDEX) {
+			glUniformBlockBinding(shader, block, MODEL_MATERIAL_BINDING);
+		}
+		blockShader = shader;
 	}
 
+	glBindBufferBase(GL_UNIFORM_BUFFER, MODEL_MATERIAL_BINDING, materialBuffer);
+	glBindVertexArray(object->GetVAO());
+	glDrawElements(GL_TRIANGLES, (GLsizei)object->GetCount(), GL_UNSIGNED_INT, 0);
+	glBindVertexArray( 0 );
 }
@@ -24,43 +24,47 @@
 
 #include "ModelLoader/VBO.hpp"
 
-VBO::VBO(Vertex *vertices, Vertex *normals, Coord *texcoords, int count, int materialId)
+VBO::VBO(const GLfloat *vertices, const GLubyte *materials, int vertexCount, const GLuint *indices, int indexCount)
 {
-	this->count = (GLuint)count;
-	this->matId = materialId;
-	this->buffer[0] = 0; this->buffer[1] = 0; this->buffer[2] = 0; this->buffer[3] = 0;
+	this->count = (GLuint)indexCount;
+	this->buffer[0] = 0; this->buffer[1] = 0; this->buffer[2] = 0;
 	this->vao = 0;
 
 	//Vertex array
 	glGenVertexArrays(1, &vao);
 	glBindVertexArray(vao);
 
-	//Allocate and assign three VBO to our handle (vertices, normals and texture coordinates)
-	glGenBuffers(4, buffer);
+	//Allocate interleaved vertex buffer, material index buffer and index buffer
+	glGenBuffers(3, buffer);
 
-	//store vertices into buffer
+	//store interleaved vertices (position, normal, texture coordinates) into buffer
+	GLsizei stride = MODEL_VERTEX_SIZE * sizeof(GLfloat);
 	glBindBuffer(GL_ARRAY_BUFFER, buffer[P_VERTEX]);
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(Vertex) * count, vertices, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)stride * vertexCount, vertices, GL_STATIC_DRAW);
 	// vertices are on index 0 and contains three floats per vertex
-	glVertexAttribPointer(GLuint(0), 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glVertexAttribPointer(GLuint(0), 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)0);
 	glEnableVertexAttribArray(0);
-
-	//store normals into buffer
-	glBindBuffer(GL_ARRAY_BUFFER, buffer[P_NORMAL]);
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(Vertex) * count, normals, GL_STATIC_DRAW);
 	// normals are on index 1 and contains three floats per vertex
-	glVertexAttribPointer(GLuint(1), 3, GL_FLOAT, GL_FALSE, 0, 0);
+	glVertexAttribPointer(GLuint(1), 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(3 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
-
-	//store texture coordinates
-	glBindBuffer(GL_ARRAY_BUFFER, buffer[P_TEXCOORD]);    
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(Coord) * count, texcoords, GL_STATIC_DRAW);
-
 	//coordinates are on index 2 and contains two floats per vertex
-	glVertexAttribPointer(GLuint(2), 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glVertexAttribPointer(GLuint(2), 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(6 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(2);
 
+	//store material indices into buffer
+	glBindBuffer(GL_ARRAY_BUFFER, buffer[P_MATERIAL]);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLubyte) * vertexCount, materials, GL_STATIC_DRAW);
+	//material indices are on index 3 and contains one unsigned byte per vertex
+	glVertexAttribIPointer(GLuint(3), 1, GL_UNSIGNED_BYTE, 0, 0);
+	glEnableVertexAttribArray(3);
+
+	//store faces into buffer, the binding is a part of the vertex array state
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer[P_INDEX]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLuint) * indexCount, indices, GL_STATIC_DRAW);
+
 	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 VBO::~VBO(void)
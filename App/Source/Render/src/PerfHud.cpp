@@ -0,0 +1,218 @@
+/*
+*
+* Copyright 2017,2022 NXP
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice (including the next
+* paragraph) shall be included in all copies or substantial portions of the
+* Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PerfHud.hpp"
+
+#include <sstream>
+#include <iomanip>
+#include <string.h>
+
+#include "macros.hpp"
+
+using namespace std;
+
+PerfHud::PerfHud(int cameraNum)
+{
+	this->enabled = false;
+	this->frames = 0;
+	this->vertices = 0.0;
+	this->ecAge = 0.0;
+	this->ecTime = 0.0;
+	memset(&periodStart, 0, sizeof(periodStart));
+	memset(&stageStart, 0, sizeof(stageStart));
+	memset(stageTime, 0, sizeof(stageTime));
+	memset(memory, 0, sizeof(memory));
+
+	HudCamera camera;
+	memset(&camera, 0, sizeof(camera));
+	cameras.assign(cameraNum, camera);
+}
+
+PerfHud::~PerfHud(void)
+{
+}
+
+void PerfHud::Toggle(void)
+{
+	enabled = !enabled;
+	if (!enabled) {
+		return; }
+
+	// Start a new period
+	clock_gettime(CLOCK_MONOTONIC, &periodStart);
+	memset(stageTime, 0, sizeof(stageTime));
+	frames = 0;
+	vertices = 0.0;
+	for (unsigned int i = 0; i < cameras.size(); i++)
+	{
+		cameras[i].captured = cameras[i].current;
+		cameras[i].latency = 0.0;
+		cameras[i].samples = 0;
+	}
+	lines.assign(1, "HUD: collecting statistics...");
+}
+
+void PerfHud::Start(void)
+{
+	if (!enabled) {
+		return; }
+
+	clock_gettime(CLOCK_MONOTONIC, &stageStart);
+}
+
+void PerfHud::Stage(HudStage stage)
+{
+	if (!enabled) {
+		return; }
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	stageTime[stage] += timespec2doublems(timespec_sub(now, stageStart));
+	stageStart = now;
+}
+
+void PerfHud::FrameEnd(void)
+{
+	if (!enabled) {
+		return; }
+
+	frames++;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double period = timespec2doublems(timespec_sub(now, periodStart));
+	if (period >= HUD_UPDATE_MS)
+	{
+		Update(period);
+		periodStart = now;
+	}
+}
+
+void PerfHud::SetCamera(int camera, unsigned int captured, unsigned int dropped, double latency)
+{
+	if ((!enabled) || (camera < 0) || (camera >= (int)cameras.size())) {
+		return; }
+
+	cameras[camera].current = captured;
+	cameras[camera].dropped = dropped;
+	if (latency > 0.0)
+	{
+		cameras[camera].latency += latency;
+		cameras[camera].samples++;
+	}
+}
+
+void PerfHud::SetGains(const vector<float> &gain, int stride, double age, double duration)
+{
+	if (!enabled) {
+		return; }
+
+	for (unsigned int i = 0; (i < cameras.size()) && ((i + 1) * stride <= gain.size()); i++)
+	{
+		for (int color = 0; color < 3; color++) {
+			cameras[i].gain[color] = gain[i * stride + color];
+		}
+	}
+	ecAge = age;
+	ecTime = duration;
+}
+
+void PerfHud::AddMemory(HudMemory type, size_t bytes)
+{
+	memory[type] += bytes;
+}
+
+void PerfHud::AddVertices(int num)
+{
+	if (!enabled) {
+		return; }
+
+	vertices += (double)num;
+}
+
+void PerfHud::Update(double period)
+{
+	double n = (frames > 0) ? (double)frames : 1.0;
+	double frame = period / n;
+	lines.clear();
+
+	stringstream ss;
+	ss << fixed << setprecision(1) << "Frame " << frame << " ms (" << 1000.0 / frame << " fps), swap " 
+		<< stageTime[HUD_STAGE_SWAP] / n << " ms";
+	lines.push_back(ss.str());
+
+	ss.str("");
+	ss << fixed << setprecision(2) << "CPU ms: car " << stageTime[HUD_STAGE_CAR] / n
+		<< " bowl " << stageTime[HUD_STAGE_BOWL] / n
+		<< " top " << stageTime[HUD_STAGE_TOP] / n
+		<< " ec " << stageTime[HUD_STAGE_EC] / n
+		<< " mrt " << stageTime[HUD_STAGE_COMPOSE] / n
+		<< " text " << stageTime[HUD_STAGE_TEXT] / n;
+	lines.push_back(ss.str());
+
+	ss.str("");
+	ss << fixed << setprecision(0) << "Bowl vertices " << vertices / n;
+	lines.push_back(ss.str());
+
+	for (unsigned int i = 0; i < cameras.size(); i++)
+	{
+		HudCamera &camera = cameras[i];
+		camera.fps = 1000.0 * (double)(camera.current - camera.captured) / period;
+		double latency = (camera.samples > 0) ? camera.latency / (double)camera.samples : 0.0;
+
+		ss.str("");
+		ss << fixed << setprecision(1) << "Cam" << i << " " << camera.fps << " fps drop " << camera.dropped
+			<< " lat " << latency << " ms gain " << setprecision(2)
+			<< camera.gain[0] << " " << camera.gain[1] << " " << camera.gain[2];
+		lines.push_back(ss.str());
+
+		camera.captured = camera.current;
+		camera.latency = 0.0;
+		camera.samples = 0;
+	}
+
+	ss.str("");
+	ss << fixed << setprecision(1) << "EC age " << ecAge / 1000.0 << " s, update " << ecTime << " ms";
+	lines.push_back(ss.str());
+
+	ss.str("");
+	ss << fixed << setprecision(2) << "GPU MB: mesh " << (double)memory[HUD_MEM_MESH] / 1048576.0
+		<< " mask " << (double)memory[HUD_MEM_MASK] / 1048576.0
+		<< " tex " << (double)memory[HUD_MEM_TEXTURE] / 1048576.0;
+	lines.push_back(ss.str());
+
+	memset(stageTime, 0, sizeof(stageTime));
+	frames = 0;
+	vertices = 0.0;
+}
+
+void PerfHud::Render(FontRenderer *font, float top, float left)
+{
+	if (!enabled) {
+		return; }
+
+	float height = font->GetLineHeight(HUD_TEXT_SCALE);
+	for (unsigned int i = 0; i < lines.size(); i++) {
+		font->AddText(lines[i].c_str(), top + (float)i * height, left, HUD_TEXT_SCALE);
+	}
+}
@@ -34,6 +34,7 @@ static bool RenderInit(void)
 {
 	camerasInit();  // Camera capturing
 	camTexInit();	// Camera textures initialization 
+	topTexInit();	// Bird's-eye grid
 	ecTexInit();	// Exposure correction
 	
 	glBlendFunc(GL_ONE_MINUS_DST_ALPHA, GL_DST_ALPHA);  // Enable blending
@@ -44,20 +45,124 @@ static bool RenderInit(void)
 
 	// We have to initialize all utils here, because they need OpenGL context
 	if (!modelLoader.Initialize()) { cout << "Car model was not initialized" << endl; }
-	mrt->Initialize();
+	mrt->Initialize();	// Offscreen target is allocated by mrt->Enable() only when a post-process needs it
 	fontRenderer->Initialize();
 	fontRenderer->SetShader(fontProgram.getHandle());
+
+	// GPU memory of the car model, MRT target and font atlas (8 bits)
+	hud->AddMemory(HUD_MEM_MESH, modelLoader.GetMemorySize());
+	hud->AddMemory(HUD_MEM_TEXTURE, mrt->GetMemorySize());
+	hud->AddMemory(HUD_MEM_TEXTURE, (size_t)FONT_TEX_SIZE * FONT_TEX_SIZE);
 	return ((GLenum)GL_NO_ERROR == glGetError());
 }
 /***************************************************************************************
 ***************************************************************************************/
+// Current orbit camera state, interpolated from the previous state while a transition is running
+static void viewState(glm::quat &rotation, glm::vec3 &position)
+{
+	rotation = glm::angleAxis(ry, glm::vec3(1, 0, 0)) * glm::angleAxis(rx, glm::vec3(0, 0, 1));
+	position = glm::vec3(px, py, pz);
+	if (!transition) { return; }
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	float t = (transition_ms > 0.0) ? (float)(timespec2doublems(timespec_sub(now, transition_start)) / transition_ms) : 1.0f;
+	if (t >= 1.0f)
+	{
+		transition = false;
+		return;
+	}
+	t = t * t * (3.0f - 2.0f * t); // Ease in and out
+	rotation = glm::slerp(from_rotation, rotation, t);
+	position = glm::mix(from_position, position, t);
+}
+/***************************************************************************************
+***************************************************************************************/
+// Start the transition of the orbit camera to the view preset. Returns -1 if there is no such preset.
+// Mouse and keys keep working during the transition: they move its target.
+static int viewPreset(int index)
+{
+	if ((index < 0) || (index >= (int)presets.size()))
+	{
+		cout << "View preset " << index << " was not found" << endl;
+		return (-1);
+	}
+	viewState(from_rotation, from_position);	// A running transition continues from the current state
+	rx = presets[index].rx;
+	ry = presets[index].ry;
+	px = presets[index].position.x;
+	py = presets[index].position.y;
+	pz = presets[index].position.z;
+	preset_index = index;
+	clock_gettime(CLOCK_MONOTONIC, &transition_start);
+	transition = true;
+	cout << "View preset: " << presets[index].name << endl;
+	return (0);
+}
+/***************************************************************************************
+***************************************************************************************/
+// Calculate matrices of all viewports and of the car model once per frame
+static void viewsUpdate(void)
+{
+	glm::quat rotation;
+	glm::vec3 position;
+	viewState(rotation, position);
+	glm::mat4 orbit = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+	glm::mat4 top = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, VIEW_TOP_Z));
+	for (uint i = 0; i < views.size(); i++)
+	{
+		views[i].remap = top_remap && (views[i].type == VIEW_TOP) && (vertices_top > 0);
+		views[i].mv = (views[i].type == VIEW_TOP) ? top : orbit;
+		views[i].mvp = (views[i].remap ? views[i].ortho : views[i].projection) * views[i].mv;
+		views[i].carMvp = views[i].mvp * carModelMatrix;
+		views[i].carMn = glm::mat3(views[i].mv) * glm::mat3(carRotation);
+
+		// Frustum planes: rows of mvp are combined as w +- x, w +- y, w +- z
+		const glm::mat4 &m = views[i].mvp;
+		for (int k = 0; k < 6; k++)
+		{
+			int row = k / 2;
+			float sign = (k % 2 == 0) ? 1.0f : -1.0f;
+			glm::vec4 plane(m[0][3] + sign * m[0][row], m[1][3] + sign * m[1][row], m[2][3] + sign * m[2][row], m[3][3] + sign * m[3][row]);
+			views[i].planes[k] = plane / glm::length(glm::vec3(plane));
+		}
+
+		// Level of detail of each camera grid from the projected size of its bounding sphere. The size is taken
+		// from the projection the view is drawn with: clip w is the eye depth for perspective and 1 for ortho.
+		const glm::mat4 &p = views[i].remap ? views[i].ortho : views[i].projection;
+		for (int camera = 0; camera < camera_num; camera++)
+		{
+			glm::vec4 clip = views[i].mvp * glm::vec4(glm::vec3(bowlSphere[camera]), 1.0f);
+			float size = bowlSphere[camera].w * p[1][1] / max(clip.w, 0.1f);
+			int level = 0;
+			while ((level + 1 < lod_num) && (size * (float)(1 << (level + 1)) < LOD_FULL_SIZE)) { level++; }
+			views[i].lod[camera] = level;
+		}
+	}
+}
+/***************************************************************************************
+***************************************************************************************/
+// Render car model in all viewports with depth test and depth writes
+static void carRender(void)
+{
+	glUseProgram(carModelProgram.getHandle());
+	for (uint i = 0; i < views.size(); i++)
+	{
+		// Set matrices
+		glViewport(views[i].rect[0], views[i].rect[1], views[i].rect[2], views[i].rect[3]);
+		glUniformMatrix4fv(mvpUniform, 1, GL_FALSE, glm::value_ptr(views[i].carMvp));
+		glUniformMatrix4fv(mvUniform, 1, GL_FALSE, glm::value_ptr(views[i].mv));
+		glUniformMatrix3fv(mnUniform, 1, GL_FALSE, glm::value_ptr(views[i].carMn));
+
+		modelLoader.Draw(carModelProgram.getHandle());
+	}
+}
+/***************************************************************************************
+***************************************************************************************/
 // Actual rendering here.
 static void Render(void)
 {
-	// Calculate ModelViewProjection matrix
-	glm::mat4 mv = glm::rotate(glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(px, py, pz)), ry, glm::vec3(1, 0, 0)), rx, glm::vec3(0, 0, 1));
-	glm::mat4 mvp = gProjection*mv;
-	glm::mat3 mn = glm::mat3(glm::rotate(glm::rotate(glm::mat4(1.0f), ry, glm::vec3(1, 0, 0)), rx, glm::vec3(0, 1, 0)));
+	viewsUpdate();
 
 	GLuint mrtFBO = 0;
 	if (mrt->isEnabled())
@@ -70,110 +175,89 @@ static void Render(void)
 
 	if (expcor < 600)
 	{	
-		glEnable(GL_BLEND);
-		glDisable(GL_DEPTH_TEST);
-		
 		// Clear background.
 		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Render car model first, so the bowl fragments hidden by the car are rejected by early depth test
+		glDisable(GL_BLEND);
+		glEnable(GL_DEPTH_TEST);
+		carRender();
+		hud->Stage(HUD_STAGE_CAR);
+
+		// Bowl is placed at the far plane without depth writes: it passes only where the car has not been drawn,
+		// so the car stays on top of the bowl as if it was drawn last
+		glDepthRangef(1.0f, 1.0f);
+		glDepthFunc(GL_LEQUAL);
+		glDepthMask(GL_FALSE);
+		glEnable(GL_BLEND);
 		
-		// Render camera frames
-		int i;
+		// Lock the camera frames and bind them to the texture units 0..camera_num - 1.
+		// The camera mutex is shared by all cameras (static member), so it is locked once for the whole batch
+		pthread_mutex_lock(&v4l2Camera::th_mutex);
+		for (int camera = 0; camera < camera_num; camera++)
+		{
+			glActiveTexture(GL_TEXTURE0 + camera);
+			glBindTexture(GL_TEXTURE_EXTERNAL_OES, v4l2_cameras[camera].getFrame());
+			if (!blend_weights) // Blend weight is sampled from the camera mask
+			{
+				glActiveTexture(GL_TEXTURE0 + CAMERA_MAX + camera);
+				glBindTexture(GL_TEXTURE_2D, txtMask[camera]);
+			}
+		}
 
-		// Render overlap regions of camera frame with blending
+		// Render overlap regions of all camera frames with blending.
+		// Frames, gains and grids are shared by all viewports, only the viewport and the matrix are changed per view
 		glUseProgram(renderProgram.getHandle());
-		for (int camera = 0; camera < CAMERA_NUM; camera++)
+		glUniform4fv(locGain[0], camera_num, &gain->Gains::gain[0]); // Set gain values for all cameras
+		glBindVertexArray(VAO[0]);
+		for (uint i = 0; i < views.size(); i++)
 		{
-			// Lock the camera frame
-			pthread_mutex_lock(&v4l2_cameras[camera].th_mutex);
-
-			// Get index of the newes camera buffer
-			if (v4l2_cameras[camera].fill_buffer_inx == -1) { i = 0; }
-			else  { i = v4l2_cameras[camera].fill_buffer_inx; }
-
-
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, txtMask[camera]);
-			glUniform1i(glGetUniformLocation(renderProgram.getHandle(), "myMask"), 1);
-						
-			// Set gain value for the camera
-			glUniform4f(locGain[0], gain->Gains::gain[camera][0], gain->Gains::gain[camera][1], gain->Gains::gain[camera][2], 1.0f);
-
-			// Render overlap regions of camera frame with blending
-			glBindVertexArray(VAO[2 * camera]);
-			glActiveTexture(GL_TEXTURE0);
-			//glBindTexture(GL_TEXTURE_2D, gTexObj[2 * camera]);
-			//glBindTexture(GL_TEXTURE_2D,v4l2_cameras[camera].getFrame());
-			glBindTexture(GL_TEXTURE_EXTERNAL_OES,v4l2_cameras[camera].getFrame());
-			glUniform1i(glGetUniformLocation(renderProgram.getHandle(), "myTexture"), 0);
-			//mapFrame(i, camera);
-				
-			GLint mvpLoc = glGetUniformLocation(renderProgram.getHandle(), "mvp");
-			glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp)); 
-	
-			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices[2 * camera]);
-			glBindVertexArray(0);
-	
-			// Release camera frame
-			pthread_mutex_unlock(&v4l2_cameras[camera].th_mutex);
+			if (views[i].remap) { continue; } // Bird's-eye grid is drawn instead of the bowl
+			glViewport(views[i].rect[0], views[i].rect[1], views[i].rect[2], views[i].rect[3]);
+			glUniformMatrix4fv(locMvp[0], 1, GL_FALSE, glm::value_ptr(views[i].mvp));
+			hud->AddVertices(bowlDraw(views[i], 0));
 		}
 
-
-
-
-
-		// Render non-overlap region of camera frame without blending
+		// Render non-overlap regions of all camera frames without blending
 		glUseProgram(renderProgramWB.getHandle()); 	// Use fragment shader without blending
 		glDisable(GL_BLEND); 
-		for (int camera = 0; camera < CAMERA_NUM; camera++)
+		glUniform4fv(locGain[1], camera_num, &gain->Gains::gain[0]); // Set gain values for all cameras
+		glBindVertexArray(VAO[1]);
+		for (uint i = 0; i < views.size(); i++)
 		{
-			// Lock the camera frame
-			pthread_mutex_lock(&v4l2_cameras[camera].th_mutex);
-
-			// Get index of the newes camera buffer
-			if (v4l2_cameras[camera].fill_buffer_inx == -1) { i = 0; }
-			else  { i = v4l2_cameras[camera].fill_buffer_inx; }
-
-			// Set gain value for the camera
-			glUniform4f(locGain[1], gain->Gains::gain[camera][0], gain->Gains::gain[camera][1], gain->Gains::gain[camera][2], 1.0f); // Set gain value for the camera
-
-			// Render non-overlap region of camera frame without blending				
-			glBindVertexArray(VAO[2 * camera + 1]);
-			glActiveTexture(GL_TEXTURE0);
-			//glBindTexture(GL_TEXTURE_2D, gTexObj[2 * camera+ 1]);
-			//glBindTexture(GL_TEXTURE_2D,v4l2_cameras[camera].getFrame());
-			glBindTexture(GL_TEXTURE_EXTERNAL_OES,v4l2_cameras[camera].getFrame());
-			glUniform1i(glGetUniformLocation(renderProgramWB.getHandle(), "myTexture"), 0);
-			//mapFrame(i, camera);		
-			
-			GLint mvpLoc = glGetUniformLocation(renderProgramWB.getHandle(), "mvp");
-			glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, glm::value_ptr(mvp)); 
-						
-			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices[2 * camera+ 1]);	// Draw texture
-			glBindVertexArray(0);
-
-			// Release camera frame
-			pthread_mutex_unlock(&v4l2_cameras[camera].th_mutex);
+			if (views[i].remap) { continue; } // Bird's-eye grid is drawn instead of the bowl
+			glViewport(views[i].rect[0], views[i].rect[1], views[i].rect[2], views[i].rect[3]);
+			glUniformMatrix4fv(locMvp[1], 1, GL_FALSE, glm::value_ptr(views[i].mvp));
+			hud->AddVertices(bowlDraw(views[i], 1));	// Draw texture
 		}
-		if (mrt->isEnabled() == false)
+		hud->Stage(HUD_STAGE_BOWL);
+
+		// Render bird's-eye grid of top views. Two cameras are mixed in the shader, so one pass without blending is enough
+		if (vertices_top > 0)
 		{
-			// Render car model
-			glm::mat4 carModelMatrix = glm::rotate(glm::rotate(glm::scale(glm::mat4(1.0f), car_scale), glm::radians(CAR_ORIENTATION_X), glm::vec3(1, 0, 0)),
-				glm::radians(CAR_ORIENTATION_Y), glm::vec3(0, 1, 0));
-			mvp = gProjection * mv * carModelMatrix;
-			mn = glm::mat3(glm::rotate(glm::rotate(glm::rotate(glm::rotate(glm::mat4(1.0f), ry, glm::vec3(1, 0, 0)), rx, glm::vec3(0, 0, 1)),
-					glm::radians(CAR_ORIENTATION_X), glm::vec3(1, 0, 0)), glm::radians(CAR_ORIENTATION_Y), glm::vec3(0, 1, 0)));
-
-			glUseProgram(carModelProgram.getHandle());
-			glEnable(GL_DEPTH_TEST);
-
-			// Set matrices
-			glUniformMatrix4fv(mvpUniform, 1, GL_FALSE, glm::value_ptr(mvp));
-			glUniformMatrix4fv(mvUniform, 1, GL_FALSE, glm::value_ptr(mv));
-			glUniformMatrix3fv(mnUniform, 1, GL_FALSE, glm::value_ptr(mn));
-
-			modelLoader.Draw(carModelProgram.getHandle());
+			glUseProgram(topProgram.getHandle());
+			glUniform4fv(locGainTop, camera_num, &gain->Gains::gain[0]); // Set gain values for all cameras
+			glBindVertexArray(VAO_TOP);
+			for (uint i = 0; i < views.size(); i++)
+			{
+				if (!views[i].remap) { continue; }
+				glViewport(views[i].rect[0], views[i].rect[1], views[i].rect[2], views[i].rect[3]);
+				glUniformMatrix4fv(locMvpTop, 1, GL_FALSE, glm::value_ptr(views[i].mvp));
+				glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices_top);
+			}
 		}
+		glBindVertexArray(0);
+		glActiveTexture(GL_TEXTURE0);
+		glViewport(0, 0, param.disp_width, param.disp_height); // Exposure correction and text use the whole display
+
+		// Release camera frames
+		pthread_mutex_unlock(&v4l2Camera::th_mutex);
+		hud->Stage(HUD_STAGE_TOP);
+		// Restore depth state
+		glDepthRangef(0.0f, 1.0f);
+		glDepthFunc(GL_LESS);
+		glDepthMask(GL_TRUE);
 		glEnable(GL_BLEND);
 		glDisable(GL_DEPTH_TEST);
 		fpsValue = report_fps();		
@@ -191,7 +275,7 @@ static void Render(void)
 			
 			int i;
 			// Render camera overlap regions
-			for (int camera = 0; camera < CAMERA_NUM; camera++)
+			for (int camera = 0; camera < camera_num; camera++)
 			{
 				// Lock the camera frame
 				pthread_mutex_lock(&v4l2_cameras[camera].th_mutex);
@@ -224,7 +308,7 @@ static void Render(void)
 					GL_RGBA,
 					GL_UNSIGNED_BYTE,
 					gain->Gains::overlap_roi[camera][0].data);
-				uint next = (uint)next_id(camera, camera_num - 1);
+				uint next = (uint)param.nextCamera(camera);
 				glReadPixels(gain->compensator->getFlipROI(next).x,
 					gain->compensator->getFlipROI(next).y,
 					gain->compensator->getFlipROI(next).width,
@@ -244,57 +328,71 @@ static void Render(void)
 			glBindFramebuffer(GL_FRAMEBUFFER, mrtFBO); // Reset framebuffer			
 		}
 		expcor = 0;
+		hud->Stage(HUD_STAGE_EC);
 	}
 
 	glDisable(GL_BLEND);
 	glDisable(GL_DEPTH_TEST);
 	
+	// Dormant until a post-process calls mrt->Enable()
 	if (mrt->isEnabled())
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		glViewport(0, 0, param.disp_width, param.disp_height);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		mrt->RenderSmallQuad(showTexProgram.getHandle());
-
-		// Render car model
-		glm::mat4 carModelMatrix = glm::rotate(glm::rotate(glm::scale(glm::mat4(1.0f), car_scale), glm::radians(CAR_ORIENTATION_X), glm::vec3(1, 0, 0)),
-			glm::radians(CAR_ORIENTATION_Y), glm::vec3(0, 1, 0));
-		mvp = gProjection * mv * carModelMatrix;
-		mn = glm::mat3(glm::rotate(glm::rotate(glm::rotate(glm::rotate(glm::mat4(1.0f), ry, glm::vec3(1, 0, 0)), rx, glm::vec3(0, 0, 1)),
-				glm::radians(CAR_ORIENTATION_X), glm::vec3(1, 0, 0)), glm::radians(CAR_ORIENTATION_Y), glm::vec3(0, 1, 0)));
-
-		glUseProgram(carModelProgram.getHandle());
-		glEnable(GL_DEPTH_TEST);
-
-		// Set matrices
-		glUniformMatrix4fv(mvpUniform, 1, GL_FALSE, glm::value_ptr(mvp));
-		glUniformMatrix4fv(mvUniform, 1, GL_FALSE, glm::value_ptr(mv));
-		glUniformMatrix3fv(mnUniform, 1, GL_FALSE, glm::value_ptr(mn));
-
-		modelLoader.Draw(carModelProgram.getHandle());
+		mrt->RenderSmallQuad(showTexProgram.getHandle()); // Car model is already in the composited frame
+		hud->Stage(HUD_STAGE_COMPOSE);
 	}  
 		
 	stringstream ss;
 	ss << std::fixed << std::setprecision(2) << fpsValue;
 	string fpsText = "FPS: " + ss.str();
-	fontRenderer->RenderText(fpsText.c_str(), 5.0f, 10.0f); 
+	fontRenderer->AddText(fpsText.c_str(), 5.0f, 10.0f); 
+	hud->Render(fontRenderer, 5.0f + 1.5f * fontRenderer->GetLineHeight(), 10.0f);
+	fontRenderer->Flush(); // All strings are drawn with one call
+	hud->Stage(HUD_STAGE_TEXT);
+}
+/***************************************************************************************
+***************************************************************************************/
+// Pass capture and exposure correction statistics to the HUD after the frame has been displayed
+static void hudUpdate(void)
+{
+	if (!hud->isEnabled()) { return; }
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	for (int camera = 0; camera < camera_num; camera++)
+	{
+		unsigned int captured, dropped;
+		struct timespec frame_time;
+		v4l2_cameras[camera].getStats(captured, dropped, frame_time);
+		double latency = (frame_time.tv_sec == 0) ? 0.0 : timespec2doublems(timespec_sub(now, frame_time));
+		hud->SetCamera(camera, captured, dropped, latency);
+	}
+
+	// Gains are skipped while the exposure correction thread updates them
+	if (pthread_mutex_trylock(&gain->Gains::th_mutex) == 0)
+	{
+		double age = (gain->Gains::update_time.tv_sec == 0) ? 0.0 : timespec2doublems(timespec_sub(now, gain->Gains::update_time));
+		hud->SetGains(gain->Gains::gain, GAIN_STRIDE, age, gain->Gains::update_ms);
+		pthread_mutex_unlock(&gain->Gains::th_mutex);
+	}
+
+	hud->FrameEnd();
 }
 /***************************************************************************************
 ***************************************************************************************/
 static void RenderCleanup(void)
 {
 	if(fontRenderer != NULL) { delete(fontRenderer); }
+	if(hud != NULL) { delete(hud); }
 	if(gain!= NULL) { delete(gain); }
 	if(mrt!= NULL) { delete(mrt); }
 	for (uint camera = 0U; camera < v4l2_cameras.size(); camera++)
 	{
 		v4l2_cameras[camera].stopCapturing();	
 	}
-	for (int camera = 0; camera < VAO_NUM; camera++)
-	{
-		//glDeleteTextures(1, &gTexObj[camera]);
-	}
 	//g_main_loop_quit(gst_shared.loop);
 }
 /***************************************************************************************
@@ -331,7 +429,7 @@ int main(int argc, char** argv)
 	}
  
 	////////////////// Exposure correction //////////////////////
-	gain = new Gains(param.disp_width, param.disp_height);
+	gain = new Gains(param.disp_width, param.disp_height, camera_ring);
 	gain->updateGains();
 
 	/////////////////////// Rendering ///////////////////////////
@@ -367,12 +465,18 @@ int main(int argc, char** argv)
 					case k_down:
 						py -= 0.5f;
 						break;
+					case k_h:
+						hud->Toggle();
+						break;
+					case k_t:
+						top_remap = !top_remap;
+						cout << "Top views are rendered with the " << (top_remap ? "bird's-eye grid" : "3D bowl") << endl;
+						break;
 					case k_f1:
-						rx = 0.0f;
-						ry = 0.0f;
-						px = 0.0f;
-						py = 0.0f;
-						pz = -10.0f;
+						viewPreset(0);
+						break;
+					case k_v:
+						viewPreset((preset_index + 1) % presets.size());
 						break;
 					// Mouse moving
 					case m_move:
@@ -394,8 +498,11 @@ int main(int argc, char** argv)
 						break;
 				}
 			}
+			hud->Start();
 			Render();
 			out_disp->swapBuffers();
+			hud->Stage(HUD_STAGE_SWAP);
+			hudUpdate();
 
 			static struct timespec t_new = { 0, 0 };
 			clock_gettime(CLOCK_REALTIME, &t_new);
@@ -434,18 +541,71 @@ int setParam(XMLParameters* xml_param)
 	}
 	
 	camera_num = xml_param->camera_num;
-	if(camera_num > CAMERA_NUM) { camera_num = CAMERA_NUM; }
 	
 	for (int i = 0; i < camera_num; i++)
 	{
 		g_in_width.push_back(xml_param->cameras[i].width);
 		g_in_height.push_back(xml_param->cameras[i].height);
 	}
+
+	camera_ring.assign(1, 0);
+	while ((int)camera_ring.size() < camera_num) { camera_ring.push_back(xml_param->nextCamera(camera_ring.back())); }
 	
-	gProjection = glm::perspective(45.0f, (float)xml_param->disp_width / (float)xml_param->disp_height, 0.1f, 100.0f);
+	// Viewports: one full screen orbit view by default
+	vector<ViewParam> view_param = xml_param->viewports;
+	if (view_param.empty()) { view_param.push_back({VIEW_ORBIT, 0.0f, 0.0f, 1.0f, 1.0f}); }
+	for (uint i = 0; i < view_param.size(); i++)
+	{
+		View view;
+		view.type = view_param[i].type;
+		view.rect[0] = (GLint)(view_param[i].x * xml_param->disp_width + 0.5f);
+		view.rect[1] = (GLint)(view_param[i].y * xml_param->disp_height + 0.5f);
+		view.rect[2] = max((GLint)(view_param[i].width * xml_param->disp_width + 0.5f), 1);
+		view.rect[3] = max((GLint)(view_param[i].height * xml_param->disp_height + 0.5f), 1);
+		view.projection = glm::perspective(45.0f, (float)view.rect[2] / (float)view.rect[3], 0.1f, 100.0f);
+		views.push_back(view);
+	}
 	car_scale = glm::vec3(xml_param->model_scale[0], xml_param->model_scale[0], xml_param->model_scale[0]);
+	carRotation = glm::rotate(glm::rotate(glm::mat4(1.0f), glm::radians(CAR_ORIENTATION_X), glm::vec3(1, 0, 0)),
+		glm::radians(CAR_ORIENTATION_Y), glm::vec3(0, 1, 0));
+	carModelMatrix = glm::scale(glm::mat4(1.0f), car_scale) * carRotation;
+
+	// View presets: the top view by default. The first preset is the initial view
+	vector<PresetParam> preset_param = xml_param->presets;
+	if (preset_param.empty()) { preset_param.push_back({"top", 0.0f, 0.0f, 0.0f, 0.0f, -10.0f}); }
+	for (uint i = 0; i < preset_param.size(); i++)
+	{
+		ViewPreset preset;
+		preset.name = preset_param[i].name;
+		preset.rx = glm::radians(preset_param[i].rx);
+		preset.ry = glm::clamp(glm::radians(preset_param[i].ry), CAM_LIMIT_RY_MIN, CAM_LIMIT_RY_MAX);
+		preset.position = glm::vec3(preset_param[i].px, preset_param[i].py,
+			glm::clamp(preset_param[i].pz, CAM_LIMIT_ZOOM_MIN, CAM_LIMIT_ZOOM_MAX));
+		presets.push_back(preset);
+	}
+	transition_ms = xml_param->transition_ms;
+	rx = presets[0].rx;
+	ry = presets[0].ry;
+	px = presets[0].position.x;
+	py = presets[0].position.y;
+	pz = presets[0].position.z;
 	fontRenderer = new FontRenderer(xml_param->disp_width, xml_param->disp_height, "../Content/font.png");
 	mrt = new MRT(xml_param->disp_width, xml_param->disp_height);
+	hud = new PerfHud(camera_num);
+
+	// Baked blend weights are used only if the weighted overlap grids of all cameras are found
+	blend_weights = xml_param->blend_weights;
+	lod_num = 1 + xml_param->lod_levels;
+	for (int i = 0; (i < camera_num) && blend_weights; i++)
+	{
+		struct stat st;
+		string array = "./array" + to_string(i + 1) + "3";
+		if (stat(array.c_str(), &st) != 0)
+		{
+			cout << "Weighted grid " << array << " was not found. Blending masks will be used" << endl;
+			blend_weights = false;
+		}
+	}
 	
 	return(0);
 }
@@ -456,12 +616,18 @@ int setParam(XMLParameters* xml_param)
 int programsInit(void)
 {
 	// Overlap regions
-	if (renderProgram.loadShaders(s_v_shader_glm, s_f_shader_b_ec) == -1) // Overlap regions
+	int res = blend_weights ? renderProgram.loadShaders(s_v_shader_glm_w, s_f_shader_w_ec)
+							: renderProgram.loadShaders(s_v_shader_glm, s_f_shader_b_ec);
+	if (res == -1) // Overlap regions
 	{
 		cout << "Render program was not loaded" << endl;
 		return (-1);
 	}
 	
+	samplersInit(&renderProgram, !blend_weights);
+	locFirst[0] = glGetUniformLocation(renderProgram.getHandle(), "myFirst");
+	locMvp[0] = glGetUniformLocation(renderProgram.getHandle(), "mvp");
+	
 	// Exposure correction
 	if (exposureCorrectionProgram.loadShaders(s_v_shader, s_f_shader) == -1) // Ecposure correction
 	{
@@ -476,6 +642,19 @@ int programsInit(void)
 		cout << "Render program was not loaded" << endl;
 		return (-1);
 	}
+	samplersInit(&renderProgramWB, false);
+	locFirst[1] = glGetUniformLocation(renderProgramWB.getHandle(), "myFirst");
+	locMvp[1] = glGetUniformLocation(renderProgramWB.getHandle(), "mvp");
+	
+	// Bird's-eye grid
+	if (topProgram.loadShaders(s_v_shader_top, s_f_shader_top) == -1)
+	{
+		cout << "Bird's-eye program was not loaded" << endl;
+		return (-1);
+	}
+	samplersInit(&topProgram, false);
+	locMvpTop = glGetUniformLocation(topProgram.getHandle(), "mvp");
+	locGainTop = glGetUniformLocation(topProgram.getHandle(), "myGain");
 	
 	// Car Model
 	if (carModelProgram.loadShaders(s_v_shader_model, s_f_shader_model) == -1) // Car image
@@ -511,6 +690,7 @@ void programsDestroj(void)
 	renderProgram.destroyShaders();
 	exposureCorrectionProgram.destroyShaders();
 	renderProgramWB.destroyShaders();
+	topProgram.destroyShaders();
 	carModelProgram.destroyShaders();
 	showTexProgram.destroyShaders();
 	fontProgram.destroyShaders();
@@ -565,25 +745,49 @@ void texture2dInit(GLuint* texture)
 
 /***************************************************************************************
 ***************************************************************************************/
-void bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, GLfloat* vert, int num)
+// Bind camera frames samplers to the texture units 0..CAMERA_MAX - 1 and masks samplers to the next CAMERA_MAX units
+void samplersInit(Programs* program, bool masks)
+{
+	glUseProgram(program->getHandle());
+	for (int j = 0; j < CAMERA_MAX; j++)
+	{
+		string frame = "myTexture" + to_string(j);
+		glUniform1i(glGetUniformLocation(program->getHandle(), frame.c_str()), j);
+		if (masks)
+		{
+			string mask = "myMask" + to_string(j);
+			glUniform1i(glGetUniformLocation(program->getHandle(), mask.c_str()), CAMERA_MAX + j);
+		}
+	}
+	glUseProgram(0);
+}
+
+/***************************************************************************************
+***************************************************************************************/
+void bufferObjectInit(GLuint* text_vao, GLuint* text_vbo, GLfloat* vert, int num, int stride)
 {
 	// rectangle
 	glBindBuffer(GL_ARRAY_BUFFER, *text_vbo);
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * 5 * num, &vert[0], GL_DYNAMIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * stride * num, &vert[0], GL_DYNAMIC_DRAW);
 	glBindVertexArray(*text_vao);
 	// Position attribute
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(GLfloat) * 5, (GLvoid*)0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(GLfloat) * stride, (GLvoid*)0);
 	// TexCoord attribute
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(GLfloat) * 5, (GLvoid*)(3U * sizeof(GLfloat)));
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(GLfloat) * stride, (GLvoid*)(3U * sizeof(GLfloat)));
 	glEnableVertexAttribArray(1);
+	if (stride > 5) // Blend weight attribute
+	{
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, (GLsizei)sizeof(GLfloat) * stride, (GLvoid*)(5U * sizeof(GLfloat)));
+		glEnableVertexAttribArray(2);
+	}
 	glBindVertexArray(0);
 }
 
 /***************************************************************************************
 ***************************************************************************************/
 // Load vertices arrays
-void vLoad(GLfloat** vert, int* num, string filename)
+void vLoad(GLfloat** vert, int* num, string filename, int stride)
 {
 	ifstream input(filename.c_str());
 	*num = (int)count(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>(), '\n'); // Get line number from the array file
@@ -591,12 +795,12 @@ void vLoad(GLfloat** vert, int* num, string filename)
 	input.seekg(0, ios::beg); // Returning to the beginning of fstream
 
 	*vert = NULL; 
-	*vert = (GLfloat*)malloc((size_t)sizeof(GLfloat) * (uint)(*num) * 5U);	
+	*vert = (GLfloat*)malloc((size_t)sizeof(GLfloat) * (uint)(*num) * (uint)stride);	
 	if (*vert == NULL) 	{
 		cout << "Memory allocation did not complete successfully" << endl; 
 	} 
 	else {
-		for (int k = 0; k < (*num) * 5; k++) {
+		for (int k = 0; k < (*num) * stride; k++) {
 			input >> (*vert)[k];
 		}
 	}
@@ -630,7 +834,7 @@ int camerasInit(void)
 	gst_shared.gl_context = gst_gl_context_new_wrapped(GST_GL_DISPLAY(gst_shared.gst_display), (guintptr)out_disp->getEGLContext(), GST_GL_PLATFORM_EGL, GST_GL_API_GLES2);
 
 
-	for (int i = 0; i < CAMERA_NUM; i++)
+	for (int i = 0; i < camera_num; i++)
 	{
 		v4l2_cameras.push_back(v4l2Camera(g_in_width[i], g_in_height[i], CAM_PIXEL_TYPE, V4L2_MEMORY_MMAP, param.cameras[i].device.c_str()));
 		//v4l2Camera v4l2_camera(g_in_width[i], g_in_height[i], CAM_PIXEL_TYPE, V4L2_MEMORY_MMAP, param.cameras[i].device.c_str());
@@ -642,7 +846,7 @@ int camerasInit(void)
 		}
 	}
 
-	for (int i = 0; i < CAMERA_NUM; i++) { // Start capturing
+	for (int i = 0; i < camera_num; i++) { // Start capturing
 		if (v4l2_cameras[i].startCapturing() == -1) { return(-1); }
 	}
 
@@ -662,39 +866,243 @@ int camerasInit(void)
 void camTexInit(void)
 {
 	///////////////////////////////// Load vertices arrays ///////////////////////////////
-	GLfloat* vVertices[VAO_NUM];
-	for (int j = 0; j < VAO_NUM; j++)
+	// Grids of all cameras are batched into one vertex buffer per pass: 0 - overlap, 1 - non-overlap regions
+	GLuint VBO_CAM[2];
+	glGenVertexArrays(2, VAO);
+	glGenBuffers(2, VBO_CAM);
+
+	vector<glm::vec3> bmin(camera_num, glm::vec3(FLT_MAX)), bmax(camera_num, glm::vec3(-FLT_MAX)); // Full level bounds
+	for (int pass = 0; pass < 2; pass++)
 	{
-		int vrt;
-		string array = "./array" + to_string((int)(j / 2) + 1) + to_string(j % 2 + 1);
-		vLoad(&vVertices[j], &vrt, array);
-		vertices.push_back(vrt);
-	}	
-	
-	//////////////////////// Camera textures initialization /////////////////////////////
+		// Overlap grids with baked blend weights have 6 floats per vertex (./arrayX3)
+		int type = ((pass == 0) && blend_weights) ? 3 : (pass + 1);
+		int stride = (type == 3) ? 6 : 5;
+		vector<GLfloat> batch;
+		int num = 0;
+		for (int j = 0; j < CAMERA_MAX; j++)
+		{
+			firstVertex[pass][j] = (j < camera_num) ? num : INT_MAX;
+			if (j >= camera_num) { continue; }
 
-	GLuint VBO_CAM[VAO_NUM];
-	glGenVertexArrays(VAO_NUM, VAO);
-	glGenBuffers(VAO_NUM, VBO_CAM);
+			for (int level = 0; level < lod_num; level++)
+			{
+				string array = "./array" + to_string(j + 1) + to_string(type);
+				if (level > 0) { array = "./lod" + to_string(level) + "/array" + to_string(j + 1) + to_string(type); }
+
+				struct stat st;
+				if ((level > 0) && (stat(array.c_str(), &st) != 0)) // Missing level is replaced with the previous one
+				{
+					bowlChunks[pass][j][level] = bowlChunks[pass][j][level - 1];
+					continue;
+				}
 
-	for (int j = 0; j < VAO_NUM; j++)
-	{	
-		bufferObjectInit(&VAO[j], &VBO_CAM[j], vVertices[j], vertices[j]);
-		//texture2dInit(&gTexObj[j]);
+				GLfloat* vVertices;
+				int vrt;
+				vLoad(&vVertices, &vrt, array, stride);
+				if (vVertices != NULL)
+				{
+					glm::vec3 lmin(FLT_MAX), lmax(-FLT_MAX);
+					chunksInit(vVertices, vrt, stride, num, bowlChunks[pass][j][level], lmin, lmax);
+					if (level == 0)
+					{
+						bmin[j] = glm::min(bmin[j], lmin);
+						bmax[j] = glm::max(bmax[j], lmax);
+					}
+					batch.insert(batch.end(), vVertices, vVertices + vrt * stride);
+					num += vrt;
+					free(vVertices);
+				}
+			}
+		}
+		
+		if (batch.empty()) { batch.push_back(0.0f); }
+		bufferObjectInit(&VAO[pass], &VBO_CAM[pass], &batch[0], num, stride);
+		hud->AddMemory(HUD_MEM_MESH, (size_t)num * stride * sizeof(GLfloat));
 	}
+	for (int j = 0; j < camera_num; j++)
+	{
+		if (bmin[j].x > bmax[j].x) { bmin[j] = bmax[j] = glm::vec3(0.0f); } // Camera has no grid
+		bowlSphere[j] = glm::vec4((bmin[j] + bmax[j]) * 0.5f, glm::length(bmax[j] - bmin[j]) * 0.5f);
+	}
+
+	glUseProgram(renderProgram.getHandle());
+	glUniform1iv(locFirst[0], CAMERA_MAX, firstVertex[0]);
+	glUseProgram(renderProgramWB.getHandle());
+	glUniform1iv(locFirst[1], CAMERA_MAX, firstVertex[1]);
+	glUseProgram(0);
+
+	if (blend_weights) { return; } // Mask textures are not needed
 
+	locMaskRect = glGetUniformLocation(renderProgram.getHandle(), "myMaskRect");
+	txtMask.assign(camera_num, 0);
+	maskRect.assign(4 * camera_num, 0.0f);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Rows of cropped masks are not aligned
 	for (int j = 0; j < camera_num; j++)
 	{			
 		// j camera mask init
 		texture2dInit(&txtMask[j]);
-		string mask_name = "./mask" + to_string(j) + ".jpg";
-		Mat camera_mask = imread(mask_name, CV_LOAD_IMAGE_GRAYSCALE);
-		masks.push_back(camera_mask);
-		
+		string mask_name = "./mask" + to_string(j) + ".msk";
+		MaskLevels mask;
+		if (loadMaskFile(mask_name.c_str(), mask) != 0) // Black mask
+		{
+			mask.frame = Size(1, 1);
+			mask.roi = Rect(0, 0, 1, 1);
+			mask.levels.assign(1, Mat(1, 1, CV_8UC1, Scalar(0)));
+		}
+
+		// Mask texel = (frame texel - offset) * inverse size
+		maskRect[4 * j] = (GLfloat)mask.roi.x / (GLfloat)mask.frame.width;
+		maskRect[4 * j + 1] = (GLfloat)mask.roi.y / (GLfloat)mask.frame.height;
+		maskRect[4 * j + 2] = (GLfloat)mask.frame.width / (GLfloat)mask.roi.width;
+		maskRect[4 * j + 3] = (GLfloat)mask.frame.height / (GLfloat)mask.roi.height;
+
 		glBindTexture(GL_TEXTURE_2D, txtMask[j]);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, masks[j].cols, masks[j].rows, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, (uchar*)masks[j].data);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)mask.levels.size() - 1);
+		for (uint level = 0; level < mask.levels.size(); level++) // Levels are continuous after decoding
+		{
+			const Mat &img = mask.levels[level];
+			glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_R8, img.cols, img.rows, 0, GL_RED, GL_UNSIGNED_BYTE, img.data);
+			hud->AddMemory(HUD_MEM_MASK, (size_t)img.cols * img.rows);
+		}
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glUseProgram(renderProgram.getHandle());
+	glUniform4fv(locMaskRect, camera_num, &maskRect[0]);
+	glUseProgram(0);
+}
+
+/***************************************************************************************
+***************************************************************************************/
+// Split camera grid into chunks of triangles which lie in the same angular sector of the bowl.
+// Triangles of the grid files are ordered by sectors, so every chunk is a continuous range of vertices
+void chunksInit(const GLfloat* vert, int num, int stride, GLint first, vector<BowlChunk> &chunks, glm::vec3 &bmin, glm::vec3 &bmax)
+{
+	chunks.clear();
+	int sector = -1;
+	glm::vec3 cmin, cmax;
+	for (int t = 0; t + 2 < num; t += 3)
+	{
+		const GLfloat* v = &vert[t * stride];
+		float x = (v[0] + v[stride] + v[2 * stride]) / 3.0f;
+		float y = (v[1] + v[stride + 1] + v[2 * stride + 1]) / 3.0f;
+		int s = (int)((atan2f(y, x) + (float)M_PI) / (2.0f * (float)M_PI) * LOD_SECTORS) % LOD_SECTORS;
+		if (s != sector) // New chunk
+		{
+			chunks.push_back({first + t, 0, glm::vec4(0.0f)});
+			sector = s;
+			cmin = glm::vec3(FLT_MAX);
+			cmax = glm::vec3(-FLT_MAX);
+		}
+
+		for (int k = 0; k < 3; k++)
+		{
+			glm::vec3 p(v[k * stride], v[k * stride + 1], v[k * stride + 2]);
+			cmin = glm::min(cmin, p);
+			cmax = glm::max(cmax, p);
+		}
+		BowlChunk &chunk = chunks.back();
+		chunk.count += 3;
+		chunk.sphere = glm::vec4((cmin + cmax) * 0.5f, glm::length(cmax - cmin) * 0.5f);
+		bmin = glm::min(bmin, cmin);
+		bmax = glm::max(bmax, cmax);
+	}
+}
+
+/***************************************************************************************
+***************************************************************************************/
+// Check if the bounding sphere intersects the view frustum
+bool isVisible(const View &view, const glm::vec4 &sphere)
+{
+	for (int k = 0; k < 6; k++)
+	{
+		if (glm::dot(glm::vec3(view.planes[k]), glm::vec3(sphere)) + view.planes[k].w < -sphere.w) { return (false); }
+	}
+	return (true);
+}
+
+/***************************************************************************************
+***************************************************************************************/
+// Draw visible chunks of the selected levels of all cameras. Neighbor chunks are merged into one draw call,
+// so grids without levels of detail and culled chunks are still drawn with one call. Returns vertices number
+int bowlDraw(const View &view, int pass)
+{
+	GLint first = 0;
+	GLsizei count = 0;
+	int drawn = 0;
+	for (int camera = 0; camera < camera_num; camera++)
+	{
+		const vector<BowlChunk> &chunks = bowlChunks[pass][camera][view.lod[camera]];
+		for (uint k = 0; k < chunks.size(); k++)
+		{
+			if (!isVisible(view, chunks[k].sphere)) { continue; }
+			if ((count > 0) && (first + count == chunks[k].first)) // Continue the current range
+			{
+				count += chunks[k].count;
+				continue;
+			}
+			if (count > 0) { glDrawArrays(GL_TRIANGLES, first, count); }
+			drawn += count;
+			first = chunks[k].first;
+			count = chunks[k].count;
+		}
+	}
+	if (count > 0) { glDrawArrays(GL_TRIANGLES, first, count); }
+	return (drawn + count);
+}
+
+/***************************************************************************************
+***************************************************************************************/
+// Load the bird's-eye grid and fit the bowl bottom into the orthographic projection of top views
+void topTexInit(void)
+{
+	struct stat st;
+	if (stat("./top_grid", &st) != 0)
+	{
+		cout << "Bird's-eye grid ./top_grid was not found. Top views will render the 3D bowl" << endl;
+		return;
+	}
+
+	GLfloat* vVertices;
+	vLoad(&vVertices, &vertices_top, "./top_grid", TOP_VERTEX_SIZE);
+	if (vVertices == NULL) 
+	{
+		vertices_top = 0;
+		return;
+	}
+
+	float extent = 0.0f; // Half size of the grid
+	for (int k = 0; k < vertices_top; k++) {
+		extent = max(extent, max(fabsf(vVertices[k * TOP_VERTEX_SIZE + TOP_POSITION_OFFSET]), fabsf(vVertices[k * TOP_VERTEX_SIZE + TOP_POSITION_OFFSET + 1])));
+	}
+	for (uint i = 0; i < views.size(); i++)
+	{
+		float aspect = (float)views[i].rect[2] / (float)views[i].rect[3];
+		views[i].ortho = glm::ortho(-extent * aspect, extent * aspect, -extent, extent, 0.1f, 100.0f);
+	}
+
+	GLuint VBO_TOP;
+	glGenVertexArrays(1, &VAO_TOP);
+	glGenBuffers(1, &VBO_TOP);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO_TOP);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)sizeof(GLfloat) * TOP_VERTEX_SIZE * vertices_top, vVertices, GL_STATIC_DRAW);
+	glBindVertexArray(VAO_TOP);
+	GLsizei stride = (GLsizei)sizeof(GLfloat) * TOP_VERTEX_SIZE;
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(TOP_POSITION_OFFSET * sizeof(GLfloat))); // Position
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(TOP_TEXELS_OFFSET * sizeof(GLfloat))); // Texels of both cameras
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(TOP_WEIGHT_OFFSET * sizeof(GLfloat))); // Weight of the first camera
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(TOP_CAMERAS_OFFSET * sizeof(GLfloat))); // Camera indexes
+	glEnableVertexAttribArray(3);
+	glBindVertexArray(0);
+	hud->AddMemory(HUD_MEM_MESH, (size_t)vertices_top * TOP_VERTEX_SIZE * sizeof(GLfloat));
+	free(vVertices);
 }
 
 /***************************************************************************************
@@ -710,9 +1118,10 @@ void ecTexInit(void)
 	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, viewport[2], viewport[3]);
 	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo);
+	hud->AddMemory(HUD_MEM_TEXTURE, (size_t)viewport[2] * viewport[3] * 4);
 
 	///////////////////////////////// Load vertices arrays ///////////////////////////////
-	GLfloat* vVertices_ec[camera_num];
+	vector<GLfloat*> vVertices_ec(camera_num);
 	for (int j = 0; j < camera_num; j++)
 	{
 		int vrt;
@@ -722,11 +1131,13 @@ void ecTexInit(void)
 	}	
 	
 	//////////////////////// Camera textures initialization /////////////////////////////
-	GLuint VBO_EC[camera_num];
-	glGenVertexArrays(camera_num, VAO_EC);
-	glGenBuffers(camera_num, VBO_EC);
+	vector<GLuint> VBO_EC(camera_num);
+	VAO_EC.resize(camera_num);
+	glGenVertexArrays(camera_num, &VAO_EC[0]);
+	glGenBuffers(camera_num, &VBO_EC[0]);
 	for (int j = 0; j < camera_num; j++) {	
 		bufferObjectInit(&VAO_EC[j], &VBO_EC[j], vVertices_ec[j], vertices_ec[j]);
+		hud->AddMemory(HUD_MEM_MESH, (size_t)vertices_ec[j] * 5 * sizeof(GLfloat));
 	}
 	
 	locGain[0] = glGetUniformLocation(renderProgram.getHandle(), "myGain");
@@ -25,11 +25,14 @@
 #include "gain.hpp"
 
 
-float Gains::gain[CAMERAS_NUM][CHANELS_NUM] = { 0.0f };
+vector<float> Gains::gain;
 pthread_mutex_t Gains::th_mutex = PTHREAD_MUTEX_INITIALIZER;
+struct timespec Gains::update_time = {0, 0};
+double Gains::update_ms = 0.0;
 sem_t Gains::th_semaphore;
 int Gains::exit_flag = 0;
-Mat Gains::overlap_roi[CAMERAS_NUM][2];
+vector< vector<Mat> > Gains::overlap_roi;
+vector<int> Gains::ring;
 
 
 /**************************************************************************************************************
@@ -37,32 +40,33 @@ Mat Gains::overlap_roi[CAMERAS_NUM][2];
  * @brief  			Gains class constructor.
  *
  * @param	in		int width - display width;
- *					int height - display height.
+ *					int height - display height;
+ *					const vector<int> &camera_ring - camera indexes in the ring order.
  *
  * @return 			The function creates the Gains object.
  *
- * @remarks 		The function creates Gains object and sets object attributes.
+ * @remarks 		The function creates Gains object and sets object attributes. The overlap region between
+ *					two cameras is the right region of the first camera and the left region of the next one.
  *
  **************************************************************************************************************/
-Gains::Gains(int width, int height)
+Gains::Gains(int width, int height, const vector<int> &camera_ring)
 {
 	sem_init(&Gains::th_semaphore, 0, 0);
 	Gains::exit_flag = 0;
-	for (int i = 0; i < CAMERAS_NUM; i++) {
-		for (int j = 0; j < CHANELS_NUM; j++) {
-			Gains::gain[i][j] = 1.0f; 
-		}
-	}
+	Gains::ring = camera_ring;
+	Gains::gain.assign(GAIN_STRIDE * ring.size(), 1.0f);
 	
 
 	// Load compensator
 	compensator = new Compensator(Size(width, height));
 	compensator->load((const char*)"./compensator");
 	
-	for (int j = 0; j < CAMERAS_NUM; j++)
+	Gains::overlap_roi.assign(ring.size(), vector<Mat>(2));
+	for (uint k = 0; k < ring.size(); k++)
 	{	
-		Gains::overlap_roi[j][0] = Mat(compensator->getFlipROI((uint)j).height, compensator->getFlipROI((uint)j).width, CV_8UC(4));
-		uint next = (uint)next_id(j, CAMERAS_NUM - 1);
+		uint j = (uint)ring[k];
+		uint next = (uint)ring[next_id((int)k, (int)ring.size() - 1)];
+		Gains::overlap_roi[j][0] = Mat(compensator->getFlipROI(j).height, compensator->getFlipROI(j).width, CV_8UC(4));
 		Gains::overlap_roi[j][1] = Mat(compensator->getFlipROI(next).height, compensator->getFlipROI(next).width, CV_8UC(4));
 	}
 }
@@ -149,9 +153,10 @@ void* Gains::updateGainsThread(void * input_args)
 		
 		clock_gettime(CLOCK_REALTIME, &t1);
 			
-		Scalar Acc_left[CAMERAS_NUM], Acc_right[CAMERAS_NUM];
+		uint cameras_num = (uint)ring.size();
+		vector<Scalar> Acc_left(cameras_num), Acc_right(cameras_num);
 		
-		for (uint camera = 0U; camera < (uint)CAMERAS_NUM; ++camera) 
+		for (uint camera = 0U; camera < cameras_num; ++camera) 
 		{
 			Scalar Ci_left(0, 0, 0), Ci_right(0, 0, 0);
 
@@ -182,16 +187,16 @@ void* Gains::updateGainsThread(void * input_args)
 		}
 
 
-		Scalar a[CAMERAS_NUM]; // Color correction coefficient
-		a[0] = Scalar(1, 1, 1); // For the first image the color correction coefficient is 1 for all channels
-		for (uint i = 1U; i < (uint)CAMERAS_NUM; ++i) 
+		vector<Scalar> a(cameras_num); // Color correction coefficient
+		a[ring[0]] = Scalar(1, 1, 1); // For the first image the color correction coefficient is 1 for all channels
+		for (uint k = 1U; k < cameras_num; ++k) // Go around the ring
 		{
-			divide(Acc_right[i - 1U], Acc_left[i], a[i]);
+			divide(Acc_right[ring[k - 1U]], Acc_left[ring[k]], a[ring[k]]);
 		}
 	
 
 		double ar = 0.0, ag = 0.0, ab = 0.0, ar_2 = 0.0, ag_2 = 0.0, ab_2 = 0.0;
-		for (uint i = 0U; i < (uint)CAMERAS_NUM; ++i) 
+		for (uint i = 0U; i < cameras_num; ++i) 
 		{
 			ar += a[i].val[0]; // Color correction coefficients for channel R
 			ag += a[i].val[1]; // Color correction coefficients for channel G
@@ -203,17 +208,17 @@ void* Gains::updateGainsThread(void * input_args)
 
 
 		Scalar g(ar / ar_2, ag / ag_2, ab / ab_2); // Global compensation coefficient
-		for (uint i = 0U; i < (uint)CAMERAS_NUM; ++i)
+		for (uint i = 0U; i < cameras_num; ++i)
 		{			
 			multiply(g, a[i], a[i]);
 			pow(a[i], gamma_inv, a[i]);
 		}
 				
-		for (uint camera = 0U; camera < (uint)CAMERAS_NUM; ++camera)
+		for (uint camera = 0U; camera < cameras_num; ++camera)
 		{
-			for (int color = 0; color < 3; color++)
+			for (int color = 0; color < CHANELS_NUM; color++)
 			{
-				gain[camera][color] = (float)a[camera][2 - color];
+				gain[GAIN_STRIDE * camera + color] = (float)a[camera][2 - color];
 			}
 		}
 			
@@ -221,6 +226,8 @@ void* Gains::updateGainsThread(void * input_args)
 		struct timespec diff = timespec_sub(t2, t1);
 		double t = timespec2double(diff);
 		cout << "Time rate: " << t * 1000.0 << " ms" << endl;	
+		update_ms = t * 1000.0;
+		clock_gettime(CLOCK_MONOTONIC, &update_time);
 			
 		if(pthread_mutex_unlock(&th_mutex) !=0) {
 			cout << "pthread_mutex_unlock error" << endl;	